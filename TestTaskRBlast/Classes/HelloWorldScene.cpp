@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include "MyButton.h"
+#include "MyButtonStyle.h"
 #include "HelloWorldScene.h"
 #include "SimpleAudioEngine.h"
 
@@ -100,12 +101,14 @@ bool HelloWorld::init()
 	
 	/////////////////////////////
     // 3. add your codes below...
+	// one style is shared by all the buttons
+	auto style = MyButtonStyle::create(
+		"MyButtonIdle.png",
+		"MyButtonPushed.png",
+		"MyButtonDragout.png");
 	for (int i = 0; i < 4; ++i)
 	{
-		auto button = MyButton::create(
-			"MyButtonIdle.png",
-			"MyButtonPushed.png",
-			"MyButtonDragout.png");
+		auto button = MyButton::create(style);
 		auto label = cocos2d::Label::create();
 		label->setString("My Button " + std::to_string(i + 1));
 		label->setAnchorPoint(cocos2d::Vec2(0.5f, 0.5f));
@@ -119,8 +122,16 @@ bool HelloWorld::init()
 			button->addButtonChild(label, MyButton::ButtonState::PUSHED);
 			break;
 		case 2:
+		{
 			button->addButtonChild(label, MyButton::ButtonState::DRAGOUT);
+			// a child shown in several states
+			auto hint = cocos2d::Label::create();
+			hint->setString("held");
+			hint->setAnchorPoint(cocos2d::Vec2(0.5f, 1.0f));
+			hint->setPosition(cocos2d::Vec2(button->getContentSize().width / 2.0f, 0.0f));
+			button->addButtonChild(hint, { MyButton::ButtonState::PUSHED, MyButton::ButtonState::DRAGOUT });
 			break;
+		}
 		default:
 			button->addButtonChild(label);
 			break;
@@ -171,7 +182,7 @@ void HelloWorld::onMyButtonTouchEndedCallback(cocos2d::EventCustom* event)
 			break;
 		}
 		if (data->is_long)
-			text + " long";
+			text += " long";
 		auto label = dynamic_cast<cocos2d::Label*>(button->getChildren().front());
 		label->setString(text);
 	}
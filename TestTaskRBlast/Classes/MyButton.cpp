@@ -2,8 +2,15 @@
 Copyright (c) 2020 Anton Kulikov
 ****************************************************************************/
 
+#include <cstring>
 #include "2d/CCCamera.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/ccUTF8.h"
+#include "renderer/CCTextureCache.h"
 #include "MyButton.h"
+#include "MyButtonGroup.h"
+#include "MyButtonStyle.h"
 
 
 static const int NORMAL_RENDERER_Z = (-2);
@@ -17,41 +24,44 @@ IMPLEMENT_CLASS_GUI_INFO(MyButton)
 
 MyButton::MyButton():
 _buttonState(ButtonState::IDLE),
+_touchCount(0),
+_multiTouchPolicy(MultiTouchPolicy::ANY_HELD),
 _buttonIdleRenderer(nullptr),
 _buttonPushedRenderer(nullptr),
 _buttonDragoutRenderer(nullptr),
 _zoomScale(0.1f),
 _prevIgnoreSize(true),
 _scale9Enabled(false),
-_capInsetsIdle(cocos2d::Rect::ZERO),
-_capInsetsPushed(cocos2d::Rect::ZERO),
-_capInsetsDragout(cocos2d::Rect::ZERO),
-_idleTextureSize(_contentSize),
-_pushedTextureSize(_contentSize),
-_dragoutTextureSize(_contentSize),
+_style(MyButtonStyle::getEmpty()),
 _idleTextureLoaded(false),
 _pushedTextureLoaded(false),
 _dragoutTextureLoaded(false),
 _idleTextureAdaptDirty(true),
 _pushedTextureAdaptDirty(true),
 _dragoutTextureAdaptDirty(true),
-_idleFileName(""),
-_pushedFileName(""),
-_dragoutFileName(""),
-_idleTexType(TextureResType::LOCAL),
-_pushedTexType(TextureResType::LOCAL),
-_dragoutTexType(TextureResType::LOCAL),
 _expandZone(cocos2d::Size::ZERO),
 _safeZone(cocos2d::Size::ZERO),
+_touchEndedDispatch(false),
 _pushedTimeout(0.0f),
-_pushedTime(0.0f)
-{
+_group(nullptr),
+_groupSlot(-1),
+_touchCacheCamera(nullptr),
+_touchCacheProjected(false),
+_touchCacheValid(false),
+_singleRenderer(false),
+_displayedSpriteFrame(nullptr),
+_asyncPending(0)
+{
+    _style->retain();
+    _touchEndedEvent.data.button = this;
     setTouchEnabled(true);
-	this->scheduleUpdate();
 }
 
 MyButton::~MyButton()
 {
+	// the texture cache must not call back into a destroyed button
+	_cancelTexturesAsync();
+	_style->release();
 }
 
 MyButton* MyButton::create()
@@ -66,6 +76,18 @@ MyButton* MyButton::create()
     return nullptr;
 }
 
+MyButton* MyButton::create(MyButtonStyle* style)
+{
+    MyButton *btn = new (std::nothrow) MyButton;
+    if (btn && btn->init(style))
+    {
+        btn->autorelease();
+        return btn;
+    }
+    CC_SAFE_DELETE(btn);
+    return nullptr;
+}
+
 MyButton* MyButton::create(const std::string &idleImage,
                        const std::string& selectedImage ,
                        const std::string& disableImage,
@@ -81,6 +103,22 @@ MyButton* MyButton::create(const std::string &idleImage,
     return nullptr;
 }
 
+MyButton* MyButton::createAsync(const std::string& idleImage,
+                               const std::string& pushedImage,
+                               const std::string& dragoutImage,
+                               MyButtonStyle* placeholder)
+{
+    MyButton *btn = new (std::nothrow) MyButton;
+    if (btn && btn->init(placeholder))
+    {
+        btn->loadTexturesAsync(idleImage, pushedImage, dragoutImage);
+        btn->autorelease();
+        return btn;
+    }
+    CC_SAFE_DELETE(btn);
+    return nullptr;
+}
+
 bool MyButton::init(const std::string &idleImage,
                   const std::string& selectedImage ,
                   const std::string& disableImage,
@@ -93,7 +131,17 @@ bool MyButton::init(const std::string &idleImage,
     }
 
     loadTextures(idleImage, selectedImage, disableImage, texType);
-	_refreshButtonState(nullptr);
+
+    return true;
+}
+
+bool MyButton::init(MyButtonStyle* style)
+{
+    if (!Widget::init()) {
+        return false;
+    }
+
+    setStyle(style);
 
     return true;
 }
@@ -110,48 +158,205 @@ bool MyButton::init()
 void MyButton::initRenderer()
 {
     _buttonIdleRenderer = cocos2d::ui::Scale9Sprite::create();
-    _buttonPushedRenderer = cocos2d::ui::Scale9Sprite::create();
-    _buttonDragoutRenderer = cocos2d::ui::Scale9Sprite::create();
-    _buttonPushedRenderer->setRenderingType(cocos2d::ui::Scale9Sprite::RenderingType::SIMPLE);
     _buttonIdleRenderer->setRenderingType(cocos2d::ui::Scale9Sprite::RenderingType::SIMPLE);
-    _buttonDragoutRenderer->setRenderingType(cocos2d::ui::Scale9Sprite::RenderingType::SIMPLE);
-
     addProtectedChild(_buttonIdleRenderer, NORMAL_RENDERER_Z, -1);
-    addProtectedChild(_buttonPushedRenderer, PRESSED_RENDERER_Z, -1);
-    addProtectedChild(_buttonDragoutRenderer, DISABLED_RENDERER_Z, -1);
+    _createStateRenderers();
+    _updateRenderers();
+}
+
+void MyButton::_createStateRenderers()
+{
+	auto renderingType = _scale9Enabled ?
+		cocos2d::ui::Scale9Sprite::RenderingType::SLICE :
+		cocos2d::ui::Scale9Sprite::RenderingType::SIMPLE;
+	_buttonPushedRenderer = cocos2d::ui::Scale9Sprite::create();
+	_buttonDragoutRenderer = cocos2d::ui::Scale9Sprite::create();
+	_buttonPushedRenderer->setRenderingType(renderingType);
+	_buttonDragoutRenderer->setRenderingType(renderingType);
+	addProtectedChild(_buttonPushedRenderer, PRESSED_RENDERER_Z, -1);
+	addProtectedChild(_buttonDragoutRenderer, DISABLED_RENDERER_Z, -1);
+}
+
+void MyButton::setSingleRendererEnabled(bool enabled)
+{
+	if (_singleRenderer == enabled)
+		return;
+	_singleRenderer = enabled;
+
+	if (_singleRenderer)
+	{
+		removeProtectedChild(_buttonPushedRenderer);
+		removeProtectedChild(_buttonDragoutRenderer);
+		_buttonPushedRenderer = nullptr;
+		_buttonDragoutRenderer = nullptr;
+	}
+	else
+	{
+		_createStateRenderers();
+	}
+
+	// the frames are kept by the style, only the renderers change
+	_applyIdleStyle();
+	_applyPushedStyle();
+	_applyDragoutStyle();
+	_updateRenderers();
+}
+
+bool MyButton::isSingleRendererEnabled() const
+{
+	return _singleRenderer;
+}
+
+void MyButton::setStyle(MyButtonStyle* style)
+{
+	_cancelTexturesAsync();
+	if (!style)
+		style = MyButtonStyle::getEmpty();
+	if (style == _style)
+		return;
+	style->retain();
+	_style->release();
+	_style = style;
+
+	_applyIdleStyle();
+	_applyPushedStyle();
+	_applyDragoutStyle();
+	_updateRenderers();
+}
+
+MyButtonStyle* MyButton::getStyle() const
+{
+	return _style;
+}
+
+void MyButton::loadTexturesAsync(const std::string& idle,
+								  const std::string& pushed,
+								  const std::string& dragout)
+{
+	_cancelTexturesAsync();
+	if (_asyncKey.empty())
+		_asyncKey = cocos2d::StringUtils::format("MyButton%p", this);
+
+	_asyncFiles[0] = idle;
+	_asyncFiles[1] = pushed;
+	_asyncFiles[2] = dragout;
+	// count first, cached textures call back before addImageAsync returns
+	_asyncPending = 1;
+	for (auto& file : _asyncFiles)
+	{
+		if (!file.empty())
+			++_asyncPending;
+	}
+
+	auto textureCache = _director->getTextureCache();
+	for (auto& file : _asyncFiles)
+	{
+		if (!file.empty())
+			textureCache->addImageAsync(file, CC_CALLBACK_1(MyButton::_onTextureAsync, this), _asyncKey);
+	}
+	// drops the extra count held while the requests were issued
+	_onTextureAsync(nullptr);
+}
+
+bool MyButton::isLoadingTextures() const
+{
+	return _asyncPending > 0;
+}
+
+void MyButton::_onTextureAsync(cocos2d::Texture2D*)
+{
+	if (--_asyncPending > 0)
+		return;
+
+	// the textures are cached now, building the frames does not touch the disk
+	auto style = MyButtonStyle::create(_asyncFiles[0], _asyncFiles[1], _asyncFiles[2]);
+	setStyle(style);
+	updateContentSize();
+	adaptRenderers();
+}
+
+void MyButton::_cancelTexturesAsync()
+{
+	if (_asyncPending == 0)
+		return;
+	_asyncPending = 0;
+	_director->getTextureCache()->unbindImageAsync(_asyncKey);
+}
+
+MyButtonStyle* MyButton::_ownStyle()
+{
+	// copy on write, a shared style stays immutable
+	if (_style->getReferenceCount() > 1 || _style == MyButtonStyle::getEmpty())
+	{
+		auto style = _style->clone();
+		_style->release();
+		_style = style;
+	}
+	return _style;
 }
     
 void MyButton::addButtonChild(cocos2d::Node* child)
 {
-	ChildInfo info;
-	info.node = child;
-	info.state_any = true;
-	_childNodes.push_back(info);
-	addChild(child);
-	_updateChildren();
+	addButtonChild(child, StateMask(0));
 }
 
 void MyButton::addButtonChild(cocos2d::Node* child, ButtonState state)
 {
+	addButtonChild(child, stateMask(state));
+}
+
+void MyButton::addButtonChild(cocos2d::Node* child, std::initializer_list<ButtonState> states)
+{
+	StateMask mask = 0;
+	for (auto state : states)
+		mask |= stateMask(state);
+	addButtonChild(child, mask);
+}
+
+void MyButton::addButtonChild(cocos2d::Node* child, StateMask states)
+{
+	CCASSERT(_childSlots.find(child) == _childSlots.end(), "child already added");
 	ChildInfo info;
 	info.node = child;
-	info.state = state;
-	info.state_any = false;
+	info.states = states;
+	_childSlots[child] = _childNodes.size();
 	_childNodes.push_back(info);
 	addChild(child);
-	_updateChildren();
+	if (info.states)
+		child->setVisible((info.states & stateMask(_buttonState)) != 0);
 }
 
 void MyButton::removeButtonChild(cocos2d::Node* child)
 {
-	for (auto i = _childNodes.begin(); i != _childNodes.end(); ++i)
+	if (_childSlots.find(child) == _childSlots.end())
+		return;
+	// drops the table entry in removeChild
+	child->removeFromParent();
+}
+
+void MyButton::removeChild(cocos2d::Node* child, bool cleanup)
+{
+	auto slot = _childSlots.find(child);
+	if (slot != _childSlots.end())
 	{
-		if (i->node != child)
-			continue;
-		_childNodes.erase(i);
-		child->removeFromParent();
-		break;
+		// swap-remove keeps the table contiguous
+		auto index = slot->second;
+		_childSlots.erase(slot);
+		if (index != _childNodes.size() - 1)
+		{
+			_childNodes[index] = _childNodes.back();
+			_childSlots[_childNodes[index].node] = index;
+		}
+		_childNodes.pop_back();
 	}
+	Widget::removeChild(child, cleanup);
+}
+
+void MyButton::removeAllChildrenWithCleanup(bool cleanup)
+{
+	_childNodes.clear();
+	_childSlots.clear();
+	Widget::removeAllChildrenWithCleanup(cleanup);
 }
 
 
@@ -164,14 +369,14 @@ void MyButton::setScale9Enabled(bool able)
 
     _scale9Enabled = able;
 
-    if (_scale9Enabled) {
-        _buttonIdleRenderer->setRenderingType(cocos2d::ui::Scale9Sprite::RenderingType::SLICE);
-        _buttonPushedRenderer->setRenderingType(cocos2d::ui::Scale9Sprite::RenderingType::SLICE);
-        _buttonDragoutRenderer->setRenderingType(cocos2d::ui::Scale9Sprite::RenderingType::SLICE);
-    }else{
-        _buttonIdleRenderer->setRenderingType(cocos2d::ui::Scale9Sprite::RenderingType::SIMPLE);
-        _buttonPushedRenderer->setRenderingType(cocos2d::ui::Scale9Sprite::RenderingType::SIMPLE);
-        _buttonDragoutRenderer->setRenderingType(cocos2d::ui::Scale9Sprite::RenderingType::SIMPLE);
+    auto renderingType = _scale9Enabled ?
+        cocos2d::ui::Scale9Sprite::RenderingType::SLICE :
+        cocos2d::ui::Scale9Sprite::RenderingType::SIMPLE;
+    _buttonIdleRenderer->setRenderingType(renderingType);
+    if (!_singleRenderer)
+    {
+        _buttonPushedRenderer->setRenderingType(renderingType);
+        _buttonDragoutRenderer->setRenderingType(renderingType);
     }
     
 
@@ -186,9 +391,9 @@ void MyButton::setScale9Enabled(bool able)
         ignoreContentAdaptWithSize(_prevIgnoreSize);
     }
 
-    setCapInsetsIdleRenderer(_capInsetsIdle);
-    setCapInsetsPushedRenderer(_capInsetsPushed);
-    setCapInsetsDragoutRenderer(_capInsetsDragout);
+    setCapInsetsIdleRenderer(_style->getIdle().capInsets);
+    setCapInsetsPushedRenderer(_style->getPushed().capInsets);
+    setCapInsetsDragoutRenderer(_style->getDragout().capInsets);
 
     _brightStyle = BrightStyle::NONE;
     setBright(_bright);
@@ -230,39 +435,43 @@ void MyButton::loadTextures(const std::string& idle,
 
 void MyButton::loadTextureIdle(const std::string& idle,TextureResType texType)
 {
-    _idleFileName = idle;
-    _idleTexType = texType;
-    bool textureLoaded = true;
-    if (idle.empty())
+    _cancelTexturesAsync();
+    MyButtonStyle::setStateTexture(_ownStyle()->_idle, idle, texType);
+    _applyIdleStyle();
+}
+
+void MyButton::loadTextureIdle(cocos2d::SpriteFrame* idleSpriteFrame)
+{
+    _cancelTexturesAsync();
+    MyButtonStyle::setStateSpriteFrame(_ownStyle()->_idle, idleSpriteFrame);
+    _applyIdleStyle();
+}
+
+void MyButton::_applyIdleStyle()
+{
+    auto& state = _style->getIdle();
+    if (_singleRenderer)
     {
-        _buttonIdleRenderer->resetRender();
-        textureLoaded = false;
+        _displayedSpriteFrame = nullptr;
+    }
+    else if (state.spriteFrame)
+    {
+        _buttonIdleRenderer->initWithSpriteFrame(state.spriteFrame,
+            _scale9Enabled ? state.capInsets : cocos2d::Rect::ZERO);
     }
     else
     {
-        switch (texType)
-        {
-        case TextureResType::LOCAL:
-            _buttonIdleRenderer->initWithFile(idle);
-            break;
-        case TextureResType::PLIST:
-            _buttonIdleRenderer->initWithSpriteFrameName(idle);
-            break;
-        default:
-            break;
-        }
+        _buttonIdleRenderer->resetRender();
     }
     //FIXME: https://github.com/cocos2d/cocos2d-x/issues/12249
     if (!_ignoreSize && _customSize.equals(cocos2d::Size::ZERO)) {
-        _customSize = _buttonIdleRenderer->getContentSize();
+        _customSize = state.textureSize;
     }
-    this->setupIdleTexture(textureLoaded);
+    this->setupIdleTexture(nullptr != state.spriteFrame);
 }
 
 void MyButton::setupIdleTexture(bool textureLoaded)
 {
-    _idleTextureSize = _buttonIdleRenderer->getContentSize();
-
     this->updateChildrenDisplayedRGBA();
 
     if (_unifySize )
@@ -274,102 +483,99 @@ void MyButton::setupIdleTexture(bool textureLoaded)
     }
     else
     {
-        updateContentSizeWithTextureSize(_idleTextureSize);
+        updateContentSizeWithTextureSize(_style->getIdle().textureSize);
     }
+
     _idleTextureLoaded = textureLoaded;
     _idleTextureAdaptDirty = true;
+    if (_singleRenderer)
+        _updateRenderers();
 }
 
-void MyButton::loadTextureIdle(cocos2d::SpriteFrame* idleSpriteFrame)
+void MyButton::loadTexturePushed(const std::string& selected,TextureResType texType)
 {
-    _buttonIdleRenderer->initWithSpriteFrame(idleSpriteFrame);
-    this->setupIdleTexture(nullptr != idleSpriteFrame);
+    _cancelTexturesAsync();
+    MyButtonStyle::setStateTexture(_ownStyle()->_pushed, selected, texType);
+    _applyPushedStyle();
 }
 
-void MyButton::loadTexturePushed(const std::string& selected,TextureResType texType)
+void MyButton::loadTexturePushed(cocos2d::SpriteFrame* pushedSpriteFrame)
 {
-    _pushedFileName = selected;
-    _pushedTexType = texType;
-    bool textureLoaded = true;
-    if (selected.empty())
+    _cancelTexturesAsync();
+    MyButtonStyle::setStateSpriteFrame(_ownStyle()->_pushed, pushedSpriteFrame);
+    _applyPushedStyle();
+}
+
+void MyButton::_applyPushedStyle()
+{
+    auto& state = _style->getPushed();
+    if (_singleRenderer)
     {
-        _buttonPushedRenderer->resetRender();
-        textureLoaded = false;
+        _displayedSpriteFrame = nullptr;
+    }
+    else if (state.spriteFrame)
+    {
+        _buttonPushedRenderer->initWithSpriteFrame(state.spriteFrame,
+            _scale9Enabled ? state.capInsets : cocos2d::Rect::ZERO);
     }
     else
     {
-        switch (texType)
-        {
-        case TextureResType::LOCAL:
-            _buttonPushedRenderer->initWithFile(selected);
-            break;
-        case TextureResType::PLIST:
-            _buttonPushedRenderer->initWithSpriteFrameName(selected);
-            break;
-        default:
-            break;
-        }
+        _buttonPushedRenderer->resetRender();
     }
-    this->setupPushedTexture(textureLoaded);
+    this->setupPushedTexture(nullptr != state.spriteFrame);
 }
 
 void MyButton::setupPushedTexture(bool textureLoaded)
 {
-    _pushedTextureSize = _buttonPushedRenderer->getContentSize();
-
     this->updateChildrenDisplayedRGBA();
 
     _pushedTextureLoaded = textureLoaded;
     _pushedTextureAdaptDirty = true;
+    if (_singleRenderer)
+        _updateRenderers();
 }
 
-void MyButton::loadTexturePushed(cocos2d::SpriteFrame* pushedSpriteFrame)
+void MyButton::loadTextureDragout(const std::string& dragout,TextureResType texType)
 {
-    _buttonPushedRenderer->initWithSpriteFrame(pushedSpriteFrame);
-    this->setupPushedTexture(nullptr != pushedSpriteFrame);
+    _cancelTexturesAsync();
+    MyButtonStyle::setStateTexture(_ownStyle()->_dragout, dragout, texType);
+    _applyDragoutStyle();
 }
 
-void MyButton::loadTextureDragout(const std::string& dragout,TextureResType texType)
+void MyButton::loadTextureDragout(cocos2d::SpriteFrame* dragoutSpriteFrame)
+{
+    _cancelTexturesAsync();
+    MyButtonStyle::setStateSpriteFrame(_ownStyle()->_dragout, dragoutSpriteFrame);
+    _applyDragoutStyle();
+}
+
+void MyButton::_applyDragoutStyle()
 {
-    _dragoutFileName = dragout;
-    _dragoutTexType = texType;
-    bool textureLoaded = true;
-    if (dragout.empty())
+    auto& state = _style->getDragout();
+    if (_singleRenderer)
     {
-        _buttonDragoutRenderer->resetRender();
-        textureLoaded = false;
+        _displayedSpriteFrame = nullptr;
+    }
+    else if (state.spriteFrame)
+    {
+        _buttonDragoutRenderer->initWithSpriteFrame(state.spriteFrame,
+            _scale9Enabled ? state.capInsets : cocos2d::Rect::ZERO);
     }
     else
     {
-        switch (texType)
-        {
-        case TextureResType::LOCAL:
-            _buttonDragoutRenderer->initWithFile(dragout);
-            break;
-        case TextureResType::PLIST:
-            _buttonDragoutRenderer->initWithSpriteFrameName(dragout);
-            break;
-        default:
-            break;
-        }
+        _buttonDragoutRenderer->resetRender();
     }
-    this->setupDragoutTexture(textureLoaded);
+    this->setupDragoutTexture(nullptr != state.spriteFrame);
 }
 
 void MyButton::setupDragoutTexture(bool textureLoaded)
 {
-    _dragoutTextureSize = _buttonDragoutRenderer->getContentSize();
-
     this->updateChildrenDisplayedRGBA();
 
     _dragoutTextureLoaded = textureLoaded;
     _dragoutTextureAdaptDirty = true;
-}
-
-void MyButton::loadTextureDragout(cocos2d::SpriteFrame* dragoutSpriteFrame)
-{
-    _buttonDragoutRenderer->initWithSpriteFrame(dragoutSpriteFrame);
-    this->setupDragoutTexture(nullptr != dragoutSpriteFrame);
+    if (_singleRenderer)
+        _updateRenderers();
 }
 
 void MyButton::setCapInsets(const cocos2d::Rect &capInsets)
@@ -382,53 +588,83 @@ void MyButton::setCapInsets(const cocos2d::Rect &capInsets)
 
 void MyButton::setCapInsetsIdleRenderer(const cocos2d::Rect &capInsets)
 {
-    _capInsetsIdle = cocos2d::ui::Helper::restrictCapInsetRect(capInsets, this->_idleTextureSize);
+    auto capInsetsIdle = cocos2d::ui::Helper::restrictCapInsetRect(capInsets, _style->getIdle().textureSize);
+    if (!capInsetsIdle.equals(_style->getIdle().capInsets))
+    {
+        _ownStyle()->_idle.capInsets = capInsetsIdle;
+    }
 
     //for performance issue
     if (!_scale9Enabled)
     {
         return;
     }
-    _buttonIdleRenderer->setCapInsets(_capInsetsIdle);
+    if (_singleRenderer)
+    {
+        _displayedSpriteFrame = nullptr;
+        _updateRenderers();
+        return;
+    }
+    _buttonIdleRenderer->setCapInsets(capInsetsIdle);
 }
 
 void MyButton::setCapInsetsPushedRenderer(const cocos2d::Rect &capInsets)
 {
-    _capInsetsPushed = cocos2d::ui::Helper::restrictCapInsetRect(capInsets, this->_pushedTextureSize);
+    auto capInsetsPushed = cocos2d::ui::Helper::restrictCapInsetRect(capInsets, _style->getPushed().textureSize);
+    if (!capInsetsPushed.equals(_style->getPushed().capInsets))
+    {
+        _ownStyle()->_pushed.capInsets = capInsetsPushed;
+    }
 
     //for performance issue
     if (!_scale9Enabled)
     {
         return;
     }
-    _buttonPushedRenderer->setCapInsets(_capInsetsPushed);
+    if (_singleRenderer)
+    {
+        _displayedSpriteFrame = nullptr;
+        _updateRenderers();
+        return;
+    }
+    _buttonPushedRenderer->setCapInsets(capInsetsPushed);
 }
 
 void MyButton::setCapInsetsDragoutRenderer(const cocos2d::Rect &capInsets)
 {
-    _capInsetsDragout = cocos2d::ui::Helper::restrictCapInsetRect(capInsets, this->_dragoutTextureSize);
+    auto capInsetsDragout = cocos2d::ui::Helper::restrictCapInsetRect(capInsets, _style->getDragout().textureSize);
+    if (!capInsetsDragout.equals(_style->getDragout().capInsets))
+    {
+        _ownStyle()->_dragout.capInsets = capInsetsDragout;
+    }
 
     //for performance issue
     if (!_scale9Enabled)
     {
         return;
     }
-    _buttonDragoutRenderer->setCapInsets(_capInsetsDragout);
+    if (_singleRenderer)
+    {
+        _displayedSpriteFrame = nullptr;
+        _updateRenderers();
+        return;
+    }
+    _buttonDragoutRenderer->setCapInsets(capInsetsDragout);
 }
 
 const cocos2d::Rect& MyButton::getCapInsetsIdleRenderer()const
 {
-    return _capInsetsIdle;
+    return _style->getIdle().capInsets;
 }
 
 const cocos2d::Rect& MyButton::getCapInsetsPushedRenderer()const
 {
-    return _capInsetsPushed;
+    return _style->getPushed().capInsets;
 }
 
 const cocos2d::Rect& MyButton::getCapInsetsDragoutRenderer()const
 {
-    return _capInsetsDragout;
+    return _style->getDragout().capInsets;
 }
 
 void MyButton::updateContentSize()
@@ -473,18 +709,11 @@ void MyButton::onSizeChanged()
 }
 
 
-void MyButton::update(float dt)
+void MyButton::onExit()
 {
-	Widget::update(dt);
-	if (_buttonState == ButtonState::PUSHED)
-	{
-		_pushedTime += dt;
-		if (_pushedTimeout != 0.0 && _pushedTime >= _pushedTimeout)
-		{
-			_refreshButtonState(nullptr);
-			_generateEvent(ButtonState::PUSHED, true);
-		}
-	}
+	// the touches are lost together with the scene, drop a pending long push
+	_releaseAllTouches();
+	Widget::onExit();
 }
 
 
@@ -525,7 +754,7 @@ cocos2d::Size MyButton::getVirtualRendererSize() const
             return titleSize;
         }
     }*/
-    return _idleTextureSize;
+    return _style->getIdle().textureSize;
 }
 
 cocos2d::Node* MyButton::getVirtualRenderer()
@@ -537,14 +766,14 @@ cocos2d::Node* MyButton::getVirtualRenderer()
             case BrightStyle::NORMAL:
                 return _buttonIdleRenderer;
             case BrightStyle::HIGHLIGHT:
-                return _buttonPushedRenderer;
+                return getRendererPushed();
             default:
                 return nullptr;
         }
     }
     else
     {
-        return _buttonDragoutRenderer;
+        return getRendererDragout();
     }
 }
 
@@ -557,6 +786,11 @@ void MyButton::idleTextureScaleChangedWithSize()
 
 void MyButton::pushedTextureScaleChangedWithSize()
 {
+    if (_singleRenderer)
+    {
+        return;
+    }
+
     _buttonPushedRenderer->setPreferredSize(_contentSize);
 
     _buttonPushedRenderer->setPosition(_contentSize.width / 2.0f, _contentSize.height / 2.0f);
@@ -564,6 +798,11 @@ void MyButton::pushedTextureScaleChangedWithSize()
 
 void MyButton::dragoutTextureScaleChangedWithSize()
 {
+    if (_singleRenderer)
+    {
+        return;
+    }
+
     _buttonDragoutRenderer->setPreferredSize(_contentSize);
     
     _buttonDragoutRenderer->setPosition(_contentSize.width / 2.0f, _contentSize.height / 2.0f);
@@ -584,6 +823,29 @@ std::string MyButton::getDescription() const
     return "MyButton";
 }
 
+void MyButton::visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTransform, uint32_t parentFlags)
+{
+	bool boundsDirty = _transformUpdated || _contentSizeDirty || (parentFlags & FLAGS_DIRTY_MASK);
+	Widget::visit(renderer, parentTransform, parentFlags);
+	if (!boundsDirty)
+		return;
+	// the group reindexes the button lazily on the next touch
+	if (_group)
+		_group->_invalidateButton(this);
+}
+
+void MyButton::setTouchEnabled(bool enabled)
+{
+	// the group dispatches the touches of its buttons, no listener of its own
+	if (_group)
+	{
+		_touchEnabled = enabled;
+		_group->_entries[_groupSlot].touchEnabled = enabled;
+		return;
+	}
+	Widget::setTouchEnabled(enabled);
+}
+
 cocos2d::ui::Widget* MyButton::createCloneInstance()
 {
     return MyButton::create();
@@ -596,36 +858,17 @@ void MyButton::copySpecialProperties(Widget *widget)
     {
         _prevIgnoreSize = button->_prevIgnoreSize;
         setScale9Enabled(button->_scale9Enabled);
-
-        // clone the inner sprite: https://github.com/cocos2d/cocos2d-x/issues/16924
-        button->_buttonIdleRenderer->copyTo(_buttonIdleRenderer);
-        _idleFileName = button->_idleFileName;
-        _idleTextureSize = button->_idleTextureSize;
-        _idleTexType = button->_idleTexType;
-        _idleTextureLoaded = button->_idleTextureLoaded;
-        setupIdleTexture(!_idleFileName.empty());
-
-        button->_buttonPushedRenderer->copyTo(_buttonPushedRenderer);
-        _pushedFileName = button->_pushedFileName;
-        _pushedTextureSize = button->_pushedTextureSize;
-        _pushedTexType = button->_pushedTexType;
-        _pushedTextureLoaded = button->_pushedTextureLoaded;
-        setupPushedTexture(!_pushedFileName.empty());
-
-        button->_buttonDragoutRenderer->copyTo(_buttonDragoutRenderer);
-        _dragoutFileName = button->_dragoutFileName;
-        _dragoutTextureSize = button->_dragoutTextureSize;
-        _dragoutTexType = button->_dragoutTexType;
-        _dragoutTextureLoaded = button->_dragoutTextureLoaded;
-        setupDragoutTexture(!_dragoutFileName.empty());
-
-        setCapInsetsIdleRenderer(button->_capInsetsIdle);
-        setCapInsetsPushedRenderer(button->_capInsetsPushed);
-        setCapInsetsDragoutRenderer(button->_capInsetsDragout);
+        setSingleRendererEnabled(button->_singleRenderer);
+        // the clone shares the style until one of them overrides it
+        setStyle(button->_style);
         setZoomScale(button->_zoomScale);
+        setMultiTouchPolicy(button->_multiTouchPolicy);
+        // the clone shows the same placeholder until its own load completes
+        if (button->_asyncPending > 0)
+            loadTexturesAsync(button->_asyncFiles[0], button->_asyncFiles[1], button->_asyncFiles[2]);
     }
-
 }
+
 cocos2d::Size MyButton::getIdleSize() const
 {
 	cocos2d::Size imageSize;
@@ -650,114 +893,207 @@ bool MyButton::hitTest(const cocos2d::Vec2 &pt,
 					   const cocos2d::Camera* camera,
 					   cocos2d::Vec3 *p) const
 {
-	auto rect = getSafeZoneRect();
-	return isScreenPointInRect(pt, camera, getWorldToNodeTransform(), rect, p);
+	cocos2d::Vec3 nodePoint;
+	if (!_projectTouch(pt, camera, &nodePoint))
+		return false;
+	if (p)
+		*p = nodePoint;
+	return _zoneContains(getSafeZoneRect(), nodePoint);
+}
+
+bool MyButton::_projectTouch(const cocos2d::Vec2& pt,
+							 const cocos2d::Camera* camera,
+							 cocos2d::Vec3* nodePoint) const
+{
+	if (nullptr == camera)
+		return false;
+
+	// the node to world transform follows the own setters and the whole parent chain,
+	// without the dirty flags of Node, only its inverse is worth caching
+	cocos2d::Mat4 nodeToWorld = getNodeToWorldTransform();
+	if (std::memcmp(nodeToWorld.m, _nodeToWorldCache.m, sizeof(nodeToWorld.m)) != 0)
+	{
+		_nodeToWorldCache = nodeToWorld;
+		_worldToNodeCache = nodeToWorld.getInversed();
+		_touchCacheValid = false;
+	}
+
+	// hitTest and the state refresh of the same event share one projection
+	if (!_touchCacheValid || _touchCacheCamera != camera || _touchCacheScreenPoint != pt)
+	{
+		// the same ray - plane intersection as isScreenPointInRect,
+		// zone rects all lie in the z = 0 plane of the node
+		cocos2d::Vec3 Pn(pt.x, pt.y, -1), Pf(pt.x, pt.y, 1);
+		Pn = camera->unprojectGL(Pn);
+		Pf = camera->unprojectGL(Pf);
+		_worldToNodeCache.transformPoint(&Pn);
+		_worldToNodeCache.transformPoint(&Pf);
+		auto E = Pf - Pn;
+		_touchCacheProjected = E.z != 0;
+		if (_touchCacheProjected)
+			_touchCacheNodePoint = Pn - (Pn.z / E.z) * E;
+		_touchCacheCamera = camera;
+		_touchCacheScreenPoint = pt;
+		_touchCacheValid = true;
+	}
+
+	*nodePoint = _touchCacheNodePoint;
+	return _touchCacheProjected;
+}
+
+bool MyButton::_zoneContains(const cocos2d::Rect& zone, const cocos2d::Vec3& nodePoint)
+{
+	if (zone.size.width <= 0 || zone.size.height <= 0)
+		return false;
+	return zone.containsPoint(cocos2d::Vec2(nodePoint.x, nodePoint.y));
 }
 
 
 bool MyButton::onTouchBegan(cocos2d::Touch *touch, cocos2d::Event *unusedEvent)
 {
-	auto r = Widget::onTouchBegan(touch, unusedEvent);
-	_refreshButtonState(&touch->getLocation());
-	return r;
+	if (_touchCount == MAX_TOUCHES)
+		return false;
+	// a new event, the camera may have moved since the previous one
+	_touchCacheValid = false;
+	if (!Widget::onTouchBegan(touch, unusedEvent))
+		return false;
+	auto location = touch->getLocation();
+	auto& info = _touches[_touchCount++];
+	info.id = touch->getID();
+	info.state = _classifyTouch(location);
+	_refreshButtonState();
+	return true;
 }
 
 void MyButton::onTouchMoved(cocos2d::Touch *touch, cocos2d::Event *unusedEvent)
 {
+	_touchCacheValid = false;
 	Widget::onTouchMoved(touch, unusedEvent);
-	_refreshButtonState(&touch->getLocation());
+	// a touch dropped by a long push still reaches the Widget until it ends,
+	// but no longer drives the button state
+	int index = _findTouch(touch->getID());
+	if (index < 0)
+		return;
+	auto location = touch->getLocation();
+	_touches[index].state = _classifyTouch(location);
+	_refreshButtonState();
 }
 
 void MyButton::onTouchEnded(cocos2d::Touch *touch, cocos2d::Event *unusedEvent)
 {
-	auto old_state = _buttonState;
 	Widget::onTouchEnded(touch, unusedEvent);
-	_refreshButtonState(nullptr);
-	if (old_state == ButtonState::PUSHED)
-		_generateEvent(old_state, false);
+	int index = _findTouch(touch->getID());
+	if (index < 0)
+		return;
+	bool pushed = _touches[index].state == ButtonState::PUSHED && _isDrivingTouch(index);
+	_removeTouch(index);
+	_refreshButtonState();
+	if (pushed)
+		_generateEvent(ButtonState::PUSHED, false);
 }
 
 
 void MyButton::_generateEvent(ButtonState state, bool is_long)
 {
-	if (!_touchEndedCallback)
+	if (!_touchEndedCallback && !_touchEndedDispatch)
 		return;
-	cocos2d::EventCustom event("my_button_touch_ended");
-	TouchEndedCallbackData data;
-	data.button = this;
-	data.state = state;
-	event.setUserData(&data);
-	_touchEndedCallback(&event);
+	_touchEndedEvent.reset();
+	_touchEndedEvent.data.state = state;
+	_touchEndedEvent.data.is_long = is_long;
+	// listeners may release the button, keep it alive for the whole dispatch
+	retain();
+	if (_touchEndedCallback)
+		_touchEndedCallback(&_touchEndedEvent);
+	if (_touchEndedDispatch)
+	{
+		if (!_touchEndedChannel.isValid())
+			_touchEndedChannel = _eventDispatcher->getCustomEventChannel(getTouchEndedEventName());
+		_eventDispatcher->dispatchCustomEvent(_touchEndedChannel, &_touchEndedEvent.data);
+	}
+	release();
 }
 
 void MyButton::onTouchCancelled(cocos2d::Touch *touch, cocos2d::Event *unusedEvent)
 {
 	Widget::onTouchCancelled(touch, unusedEvent);
-	_refreshButtonState(nullptr);
+	int index = _findTouch(touch->getID());
+	if (index < 0)
+		return;
+	_removeTouch(index);
+	_refreshButtonState();
 }
 
 cocos2d::Size MyButton::getIdleTextureSize() const
 {
-    return _idleTextureSize;
+    return _style->getIdle().textureSize;
 }
 
 void MyButton::resetIdleRender()
 {
-    _idleFileName = "";
-    _idleTexType = TextureResType::LOCAL;
-
-    _idleTextureSize = cocos2d::Size(0, 0);
+    MyButtonStyle::setStateTexture(_ownStyle()->_idle, "", TextureResType::LOCAL);
 
     _idleTextureLoaded = false;
     _idleTextureAdaptDirty = false;
 
+    if (_singleRenderer)
+    {
+        _displayedSpriteFrame = nullptr;
+        _updateRenderers();
+        return;
+    }
     _buttonIdleRenderer->resetRender();
 }
 void MyButton::resetPushedRender()
 {
-    _pushedFileName = "";
-    _pushedTexType = TextureResType::LOCAL;
-
-    _pushedTextureSize = cocos2d::Size(0, 0);
+    MyButtonStyle::setStateTexture(_ownStyle()->_pushed, "", TextureResType::LOCAL);
 
     _pushedTextureLoaded = false;
     _pushedTextureAdaptDirty = false;
 
+    if (_singleRenderer)
+    {
+        _displayedSpriteFrame = nullptr;
+        _updateRenderers();
+        return;
+    }
     _buttonPushedRenderer->resetRender();
 }
 
 void MyButton::resetDragoutRender()
 {
-    _dragoutFileName = "";
-    _dragoutTexType = TextureResType::LOCAL;
-
-    _dragoutTextureSize = cocos2d::Size(0, 0);
+    MyButtonStyle::setStateTexture(_ownStyle()->_dragout, "", TextureResType::LOCAL);
 
     _dragoutTextureLoaded = false;
     _dragoutTextureAdaptDirty = false;
 
+    if (_singleRenderer)
+    {
+        _displayedSpriteFrame = nullptr;
+        _updateRenderers();
+        return;
+    }
     _buttonDragoutRenderer->resetRender();
 }
 
 cocos2d::ResourceData MyButton::getIdleFile()
 {
 	cocos2d::ResourceData rData;
-    rData.type = (int)_idleTexType;
-    rData.file = _idleFileName;
+    rData.type = (int)_style->getIdle().texType;
+    rData.file = _style->getIdle().fileName;
     return rData;
 }
 cocos2d::ResourceData MyButton::getPushedFile()
 {
 	cocos2d::ResourceData rData;
-    rData.type = (int)_pushedTexType;
-    rData.file = _pushedFileName;
+    rData.type = (int)_style->getPushed().texType;
+    rData.file = _style->getPushed().fileName;
     return rData;
 }
 cocos2d::ResourceData MyButton::getDragoutFile()
 {
 	cocos2d::ResourceData rData;
-    rData.type = (int)_dragoutTexType;
-    rData.file = _dragoutFileName;
+    rData.type = (int)_style->getDragout().texType;
+    rData.file = _style->getDragout().fileName;
     return rData;
 }
 
@@ -772,6 +1108,8 @@ cocos2d::Size MyButton::getExpandZone() const
 void MyButton::setExpandZone(const cocos2d::Size& expandZone)
 {
 	_expandZone = expandZone;
+	if (_group)
+		_group->_invalidateButton(this);
 }
 cocos2d::Rect MyButton::getExpandZoneRect() const
 {
@@ -789,6 +1127,8 @@ cocos2d::Size MyButton::getSafeZone() const
 void MyButton::setSafeZone(const cocos2d::Size& safeZone)
 {
 	_safeZone = safeZone;
+	if (_group)
+		_group->_invalidateButton(this);
 }
 cocos2d::Rect MyButton::getSafeZoneRect() const
 {
@@ -805,40 +1145,112 @@ cocos2d::Rect MyButton::_makeZoneRect(const cocos2d::Size& zoneSize) const
 	return zoneRect;
 }
 
-void MyButton::_refreshButtonState(const cocos2d::Vec2* pt)
+MyButton::ButtonState MyButton::_classifyTouch(const cocos2d::Vec2& pt) const
+{
+	// one projection classifies both zones
+	cocos2d::Vec3 nodePoint;
+	if (!_projectTouch(pt, cocos2d::Camera::getVisitingCamera(), &nodePoint))
+		return ButtonState::IDLE;
+	if (_zoneContains(getExpandZoneRect(), nodePoint))
+		return ButtonState::PUSHED;
+	if (_zoneContains(getSafeZoneRect(), nodePoint))
+		return ButtonState::DRAGOUT;
+	return ButtonState::IDLE;
+}
+
+int MyButton::_findTouch(int id) const
 {
-	if (!pt)
+	for (int i = 0; i < _touchCount; ++i)
 	{
-		_buttonState = ButtonState::IDLE;
+		if (_touches[i].id == id)
+			return i;
 	}
-	else
+	return -1;
+}
+
+bool MyButton::_isDrivingTouch(int index) const
+{
+	switch (_multiTouchPolicy)
 	{
-		auto camera = cocos2d::Camera::getVisitingCamera();
-		auto mat = getWorldToNodeTransform();
-		auto expandZoneRect = getExpandZoneRect();
-		if (isScreenPointInRect(*pt, camera, mat, expandZoneRect, nullptr))
-		{
-			if (_buttonState != ButtonState::PUSHED)
-			{
-				_buttonState = ButtonState::PUSHED;
-				_pushedTime = 0.0f;
-			}
-		}
-		else
-		{
-			auto safeZoneRect = getSafeZoneRect();
-			if (isScreenPointInRect(*pt, camera, mat, safeZoneRect, nullptr))
-				_buttonState = ButtonState::DRAGOUT;
-			else
-				_buttonState = ButtonState::IDLE;
-		}
+	case MultiTouchPolicy::FIRST_WINS:
+		return index == 0;
+	case MultiTouchPolicy::LAST_WINS:
+		return index == _touchCount - 1;
+	default:
+		return true;
 	}
+}
 
-	_buttonIdleRenderer->setVisible(_buttonState == ButtonState::IDLE);
-	_buttonPushedRenderer->setVisible(_buttonState == ButtonState::PUSHED);
-	_buttonDragoutRenderer->setVisible(_buttonState == ButtonState::DRAGOUT);
-	//_buttonIdleRenderer->setState(cocos2d::ui::Scale9Sprite::State::NORMAL);
-	_updateChildren();
+void MyButton::_removeTouch(int index)
+{
+	// keeps the arrival order, the array is tiny
+	for (int i = index + 1; i < _touchCount; ++i)
+		_touches[i - 1] = _touches[i];
+	--_touchCount;
+}
+
+void MyButton::_releaseAllTouches()
+{
+	_touchCount = 0;
+	_refreshButtonState();
+}
+
+void MyButton::_refreshButtonState()
+{
+	auto oldState = _buttonState;
+	_buttonState = ButtonState::IDLE;
+	for (int i = 0; i < _touchCount; ++i)
+	{
+		if (!_isDrivingTouch(i))
+			continue;
+		// any held touches rank pushed over dragout over idle
+		auto state = _touches[i].state;
+		if (state == ButtonState::PUSHED || (state == ButtonState::DRAGOUT && _buttonState == ButtonState::IDLE))
+			_buttonState = state;
+	}
+
+	// touch moves inside the same zone change nothing
+	if (oldState == _buttonState)
+		return;
+
+	// the long push timer lives only while the button stays pushed
+	if (oldState == ButtonState::PUSHED)
+		_cancelLongPush();
+	else if (_buttonState == ButtonState::PUSHED)
+		_armLongPush();
+
+	_updateRenderers();
+	_updateChildren(oldState);
+}
+
+void MyButton::_updateRenderers()
+{
+	if (!_singleRenderer)
+	{
+		_buttonIdleRenderer->setVisible(_buttonState == ButtonState::IDLE);
+		_buttonPushedRenderer->setVisible(_buttonState == ButtonState::PUSHED);
+		_buttonDragoutRenderer->setVisible(_buttonState == ButtonState::DRAGOUT);
+		return;
+	}
+
+	const MyButtonStyle::StateStyle* state = &_style->getIdle();
+	if (_buttonState == ButtonState::PUSHED)
+		state = &_style->getPushed();
+	else if (_buttonState == ButtonState::DRAGOUT)
+		state = &_style->getDragout();
+	cocos2d::SpriteFrame* frame = state->spriteFrame;
+
+	_buttonIdleRenderer->setVisible(nullptr != frame);
+	if (nullptr == frame || frame == _displayedSpriteFrame)
+		return;
+	_displayedSpriteFrame = frame;
+	if (_scale9Enabled)
+		_buttonIdleRenderer->setSpriteFrame(frame, state->capInsets);
+	else
+		_buttonIdleRenderer->setSpriteFrame(frame);
+	// the frame resets the sprite to its original size, keep the button geometry
+	_buttonIdleRenderer->setPreferredSize(_contentSize);
+	_buttonIdleRenderer->setPosition(_contentSize.width / 2.0f, _contentSize.height / 2.0f);
 }
 
 void MyButton::setTouchEndedCallback(const TouchEndedCallback& cb)
@@ -846,6 +1258,51 @@ void MyButton::setTouchEndedCallback(const TouchEndedCallback& cb)
 	_touchEndedCallback = cb;
 }
 
+const std::string& MyButton::getTouchEndedEventName()
+{
+	static const std::string name("my_button_touch_ended");
+	return name;
+}
+
+cocos2d::EventListenerCustom* MyButton::createTouchEndedListener(const TouchEndedCallback& callback,
+																 MyButton* sender)
+{
+	return cocos2d::EventListenerCustom::create(getTouchEndedEventName(), [callback, sender](cocos2d::EventCustom* event)
+	{
+		// the sender is a field of the event, no lookup per listener
+		auto data = static_cast<TouchEndedCallbackData*>(event->getUserData());
+		if (sender && data->button != sender)
+			return;
+		callback(event);
+	});
+}
+
+void MyButton::setTouchEndedDispatchEnabled(bool enabled)
+{
+	_touchEndedDispatch = enabled;
+}
+
+bool MyButton::isTouchEndedDispatchEnabled() const
+{
+	return _touchEndedDispatch;
+}
+
+MyButton::TouchEndedEvent::TouchEndedEvent():
+cocos2d::EventCustom(MyButton::getTouchEndedEventName())
+{
+	data.button = nullptr;
+	data.state = ButtonState::IDLE;
+	data.is_long = false;
+	setUserData(&data);
+}
+
+void MyButton::TouchEndedEvent::reset()
+{
+	// a listener of the previous release may have stopped the event
+	_isStopped = false;
+	_currentTarget = nullptr;
+}
+
 float MyButton::getPushedTimeout()
 {
 	return _pushedTimeout;
@@ -853,14 +1310,52 @@ float MyButton::getPushedTimeout()
 void MyButton::setPushedTimeout(float v)
 {
 	_pushedTimeout = v;
+	// restart a running long push with the new timeout
+	if (_buttonState == ButtonState::PUSHED)
+	{
+		_cancelLongPush();
+		_armLongPush();
+	}
+}
+
+void MyButton::setMultiTouchPolicy(MultiTouchPolicy policy)
+{
+	_multiTouchPolicy = policy;
+	_refreshButtonState();
+}
+
+MyButton::MultiTouchPolicy MyButton::getMultiTouchPolicy() const
+{
+	return _multiTouchPolicy;
+}
+
+void MyButton::_armLongPush()
+{
+	if (_pushedTimeout > 0.0f)
+		scheduleOnce(CC_SCHEDULE_SELECTOR(MyButton::_onLongPush), _pushedTimeout);
+}
+
+void MyButton::_cancelLongPush()
+{
+	unschedule(CC_SCHEDULE_SELECTOR(MyButton::_onLongPush));
 }
 
-void MyButton::_updateChildren()
+void MyButton::_onLongPush(float)
 {
+	_releaseAllTouches();
+	_generateEvent(ButtonState::PUSHED, true);
+}
+
+void MyButton::_updateChildren(ButtonState oldState)
+{
+	auto oldMask = stateMask(oldState);
+	auto newMask = stateMask(_buttonState);
 	for (auto& info : _childNodes)
 	{
-		if (info.state_any)
-			continue;
-		info.node->setVisible(_buttonState == info.state);
+		// only the children bound to exactly one of the two states flip
+		bool wasVisible = (info.states & oldMask) != 0;
+		bool isVisible = (info.states & newMask) != 0;
+		if (info.states && wasVisible != isVisible)
+			info.node->setVisible(isVisible);
 	}
 }
@@ -5,8 +5,12 @@ Copyright (c) 2020 Anton Kulikov
 #ifndef __MYBUTTON_H__
 #define __MYBUTTON_H__
 
-#include <list>
+#include <initializer_list>
+#include <unordered_map>
+#include <vector>
 #include "base/CCEventCustom.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
 #include "ui/UIWidget.h"
 #include "ui/GUIExport.h"
 #include "ui/UIScale9Sprite.h"
@@ -18,6 +22,8 @@ Copyright (c) 2020 Anton Kulikov
 #include <algorithm>
 #include "editor-support/cocostudio/CocosStudioExtension.h"
 
+class MyButtonGroup;
+class MyButtonStyle;
 
 class MyButton : public cocos2d::ui::Widget
 {
@@ -32,6 +38,24 @@ public:
 		DRAGOUT
 	};
 
+	/** Which of several touches on the button drives its state. */
+	enum class MultiTouchPolicy
+	{
+		/** The oldest touch drives the button, the others wait until it ends. */
+		FIRST_WINS,
+		/** The newest touch drives the button. */
+		LAST_WINS,
+		/** The button is pushed while any touch is pushing it, every touch released pushed fires. */
+		ANY_HELD
+	};
+
+	/** Touches tracked at once by one button, further touches are not claimed. */
+	static const int MAX_TOUCHES = 4;
+
+	/** Set of button states, a bit per state. */
+	typedef unsigned int StateMask;
+	static StateMask stateMask(ButtonState state) { return 1u << static_cast<unsigned int>(state); }
+
 	/**
      * Default constructor.
      */
@@ -50,6 +74,13 @@ public:
      */
     static MyButton* create();
 
+    /**
+     * Create a button with a shared style.
+     * @param style the style, the button retains it.
+     * @return a MyButton instance.
+     */
+    static MyButton* create(MyButtonStyle* style);
+
     /**
      * Create a button with custom textures.
      * @param idleImage idle state texture name.
@@ -63,6 +94,38 @@ public:
                           const std::string& disableImage = "",
                           TextureResType texType = TextureResType::LOCAL);
 
+    /**
+     * Create a button whose textures are decoded in the background.
+     * @param idleImage idle state texture file.
+     * @param pushedImage pushed state texture file.
+     * @param dragoutImage dragout state texture file.
+     * @param placeholder style shown until the textures arrive, nullptr shows nothing.
+     * @return a MyButton instance.
+     */
+    static MyButton* createAsync(const std::string& idleImage,
+                                 const std::string& pushedImage = "",
+                                 const std::string& dragoutImage = "",
+                                 MyButtonStyle* placeholder = nullptr);
+
+    /**
+     * Load local textures through `TextureCache::addImageAsync`.
+     * The current style stays on screen as a placeholder, the button switches to the
+     * loaded textures and lays itself out once all of them have arrived.
+     * Any other texture or style setter cancels a pending load.
+     *
+     * @param idle    idle state texture file.
+     * @param pushed    pushed state texture file.
+     * @param dragout    dragout state texture file.
+     */
+    void loadTexturesAsync(const std::string& idle,
+                           const std::string& pushed = "",
+                           const std::string& dragout = "");
+
+    /**
+     * Query whether an asynchronous texture load is pending.
+     */
+    bool isLoadingTextures() const;
+
     /**
      * Load textures for button.
      *
@@ -160,16 +223,57 @@ public:
      */
     bool isScale9Enabled()const;
 
+    /**
+     * Enable single renderer mode.
+     * One renderer swaps the sprite frames of the states instead of three renderers
+     * toggling their visibility. Frames of one atlas (`TextureResType::PLIST`) share the texture.
+     * The pushed and dragout renderer accessors return the shared renderer in this mode.
+     *
+     * @param enabled Set to true to use one renderer, false for three state renderers.
+     */
+    void setSingleRendererEnabled(bool enabled);
+
+    /**
+     * Query whether button is using single renderer mode or not.
+     *@return whether button swaps sprite frames of one renderer.
+     */
+    bool isSingleRendererEnabled() const;
+
+    /**
+     * Set the style shared with other buttons.
+     * Texture and cap insets setters of the button override the style for this button only.
+     *
+     * @param style the style, nullptr resets the button to the empty style.
+     */
+    void setStyle(MyButtonStyle* style);
+
+    /**
+     * Return the style of the button.
+     * Retain it to keep using it after the button overrides a value.
+     */
+    MyButtonStyle* getStyle() const;
+
     //override methods
     virtual void ignoreContentAdaptWithSize(bool ignore) override;
     virtual cocos2d::Size getVirtualRendererSize() const override;
     virtual Node* getVirtualRenderer() override;
     virtual std::string getDescription() const override;
+    virtual void visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual void setTouchEnabled(bool enabled) override;
 
+	/**
+	 * Add a child whose visibility is bound to the button states.
+	 * The child is visible only in the given states, a child without states keeps its visibility.
+	 */
 	void addButtonChild(cocos2d::Node* child);
 	void addButtonChild(cocos2d::Node* child, ButtonState);
+	void addButtonChild(cocos2d::Node* child, std::initializer_list<ButtonState> states);
+	void addButtonChild(cocos2d::Node* child, StateMask states);
 	void removeButtonChild(cocos2d::Node* child);
 
+	virtual void removeChild(cocos2d::Node* child, bool cleanup = true) override;
+	virtual void removeAllChildrenWithCleanup(bool cleanup) override;
+
     /** @brief When user pushed the button, the button will zoom to a scale.
      * The final scale of the button  equals (button original scale + _zoomScale)
      * @since v3.3
@@ -195,14 +299,14 @@ public:
      * @return the nine-patch sprite of pushed state
      * @since v3.9
      */
-	cocos2d::ui::Scale9Sprite* getRendererPushed() const { return _buttonPushedRenderer; }
+	cocos2d::ui::Scale9Sprite* getRendererPushed() const { return _singleRenderer ? _buttonIdleRenderer : _buttonPushedRenderer; }
     
     /**
      * @brief Return the nine-patch sprite of dragout state
      * @return the nine-patch sprite of dragout state
      * @since v3.9
      */
-	cocos2d::ui::Scale9Sprite* getRendererDragout() const { return _buttonDragoutRenderer; }
+	cocos2d::ui::Scale9Sprite* getRendererDragout() const { return _singleRenderer ? _buttonIdleRenderer : _buttonDragoutRenderer; }
 
     void resetIdleRender();
     void resetPushedRender();
@@ -229,11 +333,44 @@ public:
 	};
 	void setTouchEndedCallback(const TouchEndedCallback&);
 
+	/**
+	 * Name of the touch ended event, the listener ID of its listeners.
+	 */
+	static const std::string& getTouchEndedEventName();
+
+	/**
+	 * Create a listener of the touch ended event.
+	 * @param callback called with the event, its user data is a `TouchEndedCallbackData`.
+	 * @param sender only the events of this button are passed to the callback, nullptr passes all.
+	 * @return an EventListenerCustom instance.
+	 */
+	static cocos2d::EventListenerCustom* createTouchEndedListener(const TouchEndedCallback& callback,
+																  MyButton* sender = nullptr);
+
+	/**
+	 * Dispatch the touch ended event through the event dispatcher as well as to the callback.
+	 * The event goes through a custom event channel of the dispatcher, so a release doesn't build one.
+	 */
+	void setTouchEndedDispatchEnabled(bool enabled);
+	bool isTouchEndedDispatchEnabled() const;
+
+	/**
+	 * Long push timeout in seconds, zero disables the long push.
+	 * The timer is armed only while the button is pushed, idle buttons are not scheduled at all.
+	 */
 	float getPushedTimeout();
 	void setPushedTimeout(float);
 
+	/**
+	 * Multi-touch policy, `MultiTouchPolicy::ANY_HELD` by default.
+	 * A long push ends the press of all the touches.
+	 */
+	void setMultiTouchPolicy(MultiTouchPolicy policy);
+	MultiTouchPolicy getMultiTouchPolicy() const;
+
 CC_CONSTRUCTOR_ACCESS:
     virtual bool init() override;
+    virtual bool init(MyButtonStyle* style);
     virtual bool init(const std::string& idleImage,
                       const std::string& selectedImage = "",
                       const std::string& disableImage = "",
@@ -244,7 +381,7 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     virtual void initRenderer() override;
     virtual void onSizeChanged() override;
-	virtual void update(float dt) override;
+	virtual void onExit() override;
 
     void loadTextureIdle(cocos2d::SpriteFrame* idleSpriteFrame);
     void setupIdleTexture(bool textureLoaded);
@@ -275,6 +412,16 @@ protected:
 protected:
 	ButtonState _buttonState;
 
+	// touches on the button in arrival order, a fixed array keeps the single touch path cheap
+	struct TouchInfo
+	{
+		int id;
+		ButtonState state;
+	};
+	TouchInfo _touches[MAX_TOUCHES];
+	int _touchCount;
+	MultiTouchPolicy _multiTouchPolicy;
+
 	cocos2d::ui::Scale9Sprite* _buttonIdleRenderer;
 	cocos2d::ui::Scale9Sprite* _buttonPushedRenderer;
 	cocos2d::ui::Scale9Sprite* _buttonDragoutRenderer;
@@ -282,22 +429,16 @@ protected:
 	struct ChildInfo
 	{
 		cocos2d::Node* node;
-		ButtonState state;
-		bool state_any;
+		StateMask states;
 	};
-	std::list<ChildInfo> _childNodes;
+	std::vector<ChildInfo> _childNodes;
+	std::unordered_map<cocos2d::Node*, size_t> _childSlots;
 
     float _zoomScale;
     bool _prevIgnoreSize;
     bool _scale9Enabled;
 
-    cocos2d::Rect _capInsetsIdle;
-	cocos2d::Rect _capInsetsPushed;
-	cocos2d::Rect _capInsetsDragout;
-
-	cocos2d::Size _idleTextureSize;
-	cocos2d::Size _pushedTextureSize;
-	cocos2d::Size _dragoutTextureSize;
+    MyButtonStyle* _style;
 
     bool _idleTextureLoaded;
     bool _pushedTextureLoaded;
@@ -306,25 +447,71 @@ protected:
     bool _pushedTextureAdaptDirty;
     bool _dragoutTextureAdaptDirty;
 
-    std::string _idleFileName;
-    std::string _pushedFileName;
-    std::string _dragoutFileName;
-    TextureResType _idleTexType;
-    TextureResType _pushedTexType;
-    TextureResType _dragoutTexType;
-
 	cocos2d::Size _expandZone;
 	cocos2d::Size _safeZone;
 
 	TouchEndedCallback _touchEndedCallback;
+
+	// built once, a release only refills the data
+	class TouchEndedEvent : public cocos2d::EventCustom
+	{
+	public:
+		TouchEndedEvent();
+		void reset();
+		TouchEndedCallbackData data;
+	};
+	TouchEndedEvent _touchEndedEvent;
+	cocos2d::EventChannel _touchEndedChannel;
+	bool _touchEndedDispatch;
 	float _pushedTimeout;
-	float _pushedTime;
+
+	MyButtonGroup* _group;
+	int _groupSlot;
+
+	// hit test cache, the inverse transform lives while the node to world transform is the same,
+	// the projected touch point lives for one touch event
+	mutable cocos2d::Mat4 _nodeToWorldCache;
+	mutable cocos2d::Mat4 _worldToNodeCache;
+	mutable const cocos2d::Camera* _touchCacheCamera;
+	mutable cocos2d::Vec2 _touchCacheScreenPoint;
+	mutable cocos2d::Vec3 _touchCacheNodePoint;
+	mutable bool _touchCacheProjected;
+	mutable bool _touchCacheValid;
+
+	// single renderer mode, the idle renderer shows the frame of the current state
+	bool _singleRenderer;
+	cocos2d::SpriteFrame* _displayedSpriteFrame;
+
+	// asynchronous texture loading, the texture cache callbacks are bound to _asyncKey
+	std::string _asyncKey;
+	std::string _asyncFiles[3];
+	int _asyncPending;
 
 private:
+	friend class MyButtonGroup;
+
 	cocos2d::Rect _makeZoneRect(const cocos2d::Size&) const;
-	void _refreshButtonState(const cocos2d::Vec2*);
+	bool _projectTouch(const cocos2d::Vec2&, const cocos2d::Camera*, cocos2d::Vec3*) const;
+	static bool _zoneContains(const cocos2d::Rect&, const cocos2d::Vec3&);
+	ButtonState _classifyTouch(const cocos2d::Vec2&) const;
+	int _findTouch(int id) const;
+	bool _isDrivingTouch(int index) const;
+	void _removeTouch(int index);
+	void _releaseAllTouches();
+	void _refreshButtonState();
 	void _generateEvent(ButtonState, bool is_long);
-	void _updateChildren();
+	void _armLongPush();
+	void _cancelLongPush();
+	void _onLongPush(float);
+	void _updateChildren(ButtonState oldState);
+	void _updateRenderers();
+	void _createStateRenderers();
+	MyButtonStyle* _ownStyle();
+	void _applyIdleStyle();
+	void _applyPushedStyle();
+	void _applyDragoutStyle();
+	void _onTextureAsync(cocos2d::Texture2D*);
+	void _cancelTexturesAsync();
 };
 
 #endif
@@ -0,0 +1,306 @@
+/****************************************************************************
+Copyright (c) 2020 Anton Kulikov
+****************************************************************************/
+
+#include <cmath>
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "MyButtonGroup.h"
+#include "MyButton.h"
+
+
+MyButtonGroup::MyButtonGroup():
+_touchListener(nullptr),
+_cellSize(128.0f)
+{
+}
+
+MyButtonGroup::~MyButtonGroup()
+{
+	_eventDispatcher->removeEventListener(_touchListener);
+	CC_SAFE_RELEASE_NULL(_touchListener);
+
+	for (auto& touch : _activeTouches)
+		touch.second->release();
+	for (auto& entry : _entries)
+	{
+		entry.button->_group = nullptr;
+		entry.button->_groupSlot = -1;
+		_restoreTouchListener(entry);
+	}
+}
+
+MyButtonGroup* MyButtonGroup::create(float cellSize)
+{
+	MyButtonGroup* group = new (std::nothrow) MyButtonGroup();
+	if (group && group->init(cellSize))
+	{
+		group->autorelease();
+		return group;
+	}
+	CC_SAFE_DELETE(group);
+	return nullptr;
+}
+
+bool MyButtonGroup::init(float cellSize)
+{
+	if (!Node::init())
+		return false;
+
+	_cellSize = cellSize > 0.0f ? cellSize : 128.0f;
+
+	_touchListener = cocos2d::EventListenerTouchOneByOne::create();
+	CC_SAFE_RETAIN(_touchListener);
+	_touchListener->setSwallowTouches(true);
+	_touchListener->onTouchBegan = CC_CALLBACK_2(MyButtonGroup::onTouchBegan, this);
+	_touchListener->onTouchMoved = CC_CALLBACK_2(MyButtonGroup::onTouchMoved, this);
+	_touchListener->onTouchEnded = CC_CALLBACK_2(MyButtonGroup::onTouchEnded, this);
+	_touchListener->onTouchCancelled = CC_CALLBACK_2(MyButtonGroup::onTouchCancelled, this);
+	_eventDispatcher->addEventListenerWithSceneGraphPriority(_touchListener, this);
+	return true;
+}
+
+void MyButtonGroup::addButton(MyButton* button)
+{
+	addButton(button, button->getLocalZOrder());
+}
+
+void MyButtonGroup::addButton(MyButton* button, int localZOrder)
+{
+	CCASSERT(button->_group == nullptr, "button already belongs to a group");
+
+	ButtonEntry entry;
+	entry.button = button;
+	entry.cellX0 = entry.cellY0 = entry.cellX1 = entry.cellY1 = 0;
+	entry.indexed = false;
+	entry.dirty = false;
+	entry.touchEnabled = button->isTouchEnabled();
+
+	// the group dispatches touches for the button from now on, the button keeps only the flag
+	button->setTouchEnabled(false);
+	button->_touchEnabled = entry.touchEnabled;
+	button->_group = this;
+	button->_groupSlot = static_cast<int>(_entries.size());
+	_entries.push_back(entry);
+	addChild(button, localZOrder);
+	_invalidateButton(button);
+}
+
+void MyButtonGroup::removeButton(MyButton* button, bool cleanup)
+{
+	if (button->_group != this)
+		return;
+	removeChild(button, cleanup);
+}
+
+size_t MyButtonGroup::getButtonCount() const
+{
+	return _entries.size();
+}
+
+float MyButtonGroup::getCellSize() const
+{
+	return _cellSize;
+}
+
+void MyButtonGroup::removeChild(cocos2d::Node* child, bool cleanup)
+{
+	auto button = dynamic_cast<MyButton*>(child);
+	if (button && button->_group == this)
+		_unregisterButton(button);
+	Node::removeChild(child, cleanup);
+}
+
+void MyButtonGroup::removeAllChildrenWithCleanup(bool cleanup)
+{
+	while (!_entries.empty())
+		_unregisterButton(_entries.back().button);
+	Node::removeAllChildrenWithCleanup(cleanup);
+}
+
+bool MyButtonGroup::onTouchBegan(cocos2d::Touch *touch, cocos2d::Event *event)
+{
+	_refreshIndex();
+
+	auto location = touch->getLocation();
+	auto cell = _cells.find(_cellKey(_cellCoord(location.x), _cellCoord(location.y)));
+	if (cell == _cells.end())
+		return false;
+
+	// topmost button first, the same order the scene graph listeners would get:
+	// the buttons are siblings, so their ancestor paths differ only in their own local Z order and arrival
+	_candidates.assign(cell->second.begin(), cell->second.end());
+	std::sort(_candidates.begin(), _candidates.end(), [](MyButton* a, MyButton* b)
+	{
+		if (a->getGlobalZOrder() != b->getGlobalZOrder())
+			return a->getGlobalZOrder() > b->getGlobalZOrder();
+		return a->_localZOrder$Arrival > b->_localZOrder$Arrival;
+	});
+
+	// a button tracks several touches itself and refuses a touch beyond its capacity
+	for (auto button : _candidates)
+	{
+		if (!_entries[button->_groupSlot].touchEnabled)
+			continue;
+		if (button->onTouchBegan(touch, event))
+		{
+			button->retain();
+			_activeTouches.push_back(std::make_pair(touch->getID(), button));
+			return true;
+		}
+	}
+	return false;
+}
+
+void MyButtonGroup::onTouchMoved(cocos2d::Touch *touch, cocos2d::Event *event)
+{
+	int i = _findActiveTouch(touch->getID());
+	if (i < 0)
+		return;
+	_activeTouches[i].second->onTouchMoved(touch, event);
+}
+
+void MyButtonGroup::onTouchEnded(cocos2d::Touch *touch, cocos2d::Event *event)
+{
+	int i = _findActiveTouch(touch->getID());
+	if (i < 0)
+		return;
+	// the callback may remove the button, keep it alive until it returns
+	auto button = _activeTouches[i].second;
+	_activeTouches.erase(_activeTouches.begin() + i);
+	button->onTouchEnded(touch, event);
+	button->release();
+}
+
+void MyButtonGroup::onTouchCancelled(cocos2d::Touch *touch, cocos2d::Event *event)
+{
+	int i = _findActiveTouch(touch->getID());
+	if (i < 0)
+		return;
+	auto button = _activeTouches[i].second;
+	_activeTouches.erase(_activeTouches.begin() + i);
+	button->onTouchCancelled(touch, event);
+	button->release();
+}
+
+void MyButtonGroup::_invalidateButton(MyButton* button)
+{
+	auto& entry = _entries[button->_groupSlot];
+	if (entry.dirty)
+		return;
+	entry.dirty = true;
+	_dirtyButtons.push_back(button);
+}
+
+void MyButtonGroup::_unregisterButton(MyButton* button)
+{
+	int slot = button->_groupSlot;
+	auto entry = _entries[slot];
+	if (entry.indexed)
+		_removeFromCells(entry);
+	if (entry.dirty)
+		_dirtyButtons.erase(std::find(_dirtyButtons.begin(), _dirtyButtons.end(), button));
+
+	for (auto i = _activeTouches.begin(); i != _activeTouches.end();)
+	{
+		if (i->second != button)
+		{
+			++i;
+			continue;
+		}
+		i = _activeTouches.erase(i);
+		button->release();
+	}
+
+	// swap-remove keeps the slots of the other buttons dense
+	if (slot != static_cast<int>(_entries.size()) - 1)
+	{
+		_entries[slot] = _entries.back();
+		_entries[slot].button->_groupSlot = slot;
+	}
+	_entries.pop_back();
+
+	button->_group = nullptr;
+	button->_groupSlot = -1;
+	_restoreTouchListener(entry);
+}
+
+void MyButtonGroup::_restoreTouchListener(const ButtonEntry& entry)
+{
+	// the button had no listener while in the group
+	entry.button->_touchEnabled = false;
+	entry.button->setTouchEnabled(entry.touchEnabled);
+}
+
+void MyButtonGroup::_refreshIndex()
+{
+	for (auto button : _dirtyButtons)
+	{
+		auto& entry = _entries[button->_groupSlot];
+		if (entry.indexed)
+			_removeFromCells(entry);
+
+		auto bounds = cocos2d::RectApplyAffineTransform(
+			button->getSafeZoneRect(), button->getNodeToWorldAffineTransform());
+		entry.cellX0 = _cellCoord(bounds.getMinX());
+		entry.cellY0 = _cellCoord(bounds.getMinY());
+		entry.cellX1 = _cellCoord(bounds.getMaxX());
+		entry.cellY1 = _cellCoord(bounds.getMaxY());
+		_insertToCells(entry);
+		entry.dirty = false;
+	}
+	_dirtyButtons.clear();
+}
+
+void MyButtonGroup::_insertToCells(ButtonEntry& entry)
+{
+	for (int y = entry.cellY0; y <= entry.cellY1; ++y)
+	{
+		for (int x = entry.cellX0; x <= entry.cellX1; ++x)
+			_cells[_cellKey(x, y)].push_back(entry.button);
+	}
+	entry.indexed = true;
+}
+
+void MyButtonGroup::_removeFromCells(ButtonEntry& entry)
+{
+	for (int y = entry.cellY0; y <= entry.cellY1; ++y)
+	{
+		for (int x = entry.cellX0; x <= entry.cellX1; ++x)
+		{
+			auto cell = _cells.find(_cellKey(x, y));
+			if (cell == _cells.end())
+				continue;
+			auto& buttons = cell->second;
+			auto i = std::find(buttons.begin(), buttons.end(), entry.button);
+			if (i != buttons.end())
+			{
+				*i = buttons.back();
+				buttons.pop_back();
+			}
+			if (buttons.empty())
+				_cells.erase(cell);
+		}
+	}
+	entry.indexed = false;
+}
+
+int MyButtonGroup::_cellCoord(float v) const
+{
+	return static_cast<int>(std::floor(v / _cellSize));
+}
+
+int MyButtonGroup::_findActiveTouch(int id) const
+{
+	for (size_t i = 0; i < _activeTouches.size(); ++i)
+	{
+		if (_activeTouches[i].first == id)
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+int64_t MyButtonGroup::_cellKey(int x, int y)
+{
+	return (static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(y);
+}
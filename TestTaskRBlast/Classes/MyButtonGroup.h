@@ -0,0 +1,96 @@
+/****************************************************************************
+Copyright (c) 2020 Anton Kulikov
+****************************************************************************/
+
+#ifndef __MYBUTTONGROUP_H__
+#define __MYBUTTONGROUP_H__
+
+#include <unordered_map>
+#include <vector>
+#include "2d/CCNode.h"
+#include "base/CCEventListenerTouch.h"
+
+class MyButton;
+
+/**
+ * Touch router for large button populations.
+ *
+ * The group owns a single touch listener instead of one listener per button
+ * and keeps a uniform grid of the world-space safe zone bounds of its buttons.
+ * A touch is tested only against the buttons whose cells contain the touch point,
+ * the exact hit test is still done by the button itself.
+ *
+ * Buttons are added with `addButton` and become direct children of the group.
+ * Their own touch listeners are removed while they belong to the group,
+ * `setTouchEnabled` then only tells the group whether to route touches to the button.
+ * The grid works in world space, so the group is intended for the default 2D camera.
+ */
+class MyButtonGroup : public cocos2d::Node
+{
+public:
+	/**
+	 * Create a button group.
+	 * @param cellSize grid cell size in world points.
+	 * @return a MyButtonGroup instance.
+	 */
+	static MyButtonGroup* create(float cellSize = 128.0f);
+
+	void addButton(MyButton* button);
+	void addButton(MyButton* button, int localZOrder);
+	void removeButton(MyButton* button, bool cleanup = true);
+
+	size_t getButtonCount() const;
+	float getCellSize() const;
+
+	//override methods
+	virtual void removeChild(cocos2d::Node* child, bool cleanup = true) override;
+	virtual void removeAllChildrenWithCleanup(bool cleanup) override;
+
+CC_CONSTRUCTOR_ACCESS:
+	MyButtonGroup();
+	virtual ~MyButtonGroup();
+
+	virtual bool init(float cellSize);
+
+protected:
+	bool onTouchBegan(cocos2d::Touch *touch, cocos2d::Event *event);
+	void onTouchMoved(cocos2d::Touch *touch, cocos2d::Event *event);
+	void onTouchEnded(cocos2d::Touch *touch, cocos2d::Event *event);
+	void onTouchCancelled(cocos2d::Touch *touch, cocos2d::Event *event);
+
+protected:
+	struct ButtonEntry
+	{
+		MyButton* button;
+		int cellX0;
+		int cellY0;
+		int cellX1;
+		int cellY1;
+		bool indexed;
+		bool dirty;
+		bool touchEnabled;
+	};
+	std::vector<ButtonEntry> _entries;
+	std::vector<MyButton*> _dirtyButtons;
+	std::unordered_map<int64_t, std::vector<MyButton*>> _cells;
+	std::vector<MyButton*> _candidates;
+	std::vector<std::pair<int, MyButton*>> _activeTouches;
+
+	cocos2d::EventListenerTouchOneByOne* _touchListener;
+	float _cellSize;
+
+private:
+	friend class MyButton;
+
+	void _invalidateButton(MyButton*);
+	void _unregisterButton(MyButton*);
+	void _restoreTouchListener(const ButtonEntry&);
+	void _refreshIndex();
+	void _insertToCells(ButtonEntry&);
+	void _removeFromCells(ButtonEntry&);
+	int _cellCoord(float) const;
+	int _findActiveTouch(int id) const;
+	static int64_t _cellKey(int x, int y);
+};
+
+#endif
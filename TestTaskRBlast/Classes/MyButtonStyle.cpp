@@ -0,0 +1,132 @@
+/****************************************************************************
+Copyright (c) 2020 Anton Kulikov
+****************************************************************************/
+
+#include "base/CCDirector.h"
+#include "2d/CCSpriteFrameCache.h"
+#include "renderer/CCTextureCache.h"
+#include "ui/UIHelper.h"
+#include "MyButtonStyle.h"
+
+
+MyButtonStyle::MyButtonStyle()
+{
+	for (auto state : { &_idle, &_pushed, &_dragout })
+	{
+		state->texType = TextureResType::LOCAL;
+		state->spriteFrame = nullptr;
+		state->capInsets = cocos2d::Rect::ZERO;
+		state->textureSize = cocos2d::Size::ZERO;
+	}
+}
+
+MyButtonStyle::~MyButtonStyle()
+{
+	CC_SAFE_RELEASE(_idle.spriteFrame);
+	CC_SAFE_RELEASE(_pushed.spriteFrame);
+	CC_SAFE_RELEASE(_dragout.spriteFrame);
+}
+
+MyButtonStyle* MyButtonStyle::create(const std::string& idleImage,
+									 const std::string& pushedImage,
+									 const std::string& dragoutImage,
+									 TextureResType texType,
+									 const cocos2d::Rect& capInsets)
+{
+	MyButtonStyle* style = new (std::nothrow) MyButtonStyle();
+	if (!style)
+		return nullptr;
+	setStateTexture(style->_idle, idleImage, texType);
+	setStateTexture(style->_pushed, pushedImage, texType);
+	setStateTexture(style->_dragout, dragoutImage, texType);
+	setStateCapInsets(style->_idle, capInsets);
+	setStateCapInsets(style->_pushed, capInsets);
+	setStateCapInsets(style->_dragout, capInsets);
+	style->autorelease();
+	return style;
+}
+
+MyButtonStyle* MyButtonStyle::createWithSpriteFrames(cocos2d::SpriteFrame* idle,
+													 cocos2d::SpriteFrame* pushed,
+													 cocos2d::SpriteFrame* dragout,
+													 const cocos2d::Rect& capInsets)
+{
+	MyButtonStyle* style = new (std::nothrow) MyButtonStyle();
+	if (!style)
+		return nullptr;
+	setStateSpriteFrame(style->_idle, idle);
+	setStateSpriteFrame(style->_pushed, pushed);
+	setStateSpriteFrame(style->_dragout, dragout);
+	setStateCapInsets(style->_idle, capInsets);
+	setStateCapInsets(style->_pushed, capInsets);
+	setStateCapInsets(style->_dragout, capInsets);
+	style->autorelease();
+	return style;
+}
+
+MyButtonStyle* MyButtonStyle::getEmpty()
+{
+	// never released, like the other engine singletons
+	static MyButtonStyle* s_empty = new (std::nothrow) MyButtonStyle();
+	return s_empty;
+}
+
+MyButtonStyle* MyButtonStyle::clone() const
+{
+	MyButtonStyle* style = new (std::nothrow) MyButtonStyle();
+	if (!style)
+		return nullptr;
+	copyState(style->_idle, _idle);
+	copyState(style->_pushed, _pushed);
+	copyState(style->_dragout, _dragout);
+	return style;
+}
+
+cocos2d::SpriteFrame* MyButtonStyle::makeSpriteFrame(const std::string& name, TextureResType texType)
+{
+	if (name.empty())
+		return nullptr;
+	switch (texType)
+	{
+	case TextureResType::LOCAL:
+	{
+		auto texture = cocos2d::Director::getInstance()->getTextureCache()->addImage(name);
+		if (!texture)
+			return nullptr;
+		cocos2d::Rect rect;
+		rect.size = texture->getContentSize();
+		return cocos2d::SpriteFrame::createWithTexture(texture, rect);
+	}
+	case TextureResType::PLIST:
+		return cocos2d::SpriteFrameCache::getInstance()->getSpriteFrameByName(name);
+	default:
+		return nullptr;
+	}
+}
+
+void MyButtonStyle::setStateTexture(StateStyle& state, const std::string& name, TextureResType texType)
+{
+	state.fileName = name;
+	state.texType = texType;
+	setStateSpriteFrame(state, makeSpriteFrame(name, texType));
+}
+
+void MyButtonStyle::setStateSpriteFrame(StateStyle& state, cocos2d::SpriteFrame* spriteFrame)
+{
+	CC_SAFE_RETAIN(spriteFrame);
+	CC_SAFE_RELEASE(state.spriteFrame);
+	state.spriteFrame = spriteFrame;
+	state.textureSize = spriteFrame ? spriteFrame->getOriginalSize() : cocos2d::Size::ZERO;
+}
+
+void MyButtonStyle::setStateCapInsets(StateStyle& state, const cocos2d::Rect& capInsets)
+{
+	state.capInsets = cocos2d::ui::Helper::restrictCapInsetRect(capInsets, state.textureSize);
+}
+
+void MyButtonStyle::copyState(StateStyle& state, const StateStyle& other)
+{
+	CC_SAFE_RETAIN(other.spriteFrame);
+	CC_SAFE_RELEASE(state.spriteFrame);
+	state = other;
+}
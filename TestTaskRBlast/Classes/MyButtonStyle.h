@@ -0,0 +1,91 @@
+/****************************************************************************
+Copyright (c) 2020 Anton Kulikov
+****************************************************************************/
+
+#ifndef __MYBUTTONSTYLE_H__
+#define __MYBUTTONSTYLE_H__
+
+#include <string>
+#include "base/CCRef.h"
+#include "2d/CCSpriteFrame.h"
+#include "ui/UIWidget.h"
+
+class MyButton;
+
+/**
+ * Immutable, reference counted look of a MyButton.
+ *
+ * A style keeps the sprite frame, the source file name, the cap insets and the
+ * texture size of every button state. It is built once and shared by any number
+ * of buttons, a button copies its style only when one of its own setters
+ * overrides a value while the style is shared.
+ */
+class MyButtonStyle : public cocos2d::Ref
+{
+public:
+	typedef cocos2d::ui::Widget::TextureResType TextureResType;
+
+	struct StateStyle
+	{
+		std::string fileName;
+		TextureResType texType;
+		cocos2d::SpriteFrame* spriteFrame;
+		cocos2d::Rect capInsets;
+		cocos2d::Size textureSize;
+	};
+
+	/**
+	 * Create a style from textures or sprite frame names.
+	 * @param idleImage idle state texture name.
+	 * @param pushedImage pushed state texture name.
+	 * @param dragoutImage dragout state texture name.
+	 * @param texType    @see `TextureResType`
+	 * @param capInsets cap insets of all states.
+	 * @return a MyButtonStyle instance.
+	 */
+	static MyButtonStyle* create(const std::string& idleImage,
+								 const std::string& pushedImage = "",
+								 const std::string& dragoutImage = "",
+								 TextureResType texType = TextureResType::LOCAL,
+								 const cocos2d::Rect& capInsets = cocos2d::Rect::ZERO);
+
+	/**
+	 * Create a style from sprite frames.
+	 * @return a MyButtonStyle instance.
+	 */
+	static MyButtonStyle* createWithSpriteFrames(cocos2d::SpriteFrame* idle,
+												 cocos2d::SpriteFrame* pushed = nullptr,
+												 cocos2d::SpriteFrame* dragout = nullptr,
+												 const cocos2d::Rect& capInsets = cocos2d::Rect::ZERO);
+
+	/**
+	 * The shared style without textures, used by buttons without a style.
+	 */
+	static MyButtonStyle* getEmpty();
+
+	const StateStyle& getIdle() const { return _idle; }
+	const StateStyle& getPushed() const { return _pushed; }
+	const StateStyle& getDragout() const { return _dragout; }
+
+CC_CONSTRUCTOR_ACCESS:
+	MyButtonStyle();
+	virtual ~MyButtonStyle();
+
+private:
+	// only a button owning the single reference may change a style
+	friend class MyButton;
+
+	MyButtonStyle* clone() const;
+
+	static cocos2d::SpriteFrame* makeSpriteFrame(const std::string& name, TextureResType texType);
+	static void setStateTexture(StateStyle& state, const std::string& name, TextureResType texType);
+	static void setStateSpriteFrame(StateStyle& state, cocos2d::SpriteFrame* spriteFrame);
+	static void setStateCapInsets(StateStyle& state, const cocos2d::Rect& capInsets);
+	static void copyState(StateStyle& state, const StateStyle& other);
+
+	StateStyle _idle;
+	StateStyle _pushed;
+	StateStyle _dragout;
+};
+
+#endif
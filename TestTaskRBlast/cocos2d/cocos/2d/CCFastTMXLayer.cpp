@@ -35,6 +35,7 @@ THE SOFTWARE.
  It was rewritten again, and only a small part of the original HK ideas/code remains in this implementation
 
  */
+#include <typeinfo>
 #include "2d/CCFastTMXLayer.h"
 #include "2d/CCFastTMXTiledMap.h"
 #include "2d/CCSprite.h"
@@ -454,6 +455,7 @@ void TMXLayer::updateTotalQuads()
         _indicesVertexZOffsets.clear();
         
         int quadIndex = 0;
+        float minX = 0, minY = 0, maxX = 0, maxY = 0;
         for(int y = 0; y < _layerSize.height; ++y)
         {
             for(int x =0; x < _layerSize.width; ++x)
@@ -498,6 +500,18 @@ void TMXLayer::updateTotalQuads()
                     top = nodePos.y;
                 }
                 
+                if (quadIndex == 0)
+                {
+                    minX = left;
+                    minY = top;
+                    maxX = right;
+                    maxY = bottom;
+                }
+                minX = std::min(minX, left);
+                minY = std::min(minY, top);
+                maxX = std::max(maxX, right);
+                maxY = std::max(maxY, bottom);
+
                 if(tileGID & kTMXTileVerticalFlag)
                     std::swap(top, bottom);
                 if(tileGID & kTMXTileHorizontalFlag)
@@ -569,6 +583,8 @@ void TMXLayer::updateTotalQuads()
         updateVertexBuffer();
         
         _quadsDirty = false;
+        _quadsBounds.setRect(minX, minY, maxX - minX, maxY - minY);
+        setBoundsDirty();
     }
 }
 
@@ -704,6 +720,7 @@ void TMXLayer::setFlaggedTileGIDByIndex(int index, uint32_t gid)
     _tiles[index] = gid;
     _quadsDirty = true;
     _dirty = true;
+    setBoundsDirty();
 }
 
 void TMXLayer::removeChild(Node* node, bool cleanup)
@@ -895,6 +912,13 @@ std::string TMXLayer::getDescription() const
     return StringUtils::format("<FastTMXLayer | tag = %d, size = %d,%d>", _tag, (int)_mapTileSize.width, (int)_mapTileSize.height);
 }
 
+bool TMXLayer::getDrawBounds(Rect& bounds) const
+{
+    // the quads are built by draw(), the culling is in 2D and a vertex Z moves the tiles on screen
+    bounds = _quadsBounds;
+    return typeid(*this) == typeid(TMXLayer) && !_quadsDirty && !_useAutomaticVertexZ && _vertexZvalue == 0;
+}
+
 } //end of namespace experimental
 
 NS_CC_END
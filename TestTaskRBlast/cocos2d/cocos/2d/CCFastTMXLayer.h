@@ -195,7 +195,7 @@ public:
      *
      * @param tiles The pointer to the map of tiles.
      */
-    void setTiles(uint32_t* tiles) { _tiles = tiles; _quadsDirty = true;};
+    void setTiles(uint32_t* tiles) { _tiles = tiles; _quadsDirty = true; setBoundsDirty(); };
     
     /** Tileset information for the layer.
      *
@@ -269,6 +269,7 @@ public:
     //
     virtual std::string getDescription() const override;
     virtual void draw(Renderer *renderer, const Mat4& transform, uint32_t flags) override;
+    virtual bool getDrawBounds(Rect& bounds) const override;
     void removeChild(Node* child, bool cleanup = true) override;
 
 protected:
@@ -333,6 +334,7 @@ protected:
     Mat4 _tileToNodeTransform;
     /** data for rendering */
     bool _quadsDirty;
+    Rect _quadsBounds;
     std::vector<int> _tileToQuadIndex;
     std::vector<V3F_C4B_T2F_Quad> _totalQuads;
 #ifdef CC_FAST_TILEMAP_32_BIT_INDICES
@@ -204,6 +204,7 @@ public:
     }
 
     virtual std::string getDescription() const override;
+    virtual bool getDrawBounds(Rect& bounds) const override;
 
 protected:
     /**
@@ -616,6 +616,7 @@ void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false *
     {
         _lineHeight = _fontAtlas->getLineHeight();
         _contentDirty = true;
+        setStaticDirty();
         _systemFontDirty = false;
     }
     _useDistanceField = distanceFieldEnabled;
@@ -671,6 +672,7 @@ void Label::setString(const std::string& text)
     {
         _utf8Text = text;
         _contentDirty = true;
+        setStaticDirty();
 
         std::u32string utf32String;
         if (StringUtils::UTF8ToUTF32(_utf8Text, utf32String))
@@ -695,6 +697,7 @@ void Label::setAlignment(TextHAlignment hAlignment,TextVAlignment vAlignment)
         _vAlignment = vAlignment;
 
         _contentDirty = true;
+        setStaticDirty();
     }
 }
 
@@ -704,6 +707,7 @@ void Label::setMaxLineWidth(float maxLineWidth)
     {
         _maxLineWidth = maxLineWidth;
         _contentDirty = true;
+        setStaticDirty();
     }
 }
 
@@ -721,6 +725,7 @@ void Label::setDimensions(float width, float height)
 
         _maxLineWidth = width;
         _contentDirty = true;
+        setStaticDirty();
 
         if(_overflow == Overflow::SHRINK){
             if (_originalFontSize > 0) {
@@ -749,6 +754,7 @@ void Label::setLineBreakWithoutSpace(bool breakWithoutSpace)
     {
         _lineBreakWithoutSpaces = breakWithoutSpace;
         _contentDirty = true;     
+        setStaticDirty();
     }
 }
 
@@ -1034,6 +1040,7 @@ void Label::setBMFontSizeInternal(float fontSize)
     if(_currentLabelType == LabelType::BMFONT){
         this->setBMFontFilePath(_bmFontPath, Vec2::ZERO, fontSize);
         _contentDirty = true;
+        setStaticDirty();
     }
 }
 
@@ -1070,6 +1077,7 @@ void Label::enableGlow(const Color4B& glowColor)
             config.distanceFieldEnabled = true;
             setTTFConfig(config);
             _contentDirty = true;
+            setStaticDirty();
         }
         _currLabelEffect = LabelEffect::GLOW;
         _effectColorF.r = glowColor.r / 255.0f;
@@ -1107,6 +1115,7 @@ void Label::enableOutline(const Color4B& outlineColor,int outlineSize /* = -1 */
             _effectColorF.a = outlineColor.a / 255.f;
             _currLabelEffect = LabelEffect::OUTLINE;
             _contentDirty = true;
+            setStaticDirty();
         }
         _outlineSize = outlineSize;
     }
@@ -1186,6 +1195,7 @@ void Label::enableUnderline()
         _underlineNode = DrawNode::create();
         addChild(_underlineNode, 100000);
         _contentDirty = true;
+        setStaticDirty();
     }
 }
 
@@ -1219,6 +1229,7 @@ void Label::disableEffect(LabelEffect effect)
                 }
                 _currLabelEffect = LabelEffect::NORMAL;
                 _contentDirty = true;
+                setStaticDirty();
             }
             break;
         case cocos2d::LabelEffect::SHADOW:
@@ -1642,6 +1653,12 @@ void Label::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     }
 }
 
+bool Label::isStaticCacheable() const
+{
+    // the setters of the text, the font and the effects mark the node static dirty, a subclass may draw more
+    return typeid(*this) == typeid(Label);
+}
+
 void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
     if (! _visible || (_utf8Text.empty() && _children.empty()) )
@@ -1826,6 +1843,7 @@ void Label::setLineHeight(float height)
     {
         _lineHeight = height;
         _contentDirty = true;
+        setStaticDirty();
     }
 }
 
@@ -1841,6 +1859,7 @@ void Label::setLineSpacing(float height)
     {
         _lineSpacing = height;
         _contentDirty = true;
+        setStaticDirty();
     }
 }
 
@@ -1858,6 +1877,7 @@ void Label::setAdditionalKerning(float space)
         {
             _additionalKerning = space;
             _contentDirty = true;
+            setStaticDirty();
         }
     }
     else
@@ -1947,6 +1967,7 @@ void Label::updateDisplayedColor(const Color3B& parentColor)
         // Correct solution is to update the DrawNode directly since we know it is
         // a line. Returning a pointer to the line is an option
         _contentDirty = true;
+        setStaticDirty();
     }
 
     for (auto&& it : _letters)
@@ -1984,6 +2005,7 @@ void Label::setTextColor(const Color4B &color)
     if (_currentLabelType == LabelType::STRING_TEXTURE && _textColor != color)
     {
         _contentDirty = true;
+        setStaticDirty();
     }
 
     _textColor = color;
@@ -2174,6 +2196,7 @@ void Label::enableWrap(bool enable)
     this->rescaleWithOriginalFontSize();
     
     _contentDirty = true;
+    setStaticDirty();
 }
 
 bool Label::isWrapEnabled()const
@@ -2202,6 +2225,7 @@ void Label::setOverflow(Overflow overflow)
     this->rescaleWithOriginalFontSize();
     
     _contentDirty = true;
+    setStaticDirty();
 }
 
 void Label::rescaleWithOriginalFontSize()
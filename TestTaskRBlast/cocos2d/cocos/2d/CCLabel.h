@@ -601,6 +601,7 @@ public:
 
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
+    virtual bool isStaticCacheable() const override;
 
     virtual void setCameraMask(unsigned short mask, bool applyChildren = true) override;
 
@@ -27,6 +27,7 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include <stdarg.h>
+#include <typeinfo>
 #include "2d/CCLayer.h"
 #include "base/CCScriptSupport.h"
 #include "platform/CCDevice.h"
@@ -450,6 +451,13 @@ std::string Layer::getDescription() const
     return StringUtils::format("<Layer | Tag = %d>", _tag);
 }
 
+bool Layer::getDrawBounds(Rect& bounds) const
+{
+    // Layer draws nothing
+    bounds = Rect::ZERO;
+    return typeid(*this) == typeid(Layer);
+}
+
 __LayerRGBA::__LayerRGBA()
 {
     CCLOG("LayerRGBA deprecated.");
@@ -615,6 +623,12 @@ void LayerColor::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     }
 }
 
+bool LayerColor::getDrawBounds(Rect& bounds) const
+{
+    bounds.setRect(0, 0, _contentSize.width, _contentSize.height);
+    return typeid(*this) == typeid(LayerColor) || typeid(*this) == typeid(LayerGradient);
+}
+
 void LayerColor::onDraw(const Mat4& transform, uint32_t /*flags*/)
 {
     getGLProgram()->use();
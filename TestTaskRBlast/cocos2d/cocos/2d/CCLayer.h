@@ -247,6 +247,7 @@ public:
 
     // Overrides
     virtual std::string getDescription() const override;
+    virtual bool getDrawBounds(Rect& bounds) const override;
 
 CC_CONSTRUCTOR_ACCESS:
     Layer();
@@ -376,6 +377,7 @@ public:
     // Overrides
     //
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
+    virtual bool getDrawBounds(Rect& bounds) const override;
 
     virtual void setContentSize(const Size & var) override;
     /** BlendFunction. Conforms to BlendProtocol protocol */
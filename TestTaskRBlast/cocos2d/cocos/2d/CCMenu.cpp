@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "base/ccUTF8.h"
 #include "platform/CCStdC.h"
 
+#include <typeinfo>
 #include <vector>
 
 using namespace std;
@@ -589,4 +590,11 @@ std::string Menu::getDescription() const
     return StringUtils::format("<Menu | Tag = %d>", _tag);
 }
 
+bool Menu::getDrawBounds(Rect& bounds) const
+{
+    // Menu draws nothing, its items do
+    bounds = Rect::ZERO;
+    return typeid(*this) == typeid(Menu);
+}
+
 NS_CC_END
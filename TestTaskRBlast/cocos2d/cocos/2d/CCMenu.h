@@ -176,6 +176,7 @@ public:
     virtual bool isOpacityModifyRGB(void) const override;
 
     virtual std::string getDescription() const override;
+    virtual bool getDrawBounds(Rect& bounds) const override;
 
 CC_CONSTRUCTOR_ACCESS:
     /**
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "2d/CCLabel.h"
 #include "base/ccUTF8.h"
 #include <stdarg.h>
+#include <typeinfo>
 
 NS_CC_BEGIN
     
@@ -625,6 +626,13 @@ void MenuItemSprite::setEnabled(bool bEnabled)
     }
 }
 
+bool MenuItemSprite::getDrawBounds(Rect& bounds) const
+{
+    // the item draws nothing, its images do
+    bounds = Rect::ZERO;
+    return typeid(*this) == typeid(MenuItemSprite) || typeid(*this) == typeid(MenuItemImage);
+}
+
 // Helper 
 void MenuItemSprite::updateImagesVisibility()
 {
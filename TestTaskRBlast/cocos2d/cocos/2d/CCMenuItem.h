@@ -382,6 +382,8 @@ public:
 
     /** Enables or disables the item. */
     virtual void setEnabled(bool bEnabled);
+
+    virtual bool getDrawBounds(Rect& bounds) const override;
     
 CC_CONSTRUCTOR_ACCESS:
     MenuItemSprite()
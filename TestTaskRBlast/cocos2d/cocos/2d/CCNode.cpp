@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include <algorithm>
 #include <string>
 #include <regex>
+#include <typeinfo>
 
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
@@ -39,11 +40,14 @@ THE SOFTWARE.
 #include "base/ccUTF8.h"
 #include "2d/CCCamera.h"
 #include "2d/CCActionManager.h"
+#include "2d/CCTweenManager.h"
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
+#include "2d/CCParallelVisit.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCMaterial.h"
+#include "renderer/CCRenderer.h"
 #include "math/TransformUtils.h"
 
 
@@ -96,11 +100,19 @@ Node::Node()
 , _userData(nullptr)
 , _userObject(nullptr)
 , _glProgramState(nullptr)
+, _tweenManager(nullptr)
+, _runningTweens(0)
 , _running(false)
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
 , _isTransitionFinished(false)
+, _staticRoot(nullptr)
+, _isStaticRoot(false)
+, _staticDirty(false)
+, _hasSubtreeBounds(false)
+, _boundsDirty(true)
+, _skippedFlags(0)
 #if CC_ENABLE_SCRIPT_BINDING
 , _updateScriptHandler(0)
 #endif
@@ -124,6 +136,8 @@ Node::Node()
     _director = Director::getInstance();
     _actionManager = _director->getActionManager();
     _actionManager->retain();
+    _tweenManager = _director->getTweenManager();
+    _tweenManager->retain();
     _scheduler = _director->getScheduler();
     _scheduler->retain();
     _eventDispatcher = _director->getEventDispatcher();
@@ -178,8 +192,10 @@ Node::~Node()
     CC_SAFE_DELETE(_componentContainer);
     
     stopAllActions();
+    stopAllTweens();
     unscheduleAllCallbacks();
     CC_SAFE_RELEASE_NULL(_actionManager);
+    CC_SAFE_RELEASE_NULL(_tweenManager);
     CC_SAFE_RELEASE_NULL(_scheduler);
     
     _eventDispatcher->removeEventListenersForTarget(this);
@@ -215,6 +231,7 @@ void Node::cleanup()
     
     // actions
     this->stopAllActions();
+    this->stopAllTweens();
     // timers
     this->unscheduleAllCallbacks();
 
@@ -251,6 +268,8 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 }
 
 float Node::getSkewY() const
@@ -265,6 +284,8 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 }
 
 void Node::setLocalZOrder(std::int32_t z)
@@ -277,8 +298,10 @@ void Node::setLocalZOrder(std::int32_t z)
     {
         _parent->reorderChild(this, z);
     }
-
-    _eventDispatcher->setDirtyForNode(this);
+    else
+    {
+        _eventDispatcher->setDirtyForNode(this);
+    }
 }
 
 /// zOrder setter : private method
@@ -299,6 +322,7 @@ void Node::setGlobalZOrder(float globalZOrder)
     {
         _globalZOrder = globalZOrder;
         _eventDispatcher->setDirtyForNode(this);
+        setStaticDirty();
     }
 }
 
@@ -317,6 +341,8 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
     
     updateRotationQuat();
 }
@@ -334,6 +360,8 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -385,6 +413,8 @@ void Node::setRotationQuat(const Quaternion& quat)
     _rotationQuat = quat;
     updateRotation3D();
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 }
 
 Quaternion Node::getRotationQuat() const
@@ -399,6 +429,8 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
     
     updateRotationQuat();
 }
@@ -415,6 +447,8 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
     
     updateRotationQuat();
 }
@@ -434,6 +468,8 @@ void Node::setScale(float scale)
     
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 }
 
 /// scaleX getter
@@ -451,6 +487,8 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 }
 
 /// scaleX setter
@@ -461,6 +499,8 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 }
 
 /// scaleY getter
@@ -477,6 +517,8 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 }
 
 /// scaleY getter
@@ -493,6 +535,8 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 }
 
 
@@ -523,6 +567,8 @@ void Node::setPosition(float x, float y)
     _position.y = y;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
     _usingNormalizedPosition = false;
 }
 
@@ -568,6 +614,8 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 
     _positionZ = positionZ;
 }
@@ -588,6 +636,8 @@ void Node::setPositionNormalized(const Vec2& position)
     _usingNormalizedPosition = true;
     _normalizedPositionDirty = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 }
 
 ssize_t Node::getChildrenCount() const
@@ -609,6 +659,8 @@ void Node::setVisible(bool visible)
         _visible = visible;
         if(_visible)
             _transformUpdated = _transformDirty = _inverseDirty = true;
+        setStaticDirty();
+        setParentBoundsDirty();
     }
 }
 
@@ -630,6 +682,8 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setStaticDirty();
+        setParentBoundsDirty();
     }
 }
 
@@ -647,6 +701,8 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        setStaticDirty();
+        setBoundsDirty();
     }
 }
 
@@ -661,6 +717,8 @@ void Node::setParent(Node * parent)
 {
     _parent = parent;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 }
 
 /// isRelativeAnchorPoint getter
@@ -676,6 +734,8 @@ void Node::setIgnoreAnchorPointForPosition(bool newValue)
     {
         _ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setStaticDirty();
+        setParentBoundsDirty();
     }
 }
 
@@ -741,6 +801,7 @@ void Node::setGLProgramState(cocos2d::GLProgramState* glProgramState)
 
         if (_glProgramState)
             _glProgramState->setNodeBinding(this);
+        setStaticDirty();
     }
 }
 
@@ -754,6 +815,7 @@ void Node::setGLProgram(GLProgram* glProgram)
         _glProgramState->retain();
 
         _glProgramState->setNodeBinding(this);
+        setStaticDirty();
     }
 }
 
@@ -1116,6 +1178,8 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
     }
     
     _children.clear();
+    setStaticDirty();
+    setBoundsDirty();
 }
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
@@ -1147,6 +1211,8 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
     child->setParent(nullptr);
 
     _children.erase(childIndex);
+    setStaticDirty();
+    setBoundsDirty();
 }
 
 
@@ -1161,6 +1227,8 @@ void Node::insertChild(Node* child, int z)
     }
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
     _transformUpdated = true;
+    setStaticDirty();
+    setBoundsDirty();
     _reorderChildDirty = true;
     _children.pushBack(child);
     child->_setLocalZOrder(z);
@@ -1170,8 +1238,11 @@ void Node::reorderChild(Node *child, int zOrder)
 {
     CCASSERT( child != nullptr, "Child must be non-nil");
     _reorderChildDirty = true;
+    setStaticDirty();
     child->updateOrderOfArrival();
     child->_setLocalZOrder(zOrder);
+    // the listener priorities of the child's subtree follow its new order
+    _eventDispatcher->setDirtyForNode(child);
 }
 
 void Node::sortAllChildren()
@@ -1180,7 +1251,6 @@ void Node::sortAllChildren()
     {
         sortNodes(_children);
         _reorderChildDirty = false;
-        _eventDispatcher->setDirtyForNode(this);
     }
 }
 
@@ -1254,11 +1324,33 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
 
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
 
+#if CC_USE_CULLING
+    // skip the whole subtree when it is off screen, a leaf culls itself in draw()
+    if (!_children.empty() && isVisitableByVisitingCamera())
+    {
+        Rect bounds;
+        if (getSubtreeBounds(bounds) && !renderer->checkVisibility(_modelViewTransform, bounds))
+        {
+            // the children catch up on the changes when they are visited again
+            _skippedFlags |= flags & FLAGS_DIRTY_MASK;
+            return;
+        }
+    }
+    flags |= _skippedFlags;
+    _skippedFlags = 0;
+#endif
+
+    // a job of the parallel visit leaves the matrix stack to the main thread
+    auto commandList = ParallelVisit::getCommandList();
+
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
     // but it is deprecated and your code should not rely on it
-    _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    if (!commandList)
+    {
+        _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
     
     bool visibleByCamera = isVisitableByVisitingCamera();
 
@@ -1267,29 +1359,38 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     if(!_children.empty())
     {
         sortAllChildren();
-        // draw children zOrder < 0
-        for(auto size = _children.size(); i < size; ++i)
+        auto parallelVisit = commandList ? nullptr : _director->getParallelVisit();
+        if (parallelVisit && static_cast<size_t>(_children.size()) >= parallelVisit->getMinChildren())
         {
-            auto node = _children.at(i);
-
-            if (node && node->_localZOrder < 0)
-                node->visit(renderer, _modelViewTransform, flags);
-            else
-                break;
+            parallelVisit->visitChildren(this, renderer, flags, visibleByCamera);
         }
-        // self draw
-        if (visibleByCamera)
-            this->draw(renderer, _modelViewTransform, flags);
+        else
+        {
+            // draw children zOrder < 0
+            for(auto size = _children.size(); i < size; ++i)
+            {
+                auto node = _children.at(i);
 
-        for(auto it=_children.cbegin()+i, itCend = _children.cend(); it != itCend; ++it)
-            (*it)->visit(renderer, _modelViewTransform, flags);
+                if (node && node->_localZOrder < 0)
+                    ParallelVisit::visitChild(node, renderer, _modelViewTransform, flags, commandList);
+                else
+                    break;
+            }
+            // self draw
+            if (visibleByCamera)
+                this->draw(renderer, _modelViewTransform, flags);
+
+            for(auto it=_children.cbegin()+i, itCend = _children.cend(); it != itCend; ++it)
+                ParallelVisit::visitChild(*it, renderer, _modelViewTransform, flags, commandList);
+        }
     }
     else if (visibleByCamera)
     {
         this->draw(renderer, _modelViewTransform, flags);
     }
 
-    _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (!commandList)
+        _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
     
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
@@ -1297,6 +1398,84 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     // _orderOfArrival = 0;
 }
 
+bool Node::isVisitThreadSafe() const
+{
+    // a subclass may override visit() or draw()
+    return typeid(*this) == typeid(Node);
+}
+
+bool Node::isStaticCacheable() const
+{
+    // Node draws nothing, a subclass may draw anything
+    return typeid(*this) == typeid(Node);
+}
+
+bool Node::getDrawBounds(Rect& bounds) const
+{
+    // Node draws nothing, a subclass may draw anything
+    bounds = Rect::ZERO;
+    return typeid(*this) == typeid(Node);
+}
+
+bool Node::getSubtreeBounds(Rect& bounds)
+{
+    if (_boundsDirty)
+    {
+        _hasSubtreeBounds = computeSubtreeBounds(_subtreeBounds);
+        _boundsDirty = false;
+    }
+    bounds = _subtreeBounds;
+    return _hasSubtreeBounds;
+}
+
+bool Node::computeSubtreeBounds(Rect& bounds)
+{
+    bounds = Rect::ZERO;
+    if (!getDrawBounds(bounds))
+        return false;
+
+    bool empty = bounds.size.width <= 0 || bounds.size.height <= 0;
+    float minX = bounds.getMinX(), minY = bounds.getMinY();
+    float maxX = bounds.getMaxX(), maxY = bounds.getMaxY();
+    for (const auto& child : _children)
+    {
+        if (!child->_visible)
+            continue;
+
+        // the position follows the content size of this node only during the visit
+        Rect childBounds;
+        if (child->_usingNormalizedPosition || !child->getSubtreeBounds(childBounds))
+            return false;
+        if (childBounds.size.width <= 0 || childBounds.size.height <= 0)
+            continue;
+
+        const Mat4& transform = child->getNodeToParentTransform();
+        Vec3 corners[4] = {
+            Vec3(childBounds.getMinX(), childBounds.getMinY(), 0),
+            Vec3(childBounds.getMaxX(), childBounds.getMinY(), 0),
+            Vec3(childBounds.getMinX(), childBounds.getMaxY(), 0),
+            Vec3(childBounds.getMaxX(), childBounds.getMaxY(), 0),
+        };
+        for (auto& corner : corners)
+        {
+            transform.transformPoint(&corner);
+            if (empty)
+            {
+                minX = maxX = corner.x;
+                minY = maxY = corner.y;
+                empty = false;
+            }
+            minX = std::min(minX, corner.x);
+            minY = std::min(minY, corner.y);
+            maxX = std::max(maxX, corner.x);
+            maxY = std::max(maxY, corner.y);
+        }
+    }
+
+    bounds = empty ? Rect::ZERO : Rect(minX, minY, maxX - minX, maxY - minY);
+    return true;
+}
+
 Mat4 Node::transform(const Mat4& parentTransform)
 {
     return parentTransform * this->getNodeToParentTransform();
@@ -1321,6 +1500,9 @@ void Node::onEnter()
     if (_onEnterCallback)
         _onEnterCallback();
 
+    // before the children, they take it from here
+    _staticRoot = _parent ? (_parent->_isStaticRoot ? _parent : _parent->_staticRoot) : nullptr;
+
     if (_componentContainer && !_componentContainer->isEmpty())
     {
         _componentContainer->onEnter();
@@ -1420,6 +1602,8 @@ void Node::onExit()
     
     for( const auto &child: _children)
         child->onExit();
+
+    _staticRoot = nullptr;
     
 #if CC_ENABLE_SCRIPT_BINDING
     if (_scriptType == kScriptTypeLua)
@@ -1506,6 +1690,35 @@ ssize_t Node::getNumberOfRunningActionsByTag(int tag) const
     return _actionManager->getNumberOfRunningActionsInTargetByTag(this, tag);
 }
 
+// MARK: tweens
+
+void Node::setTweenManager(TweenManager* tweenManager)
+{
+    if( tweenManager != _tweenManager )
+    {
+        this->stopAllTweens();
+        CC_SAFE_RETAIN(tweenManager);
+        CC_SAFE_RELEASE(_tweenManager);
+        _tweenManager = tweenManager;
+    }
+}
+
+void Node::runTween(const Tween& tween)
+{
+    _tweenManager->addTween(tween, this, !_running);
+}
+
+void Node::stopAllTweens()
+{
+    _tweenManager->removeAllTweensFromTarget(this);
+}
+
+void Node::stopAllTweensByTag(int tag)
+{
+    CCASSERT( tag != Tween::INVALID_TAG, "Invalid tag");
+    _tweenManager->removeAllTweensByTag(tag, this);
+}
+
 
 // MARK: Callbacks
 
@@ -1630,6 +1843,7 @@ void Node::resume()
 {
     _scheduler->resumeTarget(this);
     _actionManager->resumeTarget(this);
+    _tweenManager->resumeTarget(this);
     _eventDispatcher->resumeEventListenersForTarget(this);
 }
 
@@ -1637,6 +1851,7 @@ void Node::pause()
 {
     _scheduler->pauseTarget(this);
     _actionManager->pauseTarget(this);
+    _tweenManager->pauseTarget(this);
     _eventDispatcher->pauseEventListenersForTarget(this);
 }
 
@@ -1808,6 +2023,8 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 
     if (_additionalTransform)
         // _additionalTransform[1] has a copy of lastest transform
@@ -1841,6 +2058,8 @@ void Node::setAdditionalTransform(const Mat4* additionalTransform)
         _additionalTransform[0] = *additionalTransform;
     }
     _transformUpdated = _additionalTransformDirty = _inverseDirty = true;
+    setStaticDirty();
+    setParentBoundsDirty();
 }
 
 void Node::setAdditionalTransform(const Mat4& additionalTransform)
@@ -2013,6 +2232,7 @@ void Node::updateDisplayedOpacity(GLubyte parentOpacity)
 {
     _displayedOpacity = _realOpacity * parentOpacity/255.0;
     updateColor();
+    setStaticDirty();
     
     if (_cascadeOpacityEnabled)
     {
@@ -2100,6 +2320,7 @@ void Node::updateDisplayedColor(const Color3B& parentColor)
     _displayedColor.g = _realColor.g * parentColor.g/255.0;
     _displayedColor.b = _realColor.b * parentColor.b/255.0;
     updateColor();
+    setStaticDirty();
     
     if (_cascadeColorEnabled)
     {
@@ -2203,6 +2424,7 @@ bool isScreenPointInRect(const Vec2 &pt, const Camera* camera, const Mat4& w2l,
 void Node::setCameraMask(unsigned short mask, bool applyChildren)
 {
     _cameraMask = mask;
+    setStaticDirty();
     if (applyChildren)
     {
         for (const auto& child : _children)
@@ -52,6 +52,8 @@ class Action;
 class LabelProtocol;
 class Scheduler;
 class ActionManager;
+class Tween;
+class TweenManager;
 class Component;
 class ComponentContainer;
 class EventDispatcher;
@@ -1180,6 +1182,41 @@ public:
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit() final;
 
+    /**
+     * Returns whether a worker thread of the parallel visit may call visit() and draw() of this node,
+     * see Director::setParallelVisitThreads(). They may only change this node and its render commands.
+     * True for Node and Sprite, a subclass that overrides visit() or draw() has to override this too.
+     */
+    virtual bool isVisitThreadSafe() const;
+
+    /**
+     * Returns whether every change of what this node draws calls setStaticDirty(), so a StaticNode may draw it from its cache.
+     * A StaticNode visits its subtree as usual while any node in it returns false.
+     * True for Node, Sprite and Label, a subclass that overrides draw() has to override this too.
+     */
+    virtual bool isStaticCacheable() const;
+
+    /**
+     * Gets the rectangle draw() stays inside of, in the node's own space.
+     * visit() skips the node and all its children when their bounds are off screen, see getSubtreeBounds().
+     * Node, Sprite, Layer, LayerColor, Menu, MenuItemSprite, the TMX maps and layers and a ui::Layout without clipping
+     * implement it, a subclass that overrides draw() has to override this too. Any other node, such as a Label, a ui::Widget
+     * or a ui::Scale9Sprite, makes the subtree it is in unbounded and never skipped.
+     *
+     * @param bounds The rectangle, Rect::ZERO when draw() draws nothing.
+     * @return False when draw() may draw anywhere.
+     */
+    virtual bool getDrawBounds(Rect& bounds) const;
+
+    /**
+     * Gets the bounds of what this node and its visible children draw, in the node's own space.
+     * They are cached until a change of a content size, a child transform or the children below the node.
+     *
+     * @param bounds The rectangle.
+     * @return False when a node of the subtree may draw anywhere.
+     */
+    bool getSubtreeBounds(Rect& bounds);
+
 
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
@@ -1314,6 +1351,52 @@ public:
 
     /// @} end of Actions
 
+    /// @{
+    /// @name Tweens
+
+    /**
+     * Sets the TweenManager object that runs the tweens.
+     *
+     * @warning If you set a new TweenManager, then the running tweens will be removed.
+     *
+     * @param tweenManager     A TweenManager object.
+     */
+    virtual void setTweenManager(TweenManager* tweenManager);
+    /**
+     * Gets the TweenManager object that runs the tweens.
+     * @see setTweenManager(TweenManager*)
+     * @return A TweenManager object.
+     */
+    virtual TweenManager* getTweenManager() { return _tweenManager; }
+    virtual const TweenManager* getTweenManager() const { return _tweenManager; }
+
+    /**
+     * Runs a tween on this node, like runAction() without creating an action.
+     * The tweens are stored in arrays by the TweenManager and can run with the actions.
+     *
+     * @param tween A Tween, it is copied.
+     */
+    void runTween(const Tween& tween);
+
+    /**
+     * Stops all the tweens of this node.
+     */
+    void stopAllTweens();
+
+    /**
+     * Stops all the tweens of this node with a tag.
+     *
+     * @param tag   A tag set with Tween::setTag().
+     */
+    void stopAllTweensByTag(int tag);
+
+    /**
+     * Returns the number of tweens running on this node.
+     */
+    ssize_t getNumberOfRunningTweens() const { return _runningTweens; }
+
+    /// @} end of Tweens
+
 
     /// @{
     /// @name Scheduler and Timer
@@ -1892,6 +1975,29 @@ protected:
     //check whether this camera mask is visible by the current visiting camera
     bool isVisitableByVisitingCamera() const;
     
+    /// Tells the StaticNode that caches this node, and the ones around it, that their render commands are stale.
+    void setStaticDirty()
+    {
+        for (auto root = _isStaticRoot ? this : _staticRoot; root; root = root->_staticRoot)
+            root->_staticDirty = true;
+    }
+
+    /// The subtree bounds of this node and of its ancestors have to be computed again.
+    void setBoundsDirty()
+    {
+        for (auto node = this; node && !node->_boundsDirty; node = node->_parent)
+            node->_boundsDirty = true;
+    }
+
+    /// The transform or the visibility of this node changed, so did the subtree bounds of its parent.
+    void setParentBoundsDirty()
+    {
+        if (_parent)
+            _parent->setBoundsDirty();
+    }
+
+    bool computeSubtreeBounds(Rect& bounds);
+
     // update quaternion from Rotation3D
     void updateRotationQuat();
     // update Rotation3D from quaternion
@@ -1980,6 +2086,9 @@ protected:
 
     ActionManager *_actionManager;  ///< a pointer to ActionManager singleton, which is used to handle all the actions
 
+    TweenManager *_tweenManager;    ///< a pointer to the TweenManager of the director, which runs the tweens
+    unsigned int _runningTweens;    ///< the number of tweens of this node, kept by the TweenManager
+
     EventDispatcher* _eventDispatcher;  ///< event dispatcher used to dispatch all kinds of events
 
     bool _running;                  ///< is running
@@ -1992,6 +2101,15 @@ protected:
     bool _reorderChildDirty;          ///< children order dirty flag
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
 
+    Node* _staticRoot;                ///< the nearest StaticNode above this node while running
+    bool _isStaticRoot;               ///< this node is a StaticNode
+    bool _staticDirty;                ///< a StaticNode has to record its children again
+
+    Rect _subtreeBounds;              ///< cached getSubtreeBounds() in the node's own space
+    bool _hasSubtreeBounds;           ///< false when something in the subtree may draw anywhere
+    bool _boundsDirty;                ///< _subtreeBounds has to be computed again
+    uint32_t _skippedFlags;           ///< dirty flags the children missed while visit() skipped them
+
 #if CC_ENABLE_SCRIPT_BINDING
     int _scriptHandler;               ///< script handler for onEnter() & onExit(), used in Javascript binding and Lua binding.
     int _updateScriptHandler;         ///< script handler for update() callback per frame, which is invoked from lua & javascript.
@@ -2034,6 +2152,10 @@ public:
     friend class PhysicsBody;
 #endif
 
+    friend class ParallelVisit;
+    friend class EventDispatcher;
+    friend class TweenManager;
+
     static int __attachedNodeCount;
     
 private:
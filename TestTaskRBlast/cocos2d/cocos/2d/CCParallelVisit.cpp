@@ -0,0 +1,142 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCParallelVisit.h"
+#include <algorithm>
+#include "base/CCDirector.h"
+#include "base/CCTrace.h"
+#include "renderer/CCRenderer.h"
+
+NS_CC_BEGIN
+
+// a few jobs per thread, so the stealing can even out subtrees of different size
+static const size_t JOBS_PER_THREAD = 4;
+
+static thread_local ParallelVisit::CommandList* s_commandList = nullptr;
+
+ParallelVisit::ParallelVisit(unsigned threadCount, size_t minChildren)
+: _pool(threadCount)
+, _minChildren(std::max(minChildren, static_cast<size_t>(2)))
+, _depth(0)
+{
+}
+
+ParallelVisit::CommandList* ParallelVisit::getCommandList()
+{
+    return s_commandList;
+}
+
+void ParallelVisit::visitChildren(Node* parent, Renderer* renderer, uint32_t parentFlags, bool visibleByCamera)
+{
+    if (_depth == _frames.size())
+    {
+        _frames.emplace_back();
+        auto& frame = _frames.back();
+        frame.job = [&frame](size_t job) { runJob(frame, job); };
+    }
+    auto& frame = _frames[_depth++];
+    frame.parent = parent;
+    frame.renderer = renderer;
+    frame.parentFlags = parentFlags;
+
+    // the children are sorted, the ones with a negative local z order come before the parent's own draw
+    auto& children = parent->_children;
+    size_t count = children.size();
+    size_t negative = 0;
+    while (negative < count && children.at(negative)->_localZOrder < 0)
+    {
+        ++negative;
+    }
+
+    size_t chunk = std::max(count / (_pool.getThreadCount() * JOBS_PER_THREAD), static_cast<size_t>(1));
+    frame.ranges.clear();
+    for (size_t begin = 0; begin < negative; begin += chunk)
+    {
+        frame.ranges.emplace_back(begin, std::min(begin + chunk, negative));
+    }
+    size_t firstPositive = frame.ranges.size();
+    for (size_t begin = negative; begin < count; begin += chunk)
+    {
+        frame.ranges.emplace_back(begin, std::min(begin + chunk, count));
+    }
+    if (frame.lists.size() < frame.ranges.size())
+    {
+        frame.lists.resize(frame.ranges.size());
+    }
+
+    _pool.parallelFor(frame.ranges.size(), frame.job);
+
+    for (size_t job = 0; job < firstPositive; ++job)
+    {
+        replay(frame.lists[job], renderer);
+    }
+    if (visibleByCamera)
+    {
+        parent->draw(renderer, parent->_modelViewTransform, parentFlags);
+    }
+    for (size_t job = firstPositive; job < frame.ranges.size(); ++job)
+    {
+        replay(frame.lists[job], renderer);
+    }
+
+    --_depth;
+}
+
+void ParallelVisit::runJob(Frame& frame, size_t job)
+{
+    CC_TRACE_SCOPE("ParallelVisit::runJob");
+    auto& list = frame.lists[job];
+    list.clear();
+    s_commandList = &list;
+
+    auto& children = frame.parent->_children;
+    const Mat4& transform = frame.parent->_modelViewTransform;
+    for (size_t i = frame.ranges[job].first; i < frame.ranges[job].second; ++i)
+    {
+        visitChild(children.at(i), frame.renderer, transform, frame.parentFlags, &list);
+    }
+
+    s_commandList = nullptr;
+}
+
+void ParallelVisit::replay(const CommandList& list, Renderer* renderer)
+{
+    auto director = Director::getInstance();
+    for (auto& entry : list)
+    {
+        if (entry.command)
+        {
+            renderer->addCommand(entry.command);
+            continue;
+        }
+
+        // the deprecated matrix stack holds the parent's transform, as in a serial visit
+        director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, *entry.parentTransform);
+        entry.node->visit(renderer, *entry.parentTransform, entry.parentFlags);
+        director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    }
+}
+
+NS_CC_END
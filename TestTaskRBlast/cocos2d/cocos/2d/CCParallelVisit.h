@@ -0,0 +1,120 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCPARALLEL_VISIT_H__
+#define __CCPARALLEL_VISIT_H__
+
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "2d/CCNode.h"
+#include "base/CCWorkStealingPool.h"
+
+NS_CC_BEGIN
+
+class RenderCommand;
+
+/**
+ *  @addtogroup _2d
+ *  @{
+ */
+
+/** Visits the children of nodes with many children on a WorkStealingPool, see Director::setParallelVisitThreads().
+ *
+ * Each job visits a contiguous run of children: it updates their transforms, culls them and records
+ * the commands their draw() adds into a list of its own. When all jobs are done the main thread adds
+ * the lists to the Renderer in child order, so the render queue is the same as after a serial visit.
+ *
+ * Only nodes whose isVisitThreadSafe() is true are visited by a job. A job records any other child
+ * at its place in the list, and the main thread visits it there.
+ */
+class CC_DLL ParallelVisit
+{
+public:
+    /** A command added by a job, or a child the job left to the main thread. */
+    struct Entry
+    {
+        RenderCommand* command;
+        Node* node;
+        const Mat4* parentTransform;
+        uint32_t parentFlags;
+    };
+    typedef std::vector<Entry> CommandList;
+
+    /**
+     * @param threadCount The threads of the pool including the main thread, 0 uses one per core.
+     * @param minChildren The number of children from which a node visits them in parallel.
+     */
+    ParallelVisit(unsigned threadCount, size_t minChildren);
+
+    /** The list a job on the current thread records into, nullptr outside of the jobs. */
+    static CommandList* getCommandList();
+
+    unsigned getThreadCount() const { return _pool.getThreadCount(); }
+    size_t getMinChildren() const { return _minChildren; }
+
+    /** Visits the children of parent and draws parent in the order of Node::visit(). */
+    void visitChildren(Node* parent, Renderer* renderer, uint32_t parentFlags, bool visibleByCamera);
+
+    /** Visits child, or records it for the main thread when called from a job and child is not thread safe. */
+    static void visitChild(Node* child, Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags, CommandList* commandList)
+    {
+        if (commandList && !child->isVisitThreadSafe())
+            commandList->push_back({ nullptr, child, &parentTransform, parentFlags });
+        else
+            child->visit(renderer, parentTransform, parentFlags);
+    }
+
+protected:
+    // the state of one visitChildren(), a child visited by the main thread may start another one
+    struct Frame
+    {
+        Node* parent;
+        Renderer* renderer;
+        uint32_t parentFlags;
+        std::vector<std::pair<size_t, size_t>> ranges;
+        std::vector<CommandList> lists;
+        std::function<void(size_t)> job;
+    };
+
+    static void runJob(Frame& frame, size_t job);
+    static void replay(const CommandList& list, Renderer* renderer);
+
+    WorkStealingPool _pool;
+    size_t _minChildren;
+    // a deque, so a nested visitChildren() doesn't move the frames of the outer ones
+    std::deque<Frame> _frames;
+    size_t _depth;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(ParallelVisit);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCPARALLEL_VISIT_H__
@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "renderer/CCRenderer.h"
 #include "renderer/CCFrameBuffer.h"
 #include "platform/CCDataManager.h"
+#include "base/CCTrace.h"
 
 #if CC_USE_PHYSICS
 #include "physics/CCPhysicsWorld.h"
@@ -241,7 +242,10 @@ void Scene::render(Renderer* renderer, const Mat4* eyeTransforms, const Mat4* ey
         //clear background with max depth
         camera->clearBackground();
         //visit the scene
-        visit(renderer, transform, 0);
+        {
+            CC_TRACE_SCOPE("Scene::visit");
+            visit(renderer, transform, 0);
+        }
 #if CC_USE_NAVMESH
         if (_navMesh && _navMeshDebugCamera == camera)
         {
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "2d/CCSprite.h"
 
 #include <algorithm>
+#include <typeinfo>
 
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCAnimationCache.h"
@@ -311,6 +312,8 @@ Sprite::Sprite()
 , _batchNode(nullptr)
 , _shouldBeHidden(false)
 , _texture(nullptr)
+, _atlasPage(nullptr)
+, _atlasVersion(0)
 , _spriteFrame(nullptr)
 , _centerRectNormalized(0,0,1,1)
 , _renderMode(Sprite::RenderMode::QUAD)
@@ -408,6 +411,7 @@ void Sprite::setTexture(Texture2D *texture)
             _texture = texture;
         }
         updateBlendFunc();
+        setStaticDirty();
     }
 }
 
@@ -433,8 +437,29 @@ void Sprite::setTextureRect(const Rect& rect, bool rotated, const Size& untrimme
     updatePoly();
 }
 
+void Sprite::updateAtlasPage()
+{
+    // a texture packed into the dynamic atlas is drawn from its page, as long as the rect stays inside the texture
+    _atlasPage = nullptr;
+    _atlasVersion = _texture ? _texture->getAtlasVersion() : 0;
+    if (!_texture || !_texture->getAtlasPage() || (_renderMode != RenderMode::QUAD && _renderMode != RenderMode::SLICE9))
+        return;
+
+    Size size = _texture->getContentSize();
+    float width = _rectRotated ? _rect.size.height : _rect.size.width;
+    float height = _rectRotated ? _rect.size.width : _rect.size.height;
+    if (_rect.origin.x >= 0 && _rect.origin.y >= 0
+        && _rect.origin.x + width <= size.width + FLT_EPSILON && _rect.origin.y + height <= size.height + FLT_EPSILON)
+    {
+        _atlasPage = _texture->getAtlasPage();
+    }
+}
+
 void Sprite::updatePoly()
 {
+    setStaticDirty();
+    updateAtlasPage();
+
     // There are 3 cases:
     //
     // A) a non 9-sliced, non stretched
@@ -781,7 +806,12 @@ void Sprite::setTextureCoords(const Rect& rectInPoints, V3F_C4B_T2F_Quad* outQua
         return;
     }
 
-    const auto rectInPixels = CC_RECT_POINTS_TO_PIXELS(rectInPoints);
+    auto rectInPixels = CC_RECT_POINTS_TO_PIXELS(rectInPoints);
+    if (_atlasPage && _renderMode != RenderMode::QUAD_BATCHNODE)
+    {
+        rectInPixels.origin += tex->getAtlasRect().origin;
+        tex = _atlasPage;
+    }
 
     const float atlasWidth = (float)tex->getPixelsWide();
     const float atlasHeight = (float)tex->getPixelsHigh();
@@ -1049,6 +1079,25 @@ void Sprite::updateTransform(void)
 
 // draw
 
+bool Sprite::isVisitThreadSafe() const
+{
+    // draw() only fills _trianglesCommand and, after a dynamic atlas change, its own quad; a subclass may do more
+    return typeid(*this) == typeid(Sprite);
+}
+
+bool Sprite::isStaticCacheable() const
+{
+    // the setters of what draw() uses mark the node static dirty, a subclass may draw more
+    return typeid(*this) == typeid(Sprite);
+}
+
+bool Sprite::getDrawBounds(Rect& bounds) const
+{
+    // the quad, polygon or 9 slices are inside the content size, as draw() assumes for its own culling
+    bounds.setRect(0, 0, _contentSize.width, _contentSize.height);
+    return typeid(*this) == typeid(Sprite);
+}
+
 void Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
     if (_texture == nullptr)
@@ -1075,8 +1124,14 @@ void Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     if(_insideBounds)
 #endif
     {
+        // the texture was packed, moved or taken out of the dynamic atlas
+        if (_atlasVersion != _texture->getAtlasVersion() && (_renderMode == RenderMode::QUAD || _renderMode == RenderMode::SLICE9))
+        {
+            updatePoly();
+        }
+
         _trianglesCommand.init(_globalZOrder,
-                               _texture,
+                               _atlasPage ? _atlasPage : _texture,
                                getGLProgramState(),
                                _blendFunc,
                                _polyInfo.triangles,
@@ -1461,6 +1516,7 @@ bool Sprite::isFlippedY(void) const
 }
 
 void Sprite::flipX() {
+    setStaticDirty();
     if (_renderMode == RenderMode::QUAD_BATCHNODE)
     {
         setDirty(true);
@@ -1480,6 +1536,7 @@ void Sprite::flipX() {
 }
 
 void Sprite::flipY() {
+    setStaticDirty();
     if (_renderMode == RenderMode::QUAD_BATCHNODE)
     {
         setDirty(true);
@@ -1504,6 +1561,8 @@ void Sprite::flipY() {
 
 void Sprite::updateColor(void)
 {
+    setStaticDirty();
+
     Color4B color4( _displayedColor.r, _displayedColor.g, _displayedColor.b, _displayedOpacity );
 
     // special opacity for premultiplied textures
@@ -1730,6 +1789,7 @@ void Sprite::setPolygonInfo(const PolygonInfo& info)
 {
     _polyInfo = info;
     _renderMode = RenderMode::POLYGON;
+    setStaticDirty();
 }
 
 NS_CC_END
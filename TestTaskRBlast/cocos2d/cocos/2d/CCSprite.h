@@ -493,7 +493,7 @@ public:
     *In lua: local setBlendFunc(local src, local dst).
     *@endcode
     */
-    void setBlendFunc(const BlendFunc &blendFunc) override { _blendFunc = blendFunc; }
+    void setBlendFunc(const BlendFunc &blendFunc) override { _blendFunc = blendFunc; setStaticDirty(); }
     /**
     * @js  NA
     * @lua NA
@@ -538,6 +538,9 @@ public:
     
     virtual void setVisible(bool bVisible) override;
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
+    virtual bool isVisitThreadSafe() const override;
+    virtual bool isStaticCacheable() const override;
+    virtual bool getDrawBounds(Rect& bounds) const override;
     virtual void setOpacityModifyRGB(bool modify) override;
     virtual bool isOpacityModifyRGB() const override;
     /// @}
@@ -661,6 +664,7 @@ protected:
 
     void updatePoly();
     void updateStretchFactor();
+    void updateAtlasPage();
 
     virtual void flipX();
     virtual void flipY();
@@ -682,6 +686,8 @@ protected:
     //
     BlendFunc        _blendFunc;            /// It's required for TextureProtocol inheritance
     Texture2D*       _texture;              /// Texture2D object that is used to render the sprite
+    Texture2D*       _atlasPage;            /// The DynamicAtlas page drawn instead of _texture (weak reference)
+    unsigned int     _atlasVersion;         /// The atlas version of _texture the texture coordinates are for
     SpriteFrame*     _spriteFrame;
     TrianglesCommand _trianglesCommand;     ///
 #if CC_SPRITE_DEBUG_DRAW
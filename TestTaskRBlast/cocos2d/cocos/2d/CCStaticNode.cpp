@@ -0,0 +1,286 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCStaticNode.h"
+#include "2d/CCCamera.h"
+#include "base/CCDirector.h"
+#include "base/CCEventType.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventDispatcher.h"
+#include "math/MathUtil.h"
+#include "renderer/CCDynamicAtlas.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCGroupCommand.h"
+#include "renderer/ccGLStateCache.h"
+#include "renderer/CCGLProgram.h"
+#include "renderer/CCGLProgramState.h"
+
+NS_CC_BEGIN
+
+// the indices of a batch are 16 bit
+static const size_t BATCH_MAX_VERTICES = 65536;
+
+// whether every node below node reports its changes
+static bool isSubtreeCacheable(const Node* node)
+{
+    for (auto child : node->getChildren())
+    {
+        if (!child->isStaticCacheable() || !isSubtreeCacheable(child))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+StaticNode* StaticNode::create()
+{
+    StaticNode* ret = new (std::nothrow) StaticNode();
+    if (ret && ret->init())
+    {
+        ret->autorelease();
+    }
+    else
+    {
+        CC_SAFE_DELETE(ret);
+    }
+    return ret;
+}
+
+StaticNode::StaticNode()
+: _recordQueueID(0)
+, _recordCamera(nullptr)
+, _recordAtlasVersion(0)
+, _cached(false)
+{
+    _isStaticRoot = true;
+    _staticDirty = true;
+    _buffers[0] = _buffers[1] = 0;
+    _recordQueueID = _director->getRenderer()->getGroupCommandManager()->getGroupID();
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    auto listener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom* /*event*/){
+        /** listen the event that renderer was recreated on Android/WP8, the buffers are gone */
+        _buffers[0] = _buffers[1] = 0;
+        _staticDirty = true;
+    });
+
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+#endif
+}
+
+StaticNode::~StaticNode()
+{
+    clearBatches();
+    glDeleteBuffers(2, _buffers);
+    _director->getRenderer()->getGroupCommandManager()->releaseGroupID(_recordQueueID);
+}
+
+void StaticNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
+{
+    // the children report their changes only while running
+    if (!_running)
+    {
+        _cached = false;
+        Node::visit(renderer, parentTransform, parentFlags);
+        return;
+    }
+
+    if (!_visible)
+    {
+        return;
+    }
+
+    // the cache is in world space and holds only what the recording camera did not cull
+    auto camera = Camera::getVisitingCamera();
+    if ((parentFlags & FLAGS_DIRTY_MASK) || _transformUpdated || _contentSizeDirty
+        || camera != _recordCamera || (camera && camera->isViewProjectionUpdated())
+        || _recordAtlasVersion != DynamicAtlas::getVersion())
+    {
+        _staticDirty = true;
+    }
+
+    if (_staticDirty)
+    {
+        record(renderer, parentTransform, parentFlags);
+    }
+    else if (_cached)
+    {
+        for (auto& batch : _batches)
+        {
+            renderer->addCommand(&batch.command);
+        }
+    }
+    else
+    {
+        Node::visit(renderer, parentTransform, parentFlags);
+    }
+}
+
+void StaticNode::record(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags)
+{
+    _staticDirty = false;
+    _recordCamera = Camera::getVisitingCamera();
+    _recordAtlasVersion = DynamicAtlas::getVersion();
+
+    // a node that changes without telling would freeze in the cache
+    if (!isSubtreeCacheable(this))
+    {
+        _cached = false;
+        Node::visit(renderer, parentTransform, parentFlags);
+        return;
+    }
+
+    renderer->pushGroup(_recordQueueID);
+    Node::visit(renderer, parentTransform, parentFlags);
+    renderer->popGroup();
+
+    auto& queue = renderer->getRenderQueue(_recordQueueID);
+    _cached = bake(queue);
+    if (_cached)
+    {
+        upload();
+        for (auto& batch : _batches)
+        {
+            renderer->addCommand(&batch.command);
+        }
+    }
+    else
+    {
+        // the same commands in the same order as a plain visit would have added
+        for (ssize_t i = 0, size = queue.size(); i < size; ++i)
+        {
+            renderer->addCommand(queue[i]);
+        }
+    }
+    queue.clear();
+}
+
+bool StaticNode::bake(const RenderQueue& queue)
+{
+    clearBatches();
+    _vertices.clear();
+    _indices.clear();
+
+    for (ssize_t i = 0, size = queue.size(); i < size; ++i)
+    {
+        auto command = queue[i];
+        if (command->getType() != RenderCommand::Type::TRIANGLES_COMMAND || command->is3D() || command->isSkipBatching())
+        {
+            clearBatches();
+            return false;
+        }
+        auto cmd = static_cast<TrianglesCommand*>(command);
+        size_t vertexCount = cmd->getVertexCount();
+        size_t indexCount = cmd->getIndexCount();
+
+        // the renderer would batch these two commands as well
+        Batch* batch = _batches.empty() ? nullptr : &_batches.back();
+        if (!batch || batch->material.getMaterialID() != cmd->getMaterialID()
+            || batch->material.getGlobalOrder() != cmd->getGlobalOrder()
+            || batch->vertexCount + vertexCount > BATCH_MAX_VERTICES)
+        {
+            _batches.emplace_back();
+            batch = &_batches.back();
+            batch->material = *cmd;
+            CC_SAFE_RETAIN(batch->material.getGLProgramState());
+            batch->firstVertex = _vertices.size();
+            batch->vertexCount = 0;
+            batch->firstIndex = _indices.size();
+            batch->indexCount = 0;
+        }
+
+        _vertices.resize(_vertices.size() + vertexCount);
+        _indices.resize(_indices.size() + indexCount);
+        MathUtil::transformVertices(cmd->getModelView().m, cmd->getVertices(),
+                                    &_vertices[batch->firstVertex + batch->vertexCount], vertexCount, sizeof(V3F_C4B_T2F));
+        MathUtil::offsetIndices(cmd->getIndices(), &_indices[batch->firstIndex + batch->indexCount],
+                                indexCount, static_cast<unsigned short>(batch->vertexCount));
+        batch->vertexCount += vertexCount;
+        batch->indexCount += indexCount;
+    }
+
+    // the commands point into _batches, which doesn't grow any more
+    for (size_t i = 0; i < _batches.size(); ++i)
+    {
+        auto& batch = _batches[i];
+        batch.command.init(batch.material.getGlobalOrder());
+        batch.command.func = CC_CALLBACK_0(StaticNode::onDraw, this, i);
+    }
+    return true;
+}
+
+void StaticNode::upload()
+{
+    if (!_buffers[0])
+    {
+        glGenBuffers(2, _buffers);
+    }
+
+    // a VAO bound now would capture the index buffer
+    GL::bindVAO(0);
+    glBindBuffer(GL_ARRAY_BUFFER, _buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(V3F_C4B_T2F) * _vertices.size(), _vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffers[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * _indices.size(), _indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void StaticNode::clearBatches()
+{
+    for (auto& batch : _batches)
+    {
+        CC_SAFE_RELEASE(batch.material.getGLProgramState());
+    }
+    _batches.clear();
+}
+
+void StaticNode::onDraw(size_t index)
+{
+    const auto& batch = _batches[index];
+    batch.material.useMaterial();
+
+    GL::bindVAO(0);
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+    glBindBuffer(GL_ARRAY_BUFFER, _buffers[0]);
+    size_t offset = sizeof(V3F_C4B_T2F) * batch.firstVertex;
+    // vertex
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*)(offset + offsetof(V3F_C4B_T2F, vertices)));
+    // color
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*)(offset + offsetof(V3F_C4B_T2F, colors)));
+    // tex coords
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*)(offset + offsetof(V3F_C4B_T2F, texCoords)));
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffers[1]);
+    glDrawElements(GL_TRIANGLES, (GLsizei)batch.indexCount, GL_UNSIGNED_SHORT, (GLvoid*)(sizeof(GLushort) * batch.firstIndex));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, batch.indexCount);
+    CHECK_GL_ERROR_DEBUG();
+}
+
+NS_CC_END
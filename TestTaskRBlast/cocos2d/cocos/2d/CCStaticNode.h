@@ -0,0 +1,114 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCSTATIC_NODE_H__
+#define __CCSTATIC_NODE_H__
+
+#include <vector>
+#include "2d/CCNode.h"
+#include "platform/CCGL.h"
+#include "renderer/CCCustomCommand.h"
+#include "renderer/CCTrianglesCommand.h"
+
+NS_CC_BEGIN
+
+class Camera;
+class RenderQueue;
+
+/**
+ *  @addtogroup _2d
+ *  @{
+ */
+
+/** StaticNode is a subclass of Node that draws a subtree which seldom changes from a cache.
+ *
+ * The first visit records the TrianglesCommands of the children, transforms their vertices
+ * into world space once and uploads them into static buffer objects. The following frames
+ * skip the children and add one draw per material, until a transform, content, visibility
+ * or child order change somewhere inside the subtree marks the node dirty.
+ *
+ * Sprites and labels report their changes, see Node::isStaticCacheable(). A subtree with any other
+ * node, or one that emits other commands than 2D TrianglesCommands, is visited as usual.
+ * A sprite or label that changes what it draws in another way has to call invalidate() on the StaticNode.
+ */
+class CC_DLL StaticNode : public Node
+{
+public:
+    /** Creates an empty StaticNode.
+     *
+     * @return An autorelease StaticNode.
+     */
+    static StaticNode* create();
+
+    /** Records the children again on the next visit. */
+    void invalidate() { _staticDirty = true; }
+
+    /** Returns whether the last visit drew the subtree from the cache. */
+    bool isCached() const { return _cached; }
+
+    virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+
+CC_CONSTRUCTOR_ACCESS:
+    StaticNode();
+    virtual ~StaticNode();
+
+protected:
+    /** Consecutive commands with one material, drawn with a single glDrawElements. */
+    struct Batch
+    {
+        CustomCommand command;
+        // a copy of the first command, it sets up the texture, blend function and program
+        TrianglesCommand material;
+        size_t firstVertex;
+        size_t vertexCount;
+        size_t firstIndex;
+        size_t indexCount;
+    };
+
+    void record(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags);
+    bool bake(const RenderQueue& queue);
+    void upload();
+    void clearBatches();
+    void onDraw(size_t batch);
+
+    std::vector<Batch> _batches;
+    std::vector<V3F_C4B_T2F> _vertices;
+    std::vector<GLushort> _indices;
+    GLuint _buffers[2];
+    int _recordQueueID;
+    const Camera* _recordCamera;
+    // the batches hold the atlas pages and texture coordinates of this version
+    unsigned int _recordAtlasVersion;
+    bool _cached;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(StaticNode);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCSTATIC_NODE_H__
@@ -26,6 +26,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 
+#include <typeinfo>
 #include "2d/CCTMXLayer.h"
 #include "2d/CCTMXTiledMap.h"
 #include "2d/CCSprite.h"
@@ -345,6 +346,26 @@ Sprite* TMXLayer::reusedTileWithRect(const Rect& rect)
     return _reusedTile;
 }
 
+void TMXLayer::addTileBounds(Sprite* tile)
+{
+    // the quad of a tile of the atlas is in the space of the layer
+    V3F_C4B_T2F_Quad quad = tile->getQuad();
+    float minX = std::min(std::min(quad.bl.vertices.x, quad.br.vertices.x), std::min(quad.tl.vertices.x, quad.tr.vertices.x));
+    float minY = std::min(std::min(quad.bl.vertices.y, quad.br.vertices.y), std::min(quad.tl.vertices.y, quad.tr.vertices.y));
+    float maxX = std::max(std::max(quad.bl.vertices.x, quad.br.vertices.x), std::max(quad.tl.vertices.x, quad.tr.vertices.x));
+    float maxY = std::max(std::max(quad.bl.vertices.y, quad.br.vertices.y), std::max(quad.tl.vertices.y, quad.tr.vertices.y));
+    Rect rect(minX, minY, maxX - minX, maxY - minY);
+    if (_tilesBounds.size.width <= 0 || _tilesBounds.size.height <= 0)
+    {
+        _tilesBounds = rect;
+    }
+    else
+    {
+        _tilesBounds.merge(rect);
+    }
+    setBoundsDirty();
+}
+
 // TMXLayer - obtaining tiles/gids
 Sprite * TMXLayer::getTileAt(const Vec2& pos)
 {
@@ -418,6 +439,7 @@ Sprite * TMXLayer::insertTileForGID(uint32_t gid, const Vec2& pos)
         
         // Optimization: add the quad without adding a child
         this->insertQuadFromSprite(tile, indexForZ);
+        addTileBounds(tile);
         
         // insert it into the local atlasindex array
         ccCArrayInsertValueAtIndex(_atlasIndexArray, (void*)z, indexForZ);
@@ -455,6 +477,7 @@ Sprite * TMXLayer::updateTileForGID(uint32_t gid, const Vec2& pos)
     tile->setAtlasIndex(indexForZ);
     tile->setDirty(true);
     tile->updateTransform();
+    addTileBounds(tile);
     _tiles[z] = gid;
 
     return tile;
@@ -516,6 +539,7 @@ Sprite * TMXLayer::appendTileForGID(uint32_t gid, const Vec2& pos)
         
         // don't add it using the "standard" way.
         insertQuadFromSprite(tile, indexForZ);
+        addTileBounds(tile);
         
         // append should be after addQuadFromSprite since it modifies the quantity values
         ccCArrayInsertValueAtIndex(_atlasIndexArray, (void*)z, indexForZ);
@@ -845,5 +869,12 @@ std::string TMXLayer::getDescription() const
     return StringUtils::format("<TMXLayer | tag = %d, size = %d,%d>", _tag, (int)_mapTileSize.width, (int)_mapTileSize.height);
 }
 
+bool TMXLayer::getDrawBounds(Rect& bounds) const
+{
+    // the culling is in 2D, a vertex Z moves the tiles on screen
+    bounds = _tilesBounds;
+    return typeid(*this) == typeid(TMXLayer) && !_useAutomaticVertexZ && _vertexZvalue == 0;
+}
+
 
 NS_CC_END
@@ -293,6 +293,7 @@ public:
     * @js NA
     */
     virtual std::string getDescription() const override;
+    virtual bool getDrawBounds(Rect& bounds) const override;
 
 protected:
     Vec2 getPositionForIsoAt(const Vec2& pos);
@@ -312,6 +313,7 @@ protected:
     void parseInternalProperties();
     void setupTileSprite(Sprite* sprite, const Vec2& pos, uint32_t gid);
     Sprite* reusedTileWithRect(const Rect& rect);
+    void addTileBounds(Sprite* tile);
     int getVertexZForPos(const Vec2& pos);
 
     // index
@@ -353,6 +355,8 @@ protected:
     int _hexSideLength;
     /** properties from the layer. They can be added using Tiled */
     ValueMap _properties;
+    /** bounds of the quads of the tiles, they don't shrink when a tile is removed */
+    Rect _tilesBounds;
 };
 
 // end of tilemap_parallax_nodes group
@@ -25,6 +25,7 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
+#include <typeinfo>
 #include "2d/CCTMXTiledMap.h"
 #include "2d/CCTMXXMLParser.h"
 #include "2d/CCTMXLayer.h"
@@ -268,6 +269,13 @@ std::string TMXTiledMap::getDescription() const
     return StringUtils::format("<TMXTiledMap | Tag = %d, Layers = %d", _tag, static_cast<int>(_children.size()));
 }
 
+bool TMXTiledMap::getDrawBounds(Rect& bounds) const
+{
+    // the map draws nothing, its layers do
+    bounds = Rect::ZERO;
+    return typeid(*this) == typeid(TMXTiledMap);
+}
+
 int TMXTiledMap::getLayerNum()
 {
     return _tmxLayerNum;
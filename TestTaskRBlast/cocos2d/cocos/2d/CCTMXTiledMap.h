@@ -272,6 +272,7 @@ public:
      * @js NA
      */
     virtual std::string getDescription() const override;
+    virtual bool getDrawBounds(Rect& bounds) const override;
 
     int  getLayerNum();
     const std::string& getResourceFile() const { return _tmxFile; }
@@ -0,0 +1,564 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCTweenManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "2d/CCNode.h"
+#include "base/ccMacros.h"
+#include "math/MathUtil.h"
+
+NS_CC_BEGIN
+
+enum
+{
+    TWEEN_FIRST_TICK = 1 << 0,  // the first update sets the elapsed time to MATH_EPSILON, like ActionInterval
+    TWEEN_PAUSED = 1 << 1,
+    TWEEN_FINISHED = 1 << 2     // done or removed, waits for removeFinishedTweens()
+};
+
+static const unsigned int SLOT_CHANNEL_SHIFT = 30;
+static const unsigned int SLOT_INDEX_MASK = (1u << SLOT_CHANNEL_SHIFT) - 1;
+static const unsigned int INVALID_SLOT = ~0u;
+
+// same as RotateTo
+static void calculateAngles(float& startAngle, float& diffAngle, float dstAngle)
+{
+    if (startAngle > 0)
+    {
+        startAngle = fmodf(startAngle, 360.0f);
+    }
+    else
+    {
+        startAngle = fmodf(startAngle, -360.0f);
+    }
+
+    diffAngle = dstAngle - startAngle;
+    if (diffAngle > 180)
+    {
+        diffAngle -= 360;
+    }
+    if (diffAngle < -180)
+    {
+        diffAngle += 360;
+    }
+}
+
+// keeps the elements of the running tweens, in order
+template <typename T>
+static void compact(std::vector<T>& values, const std::vector<unsigned char>& flags)
+{
+    size_t kept = 0;
+    for (size_t i = 0, count = values.size(); i < count; ++i)
+    {
+        if (!(flags[i] & TWEEN_FINISHED))
+        {
+            values[kept++] = values[i];
+        }
+    }
+    values.resize(kept);
+}
+
+// implementation of Tween
+
+Tween::Tween(Property property, Mode mode, float duration, float x, float y)
+: _property(property)
+, _mode(mode)
+, _easing(tweenfunc::Linear)
+, _period(0.3f)
+, _duration(duration)
+, _x(x)
+, _y(y)
+, _tag(INVALID_TAG)
+{
+}
+
+Tween Tween::moveTo(float duration, const Vec2& position)
+{
+    return Tween(Property::POSITION, Mode::TO, duration, position.x, position.y);
+}
+
+Tween Tween::moveBy(float duration, const Vec2& deltaPosition)
+{
+    return Tween(Property::POSITION, Mode::BY, duration, deltaPosition.x, deltaPosition.y);
+}
+
+Tween Tween::scaleTo(float duration, float scale)
+{
+    return Tween(Property::SCALE, Mode::TO, duration, scale, scale);
+}
+
+Tween Tween::scaleTo(float duration, float scaleX, float scaleY)
+{
+    return Tween(Property::SCALE, Mode::TO, duration, scaleX, scaleY);
+}
+
+Tween Tween::scaleBy(float duration, float scale)
+{
+    return Tween(Property::SCALE, Mode::SCALE_BY, duration, scale, scale);
+}
+
+Tween Tween::scaleBy(float duration, float scaleX, float scaleY)
+{
+    return Tween(Property::SCALE, Mode::SCALE_BY, duration, scaleX, scaleY);
+}
+
+Tween Tween::rotateTo(float duration, float angle)
+{
+    return Tween(Property::ROTATION, Mode::TO, duration, angle, angle);
+}
+
+Tween Tween::rotateBy(float duration, float deltaAngle)
+{
+    return Tween(Property::ROTATION, Mode::BY, duration, deltaAngle, deltaAngle);
+}
+
+Tween Tween::fadeTo(float duration, GLubyte opacity)
+{
+    return Tween(Property::OPACITY, Mode::TO, duration, opacity, 0.0f);
+}
+
+Tween Tween::fadeIn(float duration)
+{
+    return fadeTo(duration, 255);
+}
+
+Tween Tween::fadeOut(float duration)
+{
+    return fadeTo(duration, 0);
+}
+
+Tween& Tween::setEasing(tweenfunc::TweenType easing, float period)
+{
+    CCASSERT(easing != tweenfunc::CUSTOM_EASING, "Custom easings need an action");
+    _easing = easing;
+    _period = period;
+    return *this;
+}
+
+// implementation of TweenManager
+
+TweenManager::TweenManager()
+: _runningTweens(0)
+, _locked(false)
+, _hasFinishedTweens(false)
+{
+}
+
+TweenManager::~TweenManager()
+{
+    CCLOGINFO("deallocing TweenManager: %p", this);
+    removeAllTweens();
+}
+
+void TweenManager::addTween(const Tween& tween, Node* target, bool paused)
+{
+    CCASSERT(target != nullptr, "target can't be nullptr!");
+
+    float fromX = 0.0f;
+    float fromY = 0.0f;
+    float deltaX = 0.0f;
+    float deltaY = 0.0f;
+    switch (tween._property)
+    {
+    case Tween::Property::POSITION:
+        fromX = target->getPositionX();
+        fromY = target->getPositionY();
+        break;
+    case Tween::Property::SCALE:
+        fromX = target->getScaleX();
+        fromY = target->getScaleY();
+        break;
+    case Tween::Property::ROTATION:
+        fromX = target->getRotationSkewX();
+        fromY = target->getRotationSkewY();
+        break;
+    case Tween::Property::OPACITY:
+        fromX = target->getOpacity();
+        break;
+    }
+    switch (tween._mode)
+    {
+    case Tween::Mode::TO:
+        if (tween._property == Tween::Property::ROTATION)
+        {
+            calculateAngles(fromX, deltaX, tween._x);
+            calculateAngles(fromY, deltaY, tween._y);
+        }
+        else
+        {
+            deltaX = tween._x - fromX;
+            deltaY = tween._y - fromY;
+        }
+        break;
+    case Tween::Mode::BY:
+        deltaX = tween._x;
+        deltaY = tween._y;
+        break;
+    case Tween::Mode::SCALE_BY:
+        deltaX = fromX * tween._x - fromX;
+        deltaY = fromY * tween._y - fromY;
+        break;
+    }
+
+    const unsigned int channelIndex = static_cast<unsigned int>(tween._property);
+    Channel& channel = _channels[channelIndex];
+    CCASSERT(channel.targets.size() < SLOT_INDEX_MASK, "Too many tweens!");
+    _targetSlots[target].push_back((channelIndex << SLOT_CHANNEL_SHIFT) | static_cast<unsigned int>(channel.targets.size()));
+    channel.targets.push_back(target);
+    channel.fromX.push_back(fromX);
+    channel.fromY.push_back(fromY);
+    channel.deltaX.push_back(deltaX);
+    channel.deltaY.push_back(deltaY);
+    channel.elapsed.push_back(0.0f);
+    channel.rates.push_back(0.0f);
+    channel.durations.push_back(std::abs(tween._duration) <= MATH_EPSILON ? MATH_EPSILON : tween._duration);
+    channel.periods.push_back(tween._period);
+    channel.progress.push_back(0.0f);
+    channel.valuesY.push_back(0.0f);
+    channel.tags.push_back(tween._tag);
+    channel.easings.push_back(tween._easing);
+    channel.flags.push_back(TWEEN_FIRST_TICK | (paused ? TWEEN_PAUSED : 0));
+
+    target->retain();
+    ++target->_runningTweens;
+    ++_runningTweens;
+}
+
+// Marks the tween finished, it is removed from the arrays at the end of the update.
+void TweenManager::removeTween(Channel& channel, size_t index)
+{
+    channel.flags[index] |= TWEEN_FINISHED;
+    channel.rates[index] = 0.0f;
+    --channel.targets[index]->_runningTweens;
+    --_runningTweens;
+    _hasFinishedTweens = true;
+}
+
+void TweenManager::removeAllTweens()
+{
+    for (auto& channel : _channels)
+    {
+        for (size_t i = 0, count = channel.flags.size(); i < count; ++i)
+        {
+            if (!(channel.flags[i] & TWEEN_FINISHED))
+            {
+                removeTween(channel, i);
+            }
+        }
+    }
+    _targetSlots.clear();
+    removeFinishedTweens();
+}
+
+void TweenManager::removeAllTweensFromTarget(Node* target)
+{
+    if (target == nullptr || target->_runningTweens == 0)
+    {
+        return;
+    }
+    removeTargetTweens(target, false, Tween::INVALID_TAG);
+}
+
+void TweenManager::removeAllTweensByTag(int tag, Node* target)
+{
+    CCASSERT(tag != Tween::INVALID_TAG, "Invalid tag value!");
+    if (target == nullptr || target->_runningTweens == 0)
+    {
+        return;
+    }
+    removeTargetTweens(target, true, tag);
+}
+
+// Outside of an update the tweens release their node at once, they stay in the arrays
+// without target until the next compaction. In an update the compaction releases it.
+void TweenManager::removeTargetTweens(Node* target, bool byTag, int tag)
+{
+    auto iter = _targetSlots.find(target);
+    if (iter == _targetSlots.end())
+    {
+        return;
+    }
+
+    int released = 0;
+    for (auto slot : iter->second)
+    {
+        Channel& channel = _channels[slot >> SLOT_CHANNEL_SHIFT];
+        size_t index = slot & SLOT_INDEX_MASK;
+        if ((channel.flags[index] & TWEEN_FINISHED) || (byTag && channel.tags[index] != tag))
+        {
+            continue;
+        }
+        removeTween(channel, index);
+        if (!_locked)
+        {
+            channel.targets[index] = nullptr;
+            ++released;
+        }
+    }
+    if (target->_runningTweens == 0)
+    {
+        _targetSlots.erase(iter);
+    }
+
+    // last, the node may be deleted
+    for (int i = 0; i < released; ++i)
+    {
+        target->release();
+    }
+}
+
+ssize_t TweenManager::getNumberOfRunningTweensInTarget(const Node* target) const
+{
+    return target ? target->_runningTweens : 0;
+}
+
+void TweenManager::pauseTarget(Node* target)
+{
+    if (target == nullptr || target->_runningTweens == 0)
+    {
+        return;
+    }
+
+    auto iter = _targetSlots.find(target);
+    if (iter == _targetSlots.end())
+    {
+        return;
+    }
+
+    for (auto slot : iter->second)
+    {
+        Channel& channel = _channels[slot >> SLOT_CHANNEL_SHIFT];
+        size_t index = slot & SLOT_INDEX_MASK;
+        channel.flags[index] |= TWEEN_PAUSED;
+        channel.rates[index] = 0.0f;
+    }
+}
+
+void TweenManager::resumeTarget(Node* target)
+{
+    if (target == nullptr || target->_runningTweens == 0)
+    {
+        return;
+    }
+
+    auto iter = _targetSlots.find(target);
+    if (iter == _targetSlots.end())
+    {
+        return;
+    }
+
+    for (auto slot : iter->second)
+    {
+        Channel& channel = _channels[slot >> SLOT_CHANNEL_SHIFT];
+        size_t index = slot & SLOT_INDEX_MASK;
+        unsigned char flags = channel.flags[index];
+        if (flags & TWEEN_PAUSED)
+        {
+            channel.flags[index] = flags & ~TWEEN_PAUSED;
+            // a tween that never ran still waits for its first tick
+            channel.rates[index] = (flags & (TWEEN_FIRST_TICK | TWEEN_FINISHED)) ? 0.0f : 1.0f;
+        }
+    }
+}
+
+void TweenManager::update(float dt)
+{
+    // the setters of the nodes may run, pause or stop tweens, the new ones are appended
+    // and updated from the next frame, the stopped ones are only marked until the end
+    _locked = true;
+    updateChannel(Tween::Property::POSITION, dt);
+    updateChannel(Tween::Property::SCALE, dt);
+    updateChannel(Tween::Property::ROTATION, dt);
+    updateChannel(Tween::Property::OPACITY, dt);
+    _locked = false;
+
+    removeFinishedTweens();
+}
+
+void TweenManager::updateChannel(Tween::Property property, float dt)
+{
+    Channel& channel = _channels[static_cast<int>(property)];
+    const size_t count = channel.targets.size();
+    if (count == 0)
+    {
+        return;
+    }
+
+    // advance the time of the running tweens
+    float* elapsed = channel.elapsed.data();
+    const float* rates = channel.rates.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        elapsed[i] += dt * rates[i];
+    }
+
+    // ease, same as ActionInterval::step() and the ease actions
+    float* progress = channel.progress.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        unsigned char flags = channel.flags[i];
+        if (flags & TWEEN_FIRST_TICK)
+        {
+            if (flags & (TWEEN_PAUSED | TWEEN_FINISHED))
+            {
+                continue;
+            }
+            channel.flags[i] = flags & ~TWEEN_FIRST_TICK;
+            channel.rates[i] = 1.0f;
+            elapsed[i] = MATH_EPSILON;
+        }
+        float time = std::max(0.0f, std::min(1.0f, elapsed[i] / channel.durations[i]));
+        tweenfunc::TweenType easing = channel.easings[i];
+        progress[i] = easing == tweenfunc::Linear ? time : tweenfunc::tweenTo(time, easing, &channel.periods[i]);
+    }
+
+    // interpolate, the x values replace the progress
+    if (property != Tween::Property::OPACITY)
+    {
+        MathUtil::lerpDeltas(channel.fromY.data(), channel.deltaY.data(), progress, channel.valuesY.data(), count);
+    }
+    MathUtil::lerpDeltas(channel.fromX.data(), channel.deltaX.data(), progress, progress, count);
+
+    // apply, by index: a setter may run a tween and grow the arrays
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (channel.flags[i] & (TWEEN_FIRST_TICK | TWEEN_PAUSED | TWEEN_FINISHED))
+        {
+            continue;
+        }
+
+        Node* target = channel.targets[i];
+        float x = channel.progress[i];
+        float y = channel.valuesY[i];
+        switch (property)
+        {
+        case Tween::Property::POSITION:
+            target->setPosition(x, y);
+            break;
+        case Tween::Property::SCALE:
+            target->setScale(x, y);
+            break;
+        case Tween::Property::ROTATION:
+            if (x == y)
+            {
+                target->setRotation(x);
+            }
+            else
+            {
+                target->setRotationSkewX(x);
+                target->setRotationSkewY(y);
+            }
+            break;
+        case Tween::Property::OPACITY:
+            target->setOpacity(static_cast<GLubyte>(x));
+            break;
+        }
+
+        // the setter may have stopped the tween
+        if (channel.elapsed[i] >= channel.durations[i] && !(channel.flags[i] & TWEEN_FINISHED))
+        {
+            removeTween(channel, i);
+        }
+    }
+}
+
+void TweenManager::removeFinishedTweens()
+{
+    if (_locked || !_hasFinishedTweens)
+    {
+        return;
+    }
+    _locked = true;
+    _hasFinishedTweens = false;
+
+    for (unsigned int c = 0; c < 4; ++c)
+    {
+        Channel& channel = _channels[c];
+        std::vector<unsigned int>& indices = _compactedIndices[c];
+        indices.resize(channel.flags.size());
+        unsigned int kept = 0;
+        for (size_t i = 0, count = channel.flags.size(); i < count; ++i)
+        {
+            if (channel.flags[i] & TWEEN_FINISHED)
+            {
+                indices[i] = INVALID_SLOT;
+                // the tweens removed outside of an update have released their node already
+                if (channel.targets[i] != nullptr)
+                {
+                    _releasedTargets.push_back(channel.targets[i]);
+                }
+            }
+            else
+            {
+                indices[i] = kept++;
+            }
+        }
+        compact(channel.targets, channel.flags);
+        compact(channel.fromX, channel.flags);
+        compact(channel.fromY, channel.flags);
+        compact(channel.deltaX, channel.flags);
+        compact(channel.deltaY, channel.flags);
+        compact(channel.elapsed, channel.flags);
+        compact(channel.rates, channel.flags);
+        compact(channel.durations, channel.flags);
+        compact(channel.periods, channel.flags);
+        compact(channel.progress, channel.flags);
+        compact(channel.valuesY, channel.flags);
+        compact(channel.tags, channel.flags);
+        compact(channel.easings, channel.flags);
+        compact(channel.flags, channel.flags);
+    }
+
+    // renumber the slots, the nodes without tween left are dropped
+    for (auto iter = _targetSlots.begin(); iter != _targetSlots.end();)
+    {
+        std::vector<unsigned int>& slots = iter->second;
+        size_t kept = 0;
+        for (auto slot : slots)
+        {
+            unsigned int index = _compactedIndices[slot >> SLOT_CHANNEL_SHIFT][slot & SLOT_INDEX_MASK];
+            if (index != INVALID_SLOT)
+            {
+                slots[kept++] = (slot & ~SLOT_INDEX_MASK) | index;
+            }
+        }
+        slots.resize(kept);
+        iter = kept ? std::next(iter) : _targetSlots.erase(iter);
+    }
+
+    // last, a released node may be deleted and its destructor may run or stop tweens,
+    // the ones it stops are removed with the next finished tweens
+    for (size_t i = 0; i < _releasedTargets.size(); ++i)
+    {
+        _releasedTargets[i]->release();
+    }
+    _releasedTargets.clear();
+    _locked = false;
+}
+
+NS_CC_END
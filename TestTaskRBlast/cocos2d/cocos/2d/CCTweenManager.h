@@ -0,0 +1,218 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCTWEEN_MANAGER_H__
+#define __CCTWEEN_MANAGER_H__
+
+#include <unordered_map>
+#include <vector>
+#include "2d/CCTweenFunction.h"
+#include "base/CCRef.h"
+#include "math/Vec2.h"
+#include "platform/CCGL.h"
+
+NS_CC_BEGIN
+
+class Node;
+
+/**
+ * @addtogroup actions
+ * @{
+ */
+
+/** @class Tween
+ @brief A tween describes the interpolation of one property of a node: its position, scale, rotation or opacity.
+
+ It is a small value run with Node::runTween(). The tweens behave like MoveTo, MoveBy, ScaleTo, ScaleBy,
+ RotateTo, RotateBy and FadeTo wrapped in an ease action, but the TweenManager keeps them in flat arrays,
+ so running one allocates no object.
+ */
+class CC_DLL Tween
+{
+public:
+    /** Default tag used for all the tweens. */
+    static const int INVALID_TAG = -1;
+
+    enum class Property : unsigned char
+    {
+        POSITION,
+        SCALE,
+        ROTATION,
+        OPACITY
+    };
+
+    /** Moves the node to a position. */
+    static Tween moveTo(float duration, const Vec2& position);
+    /** Moves the node by a distance. */
+    static Tween moveBy(float duration, const Vec2& deltaPosition);
+    /** Scales the node to a scale. */
+    static Tween scaleTo(float duration, float scale);
+    static Tween scaleTo(float duration, float scaleX, float scaleY);
+    /** Multiplies the scale of the node. */
+    static Tween scaleBy(float duration, float scale);
+    static Tween scaleBy(float duration, float scaleX, float scaleY);
+    /** Rotates the node to an angle in degrees, the short way round like RotateTo. */
+    static Tween rotateTo(float duration, float angle);
+    /** Rotates the node by an angle in degrees. */
+    static Tween rotateBy(float duration, float deltaAngle);
+    /** Fades the node to an opacity. */
+    static Tween fadeTo(float duration, GLubyte opacity);
+    static Tween fadeIn(float duration);
+    static Tween fadeOut(float duration);
+
+    /** Sets the easing of the tween, linear by default.
+     * @param easing Any easing but tweenfunc::CUSTOM_EASING.
+     * @param period The period of the elastic easings.
+     */
+    Tween& setEasing(tweenfunc::TweenType easing, float period = 0.3f);
+    /** Sets a tag to stop the tween with Node::stopAllTweensByTag(). */
+    Tween& setTag(int tag) { _tag = tag; return *this; }
+
+    Property getProperty() const { return _property; }
+    float getDuration() const { return _duration; }
+    tweenfunc::TweenType getEasing() const { return _easing; }
+    int getTag() const { return _tag; }
+
+protected:
+    enum class Mode : unsigned char
+    {
+        TO,
+        BY,
+        SCALE_BY
+    };
+
+    Tween(Property property, Mode mode, float duration, float x, float y);
+
+    Property _property;
+    Mode _mode;
+    tweenfunc::TweenType _easing;
+    float _period;
+    float _duration;
+    float _x;
+    float _y;
+    int _tag;
+
+    friend class TweenManager;
+};
+
+/** @class TweenManager
+ @brief TweenManager runs the tweens of the nodes, next to the ActionManager.
+
+ The tweens of a property are stored by field in contiguous arrays: the times are advanced and the values
+ interpolated for all of them in a few loops, MathUtil::lerpDeltas() uses SSE2 or AVX2 where available.
+ Only the easing and the setters of the nodes are called per tween.
+
+ The tweens of a node are indexed by slot, so stopping, pausing and resuming them does not scan the arrays.
+ A stopped tween is only marked, the arrays are compacted once at the end of update().
+
+ Tweens and actions can run on the same node. A tween retains its node like an action, follows Node::pause()
+ and Node::resume() and stops with Node::cleanup(). It is updated after the actions, so a tween wins over an
+ action on the same property. The tweens of a property on a node are updated in the order they were run.
+ */
+class CC_DLL TweenManager : public Ref
+{
+public:
+    /**
+     * @js ctor
+     */
+    TweenManager();
+
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual ~TweenManager();
+
+    /** Starts a tween on a node, the start value is the current value of the property.
+     * When paused is true, the tween starts on resumeTarget().
+     */
+    void addTween(const Tween& tween, Node* target, bool paused);
+
+    /** Removes all the tweens of all the nodes. */
+    void removeAllTweens();
+
+    /** Removes all the tweens of a node. */
+    void removeAllTweensFromTarget(Node* target);
+
+    /** Removes all the tweens of a node with a tag. */
+    void removeAllTweensByTag(int tag, Node* target);
+
+    /** Returns the number of tweens running on a node. */
+    ssize_t getNumberOfRunningTweensInTarget(const Node* target) const;
+
+    /** Returns the number of tweens running on all the nodes. */
+    ssize_t getNumberOfRunningTweens() const { return _runningTweens; }
+
+    /** Pauses the tweens of a node. */
+    void pauseTarget(Node* target);
+
+    /** Resumes the tweens of a node. */
+    void resumeTarget(Node* target);
+
+    /** Main loop of TweenManager.
+     * @param dt    In seconds.
+     */
+    void update(float dt);
+
+protected:
+    // the tweens of one property by field, an index is a tween
+    struct Channel
+    {
+        std::vector<Node*> targets;
+        std::vector<float> fromX;
+        std::vector<float> fromY;
+        std::vector<float> deltaX;
+        std::vector<float> deltaY;
+        std::vector<float> elapsed;
+        std::vector<float> rates;           // 1 while the time runs, 0 before the first update and when paused
+        std::vector<float> durations;
+        std::vector<float> periods;
+        std::vector<float> progress;        // eased, then the interpolated x
+        std::vector<float> valuesY;
+        std::vector<int> tags;
+        std::vector<tweenfunc::TweenType> easings;
+        std::vector<unsigned char> flags;
+    };
+
+    void updateChannel(Tween::Property property, float dt);
+    void removeTween(Channel& channel, size_t index);
+    void removeTargetTweens(Node* target, bool byTag, int tag);
+    void removeFinishedTweens();
+
+    Channel _channels[4];
+    // the slots of the tweens of each node, a slot is the channel in the high bits and the index
+    std::unordered_map<Node*, std::vector<unsigned int>> _targetSlots;
+    std::vector<unsigned int> _compactedIndices[4];
+    ssize_t _runningTweens;
+    bool _locked;                           // the channels are being updated or compacted
+    bool _hasFinishedTweens;
+    std::vector<Node*> _releasedTargets;
+};
+
+// end of actions group
+/// @}
+
+NS_CC_END
+
+#endif // __CCTWEEN_MANAGER_H__
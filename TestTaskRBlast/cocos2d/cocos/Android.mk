@@ -25,6 +25,7 @@ cocos2d.cpp \
 2d/CCActionInstant.cpp \
 2d/CCActionInterval.cpp \
 2d/CCActionManager.cpp \
+2d/CCTweenManager.cpp \
 2d/CCActionPageTurn3D.cpp \
 2d/CCActionProgressTimer.cpp \
 2d/CCActionTiledGrid.cpp \
@@ -73,6 +74,8 @@ cocos2d.cpp \
 2d/CCRenderTexture.cpp \
 2d/CCScene.cpp \
 2d/CCSprite.cpp \
+2d/CCStaticNode.cpp \
+2d/CCParallelVisit.cpp \
 2d/CCSpriteBatchNode.cpp \
 2d/CCSpriteFrame.cpp \
 2d/CCSpriteFrameCache.cpp \
@@ -108,6 +111,7 @@ math/Vec4.cpp \
 base/CCNinePatchImageParser.cpp \
 base/CCStencilStateManager.cpp \
 base/CCAsyncTaskPool.cpp \
+base/CCWorkStealingPool.cpp \
 base/CCAutoreleasePool.cpp \
 base/CCConfiguration.cpp \
 base/CCConsole.cpp \
@@ -136,6 +140,7 @@ base/CCEventTouch.cpp \
 base/CCIMEDispatcher.cpp \
 base/CCNS.cpp \
 base/CCProfiling.cpp \
+base/CCTrace.cpp \
 base/CCProperties.cpp \
 base/CCRef.cpp \
 base/CCScheduler.cpp \
@@ -181,6 +186,7 @@ renderer/CCTechnique.cpp \
 renderer/CCTexture2D.cpp \
 renderer/CCTextureAtlas.cpp \
 renderer/CCTextureCache.cpp \
+renderer/CCDynamicAtlas.cpp \
 renderer/CCTextureCube.cpp \
 renderer/CCTrianglesCommand.cpp \
 renderer/CCVertexAttribBinding.cpp \
@@ -171,6 +171,18 @@ public:
      */
     bool supportsMapBuffer() const;
 
+    /** Whether or not unsynchronized glMapBufferRange() and fence syncs are supported.
+     *
+     * @return Is true if supports GL_ARB_map_buffer_range and GL_ARB_sync.
+     */
+    bool supportsMapBufferRange() const;
+
+    /** Whether or not immutable buffers that stay mapped while the GPU reads them are supported.
+     *
+     * @return Is true if supports GL_ARB_buffer_storage.
+     */
+    bool supportsBufferStorage() const;
+
     
     /** Max support directional light in shader, for Sprite3D.
      *
@@ -268,6 +280,8 @@ protected:
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
     bool            _supportsOESMapBuffer;
+    bool            _supportsMapBufferRange;
+    bool            _supportsBufferStorage;
     bool            _supportsOESDepth24;
     bool            _supportsOESPackedDepthStencil;
     
@@ -69,6 +69,7 @@
 #include "base/base64.h"
 #include "base/ccUtils.h"
 #include "base/allocator/CCAllocatorDiagnostics.h"
+#include "base/CCTrace.h"
 NS_CC_BEGIN
 
 extern const char* cocos2dVersion(void);
@@ -507,6 +508,9 @@ Console::Console()
     createCommandSceneGraph();
     createCommandTexture();
     createCommandTouch();
+#if CC_ENABLE_TRACING
+    createCommandTrace();
+#endif
     createCommandUpload();
     createCommandVersion();
 }
@@ -1125,6 +1129,14 @@ void Console::createCommandTouch()
         CC_CALLBACK_2(Console::commandTouchSubCommandSwipe, this)});
 }
 
+#if CC_ENABLE_TRACING
+void Console::createCommandTrace()
+{
+    addCommand({"trace", "Write the last frames as a Chrome trace into the writable path. Args: [-h | help | frames [filename] | ]",
+        CC_CALLBACK_2(Console::commandTrace, this)});
+}
+#endif
+
 void Console::createCommandUpload()
 {
     addCommand({"upload", "upload file. Args: [filename base64_encoded_data]", CC_CALLBACK_1(Console::commandUpload, this)});
@@ -1470,6 +1482,7 @@ void Console::commandTouchSubCommandSwipe(int fd, const std::string& args)
     }
 }
 
+
 static char invalid_filename_char[] = {':', '/', '\\', '?', '%', '*', '<', '>', '"', '|', '\r', '\n', '\t'};
 
 void Console::commandUpload(int fd)
@@ -1549,6 +1562,38 @@ void Console::commandUpload(int fd)
     fclose(fp);
 }
 
+#if CC_ENABLE_TRACING
+void Console::commandTrace(int fd, const std::string& args)
+{
+    unsigned frames = 60;
+    std::string filename = "trace.json";
+    auto argv = Console::Utility::split(args, ' ');
+    if (!argv.empty() && !argv[0].empty())
+    {
+        frames = static_cast<unsigned>(std::max(utils::atof(argv[0].c_str()), 1.0));
+    }
+    if (argv.size() > 1 && !argv[1].empty())
+    {
+        filename = argv[1];
+    }
+    for (char c : invalid_filename_char)
+    {
+        if (filename.find(c) != std::string::npos)
+        {
+            Console::Utility::mydprintf(fd, "trace: invalid file name!\n");
+            return;
+        }
+    }
+
+    // the ring buffers are read without stopping the threads that write them
+    std::string path = FileUtils::getInstance()->getWritablePath() + filename;
+    if (Trace::writeJson(path, frames))
+        Console::Utility::mydprintf(fd, "trace: wrote %u frames to %s\n", frames, path.c_str());
+    else
+        Console::Utility::mydprintf(fd, "trace: can't write %s\n", path.c_str());
+}
+#endif
+
 void Console::commandVersion(int fd, const std::string& /*args*/)
 {
     Console::Utility::mydprintf(fd, "%s\n", cocos2dVersion());
@@ -239,6 +239,9 @@ protected:
     void createCommandSceneGraph();
     void createCommandTexture();
     void createCommandTouch();
+#if CC_ENABLE_TRACING
+    void createCommandTrace();
+#endif
     void createCommandUpload();
     void createCommandVersion();
 
@@ -268,6 +271,9 @@ protected:
     void commandTexturesSubCommandFlush(int fd, const std::string& args);
     void commandTouchSubCommandTap(int fd, const std::string& args);
     void commandTouchSubCommandSwipe(int fd, const std::string& args);
+#if CC_ENABLE_TRACING
+    void commandTrace(int fd, const std::string& args);
+#endif
     void commandUpload(int fd);
     void commandVersion(int fd, const std::string& args);
     // file descriptor: socket, console, etc.
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "platform/CCFileUtils.h"
 
 #include "2d/CCActionManager.h"
+#include "2d/CCTweenManager.h"
 #include "2d/CCFontFNT.h"
 #include "2d/CCFontAtlasCache.h"
 #include "2d/CCAnimationCache.h"
@@ -51,6 +52,7 @@ THE SOFTWARE.
 #include "renderer/CCRenderState.h"
 #include "renderer/CCFrameBuffer.h"
 #include "2d/CCCamera.h"
+#include "2d/CCParallelVisit.h"
 #include "base/CCUserDefault.h"
 #include "base/ccFPSImages.h"
 #include "base/CCScheduler.h"
@@ -62,6 +64,7 @@ THE SOFTWARE.
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
 #include "base/ObjectFactory.h"
+#include "base/CCTrace.h"
 #include "platform/CCApplication.h"
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -116,6 +119,7 @@ Director::Director()
 
 bool Director::init()
 {
+    CC_TRACE_THREAD_NAME("Main");
     setDefaultValues();
 
     _scenesStack.reserve(15);
@@ -130,6 +134,9 @@ bool Director::init()
     // action manager
     _actionManager = new (std::nothrow) ActionManager();
     _scheduler->scheduleUpdate(_actionManager, Scheduler::PRIORITY_SYSTEM, false);
+    // tween manager, after the actions
+    _tweenManager = new (std::nothrow) TweenManager();
+    _scheduler->scheduleUpdate(_tweenManager, Scheduler::PRIORITY_SYSTEM, false);
 
     _eventDispatcher = new (std::nothrow) EventDispatcher();
     
@@ -172,6 +179,7 @@ Director::~Director()
     CC_SAFE_RELEASE(_notificationNode);
     CC_SAFE_RELEASE(_scheduler);
     CC_SAFE_RELEASE(_actionManager);
+    CC_SAFE_RELEASE(_tweenManager);
 
     CC_SAFE_RELEASE(_beforeSetNextScene);
     CC_SAFE_RELEASE(_afterSetNextScene);
@@ -183,6 +191,7 @@ Director::~Director()
     CC_SAFE_RELEASE(_eventProjectionChanged);
     CC_SAFE_RELEASE(_eventResetDirector);
 
+    delete _parallelVisit;
     delete _renderer;
     delete _console;
 
@@ -251,11 +260,15 @@ void Director::setGLDefaultValues()
 // Draw the Scene
 void Director::drawScene()
 {
+    CC_TRACE_FRAME();
+    CC_TRACE_SCOPE("Director::drawScene");
+
     // calculate "global" dt
     calculateDeltaTime();
     
     if (_openGLView)
     {
+        CC_TRACE_SCOPE("GLView::pollEvents");
         _openGLView->pollEvents();
     }
 
@@ -292,7 +305,10 @@ void Director::drawScene()
         
         //render the scene
         if(_openGLView)
+        {
+            CC_TRACE_SCOPE("GLView::renderScene");
             _openGLView->renderScene(_runningScene, _renderer);
+        }
         
         _eventDispatcher->dispatchEvent(_eventAfterVisit);
     }
@@ -323,6 +339,7 @@ void Director::drawScene()
     // swap buffers
     if (_openGLView)
     {
+        CC_TRACE_SCOPE("GLView::swapBuffers");
         _openGLView->swapBuffers();
     }
 
@@ -725,6 +742,21 @@ void Director::setAlphaBlending(bool on)
     CHECK_GL_ERROR_DEBUG();
 }
 
+void Director::setParallelVisitThreads(unsigned threads, size_t minChildren)
+{
+    delete _parallelVisit;
+    _parallelVisit = nullptr;
+
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads > 1)
+    {
+        _parallelVisit = new (std::nothrow) ParallelVisit(threads, minChildren);
+    }
+}
+
 void Director::setDepthTest(bool on)
 {
     _renderer->setDepthTest(on);
@@ -1141,8 +1173,9 @@ void Director::restartDirector()
     // Texture cache need to be reinitialized
     initTextureCache();
     
-    // Reschedule for action manager
+    // Reschedule for action manager and tween manager
     getScheduler()->scheduleUpdate(getActionManager(), Scheduler::PRIORITY_SYSTEM, false);
+    getScheduler()->scheduleUpdate(getTweenManager(), Scheduler::PRIORITY_SYSTEM, false);
     
     // release the objects
     PoolManager::getInstance()->getCurrentPool()->clear();
@@ -1434,6 +1467,16 @@ void Director::setActionManager(ActionManager* actionManager)
     }    
 }
 
+void Director::setTweenManager(TweenManager* tweenManager)
+{
+    if (_tweenManager != tweenManager)
+    {
+        CC_SAFE_RETAIN(tweenManager);
+        CC_SAFE_RELEASE(_tweenManager);
+        _tweenManager = tweenManager;
+    }
+}
+
 void Director::setEventDispatcher(EventDispatcher* dispatcher)
 {
     if (_eventDispatcher != dispatcher)
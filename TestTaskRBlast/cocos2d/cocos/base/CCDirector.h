@@ -55,11 +55,13 @@ class DirectorDelegate;
 class Node;
 class Scheduler;
 class ActionManager;
+class TweenManager;
 class EventDispatcher;
 class EventCustom;
 class EventListenerCustom;
 class TextureCache;
 class Renderer;
+class ParallelVisit;
 class Camera;
 
 class Console;
@@ -441,6 +443,12 @@ public:
      * @since v2.0
      */
     void setActionManager(ActionManager* actionManager);
+
+    /** Gets the TweenManager associated with this director. */
+    TweenManager* getTweenManager() const { return _tweenManager; }
+
+    /** Sets the TweenManager associated with this director. */
+    void setTweenManager(TweenManager* tweenManager);
     
     /** Gets the EventDispatcher associated with this director.
      * @since v3.0
@@ -459,6 +467,17 @@ public:
      */
     Renderer* getRenderer() const { return _renderer; }
 
+    /** Visits the children of nodes with many children on worker threads, see ParallelVisit.
+     * The render queue is the same as after a serial visit.
+     *
+     * @param threads The number of threads including the main one, 0 uses one per core and 1 turns it off, the default.
+     * @param minChildren The number of children from which a node visits them in parallel.
+     */
+    void setParallelVisitThreads(unsigned threads, size_t minChildren = 64);
+
+    /** Returns the ParallelVisit, or nullptr when the scene is visited on the main thread only. */
+    ParallelVisit* getParallelVisit() const { return _parallelVisit; }
+
     /** Returns the Console associated with this director.
      * @since v3.0
      * @js NA
@@ -632,6 +651,10 @@ protected:
      @since v2.0
      */
     ActionManager *_actionManager = nullptr;
+
+    /** TweenManager associated with this director, updated after the ActionManager
+     */
+    TweenManager *_tweenManager = nullptr;
     
     /** EventDispatcher associated with this director
      @since v3.0
@@ -711,6 +734,9 @@ protected:
     /* Renderer for the Director */
     Renderer *_renderer = nullptr;
 
+    /* visits the scene on several threads, nullptr if it is visited on the main thread */
+    ParallelVisit *_parallelVisit = nullptr;
+
     /* Console for the director */
     Console *_console = nullptr;
 
@@ -38,6 +38,7 @@
 #include "2d/CCScene.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
+#include "base/CCTrace.h"
 #include "2d/CCCamera.h"
 
 #define DUMP_LISTENER_ITEM_PRIORITY_INFO 0
@@ -200,9 +201,9 @@ void EventDispatcher::EventListenerVector::clear()
 
 
 EventDispatcher::EventDispatcher()
-: _inDispatch(0)
+: _nodePriorityRoot(nullptr)
+, _inDispatch(0)
 , _isEnabled(false)
-, _nodePriorityIndex(0)
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
@@ -222,73 +223,44 @@ EventDispatcher::~EventDispatcher()
     removeAllEventListeners();
 }
 
-void EventDispatcher::visitTarget(Node* node, bool isRootNode)
+void EventDispatcher::updateNodePriority(Node* node, Node* rootNode, NodePriority& priority) const
 {
-    node->sortAllChildren();
-    
-    int i = 0;
-    auto& children = node->getChildren();
-    
-    auto childrenCount = children.size();
-    
-    if(childrenCount > 0)
-    {
-        Node* child = nullptr;
-        // visit children zOrder < 0
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            
-            if ( child && child->getLocalZOrder() < 0 )
-                visitTarget(child, false);
-            else
-                break;
-        }
-        
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-        
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            if (child)
-                visitTarget(child, false);
-        }
-    }
-    else
-    {
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-    }
-    
-    if (isRootNode)
+    priority.globalZOrder = node->getGlobalZOrder();
+    priority.path.clear();
+
+    // Same order as Node::sortNodes() uses for the siblings
+    Node* n = node;
+    while (n != rootNode && n != nullptr)
     {
-        std::vector<float> globalZOrders;
-        globalZOrders.reserve(_globalZOrderNodeMap.size());
-        
-        for (const auto& e : _globalZOrderNodeMap)
-        {
-            globalZOrders.push_back(e.first);
-        }
-        
-        std::stable_sort(globalZOrders.begin(), globalZOrders.end(), [](const float a, const float b){
-            return a < b;
-        });
-        
-        for (const auto& globalZ : globalZOrders)
-        {
-            for (const auto& n : _globalZOrderNodeMap[globalZ])
-            {
-                _nodePriorityMap[n] = ++_nodePriorityIndex;
-            }
-        }
-        
-        _globalZOrderNodeMap.clear();
+        priority.path.push_back(static_cast<std::int64_t>(n->_localZOrder) << 32 | n->_orderOfArrival);
+        n = n->getParent();
     }
+    std::reverse(priority.path.begin(), priority.path.end());
+    priority.inScene = (n == rootNode);
+}
+
+bool EventDispatcher::isDrawnAfter(const NodePriority& p1, const NodePriority& p2)
+{
+    if (p1.inScene != p2.inScene)
+        return p1.inScene;
+    if (p1.globalZOrder != p2.globalZOrder)
+        return p1.globalZOrder > p2.globalZOrder;
+
+    const auto& path1 = p1.path;
+    const auto& path2 = p2.path;
+    auto size = std::min(path1.size(), path2.size());
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (path1[i] != path2[i])
+            return path1[i] > path2[i];
+    }
+
+    // One node is an ancestor of the other, the children with local Z order < 0 are drawn before it
+    if (path1.size() > size)
+        return path1[size] >= 0;
+    if (path2.size() > size)
+        return path2[size] < 0;
+    return false;
 }
 
 void EventDispatcher::pauseEventListenersForTarget(Node* target, bool recursive/* = false */)
@@ -436,6 +408,7 @@ void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener*
         if (listeners->empty())
         {
             _nodeListenersMap.erase(found);
+            _nodePriorityMap.erase(node);
             delete listeners;
         }
     }
@@ -471,6 +444,7 @@ void EventDispatcher::forceAddEventListener(EventListener* listener)
         
         listeners = new (std::nothrow) EventListenerVector();
         _listenerMap.emplace(listenerID, listeners);
+        setCustomChannelListeners(listenerID, listeners);
     }
     else
     {
@@ -681,6 +655,7 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         if (iter->second->empty())
         {
             _priorityDirtyFlagMap.erase(listener->getListenerID());
+            setCustomChannelListeners(iter->first, nullptr);
             auto list = iter->second;
             iter = _listenerMap.erase(iter);
             CC_SAFE_DELETE(list);
@@ -902,6 +877,8 @@ void EventDispatcher::dispatchEvent(Event* event)
 {
     if (!_isEnabled)
         return;
+
+    CC_TRACE_SCOPE("EventDispatcher::dispatchEvent");
     
     updateDirtyFlagForSceneGraph();
     
@@ -946,6 +923,74 @@ void EventDispatcher::dispatchCustomEvent(const std::string &eventName, void *op
     dispatchEvent(&ev);
 }
 
+EventChannel EventDispatcher::getCustomEventChannel(const std::string &eventName)
+{
+    auto iter = _customChannelIndices.find(eventName);
+    if (iter != _customChannelIndices.end())
+        return EventChannel(iter->second);
+
+    int index = static_cast<int>(_customChannels.size());
+    _customChannels.emplace_back(eventName);
+    _customChannels.back().listeners = getListeners(eventName);
+    _customChannelIndices.emplace(eventName, index);
+    return EventChannel(index);
+}
+
+void EventDispatcher::dispatchCustomEvent(const EventChannel& channel, void *optionalUserData)
+{
+    if (!_isEnabled || !channel.isValid())
+        return;
+
+    auto& customChannel = _customChannels[channel._index];
+    if (customChannel.dispatching)
+    {
+        // A listener dispatches on its own channel, the channel's event is in use
+        dispatchCustomEvent(customChannel.event.getEventName(), optionalUserData);
+        return;
+    }
+
+    CC_TRACE_SCOPE("EventDispatcher::dispatchCustomEvent");
+
+    updateDirtyFlagForSceneGraph();
+
+    DispatchGuard guard(_inDispatch);
+
+    if (customChannel.dirty)
+    {
+        const auto& listenerID = customChannel.event.getEventName();
+        sortEventListeners(listenerID);
+
+        // Still dirty when the scene graph priorities wait for a running scene
+        auto dirtyIter = _priorityDirtyFlagMap.find(listenerID);
+        customChannel.dirty = (dirtyIter != _priorityDirtyFlagMap.end() && dirtyIter->second != DirtyFlag::NONE);
+    }
+
+    auto listeners = customChannel.listeners;
+    if (listeners)
+    {
+        EventCustom* event = &customChannel.event;
+        event->_isStopped = false;
+        event->_currentTarget = nullptr;
+        event->setUserData(optionalUserData);
+
+        auto onEvent = [event](EventListener* listener) -> bool{
+            event->setCurrentTarget(listener->getAssociatedNode());
+            listener->_onEvent(event);
+            return event->isStopped();
+        };
+
+        customChannel.dispatching = true;
+        dispatchEventToListeners(listeners, onEvent);
+        customChannel.dispatching = false;
+    }
+
+    if (_inDispatch == 1)
+    {
+        removeUnregisteredListeners(listeners);
+        updatePendingListeners();
+    }
+}
+
 bool EventDispatcher::hasEventListener(const EventListener::ListenerID& listenerID) const
 {
     return getListeners(listenerID) != nullptr;
@@ -1151,80 +1196,82 @@ void EventDispatcher::updateListeners(Event* event)
     if (_inDispatch > 1)
         return;
 
-    auto onUpdateListeners = [this](const EventListener::ListenerID& listenerID)
+    if (event->getType() == Event::Type::TOUCH)
     {
-        auto listenersIter = _listenerMap.find(listenerID);
-        if (listenersIter == _listenerMap.end())
-            return;
+        removeUnregisteredListeners(getListeners(EventListenerTouchOneByOne::LISTENER_ID));
+        removeUnregisteredListeners(getListeners(EventListenerTouchAllAtOnce::LISTENER_ID));
+    }
+    else
+    {
+        removeUnregisteredListeners(getListeners(__getListenerID(event)));
+    }
+    
+    updatePendingListeners();
+}
 
-        auto listeners = listenersIter->second;
-        
-        auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
-        auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
-        
-        if (sceneGraphPriorityListeners)
+void EventDispatcher::removeUnregisteredListeners(EventListenerVector* listeners)
+{
+    if (listeners == nullptr)
+        return;
+
+    auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
+    auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
+    
+    if (sceneGraphPriorityListeners)
+    {
+        for (auto iter = sceneGraphPriorityListeners->begin(); iter != sceneGraphPriorityListeners->end();)
         {
-            for (auto iter = sceneGraphPriorityListeners->begin(); iter != sceneGraphPriorityListeners->end();)
+            auto l = *iter;
+            if (!l->isRegistered())
             {
-                auto l = *iter;
-                if (!l->isRegistered())
-                {
-                    iter = sceneGraphPriorityListeners->erase(iter);
-                    // if item in toRemove list, remove it from the list
-                    auto matchIter = std::find(_toRemovedListeners.begin(), _toRemovedListeners.end(), l);
-                    if (matchIter != _toRemovedListeners.end())
-                        _toRemovedListeners.erase(matchIter);
-                    releaseListener(l);
-                }
-                else
-                {
-                    ++iter;
-                }
+                iter = sceneGraphPriorityListeners->erase(iter);
+                // if item in toRemove list, remove it from the list
+                auto matchIter = std::find(_toRemovedListeners.begin(), _toRemovedListeners.end(), l);
+                if (matchIter != _toRemovedListeners.end())
+                    _toRemovedListeners.erase(matchIter);
+                releaseListener(l);
             }
-        }
-        
-        if (fixedPriorityListeners)
-        {
-            for (auto iter = fixedPriorityListeners->begin(); iter != fixedPriorityListeners->end();)
+            else
             {
-                auto l = *iter;
-                if (!l->isRegistered())
-                {
-                    iter = fixedPriorityListeners->erase(iter);
-                    // if item in toRemove list, remove it from the list
-                    auto matchIter = std::find(_toRemovedListeners.begin(), _toRemovedListeners.end(), l);
-                    if (matchIter != _toRemovedListeners.end())
-                        _toRemovedListeners.erase(matchIter);
-                    releaseListener(l);
-                }
-                else
-                {
-                    ++iter;
-                }
+                ++iter;
             }
         }
-        
-        if (sceneGraphPriorityListeners && sceneGraphPriorityListeners->empty())
-        {
-            listeners->clearSceneGraphListeners();
-        }
-
-        if (fixedPriorityListeners && fixedPriorityListeners->empty())
+    }
+    
+    if (fixedPriorityListeners)
+    {
+        for (auto iter = fixedPriorityListeners->begin(); iter != fixedPriorityListeners->end();)
         {
-            listeners->clearFixedListeners();
+            auto l = *iter;
+            if (!l->isRegistered())
+            {
+                iter = fixedPriorityListeners->erase(iter);
+                // if item in toRemove list, remove it from the list
+                auto matchIter = std::find(_toRemovedListeners.begin(), _toRemovedListeners.end(), l);
+                if (matchIter != _toRemovedListeners.end())
+                    _toRemovedListeners.erase(matchIter);
+                releaseListener(l);
+            }
+            else
+            {
+                ++iter;
+            }
         }
-    };
-
-    if (event->getType() == Event::Type::TOUCH)
+    }
+    
+    if (sceneGraphPriorityListeners && sceneGraphPriorityListeners->empty())
     {
-        onUpdateListeners(EventListenerTouchOneByOne::LISTENER_ID);
-        onUpdateListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+        listeners->clearSceneGraphListeners();
     }
-    else
+
+    if (fixedPriorityListeners && fixedPriorityListeners->empty())
     {
-        onUpdateListeners(__getListenerID(event));
+        listeners->clearFixedListeners();
     }
-    
+}
+
+void EventDispatcher::updatePendingListeners()
+{
     CCASSERT(_inDispatch == 1, "_inDispatch should be 1 here.");
     
     for (auto iter = _listenerMap.begin(); iter != _listenerMap.end();)
@@ -1232,6 +1279,7 @@ void EventDispatcher::updateListeners(Event* event)
         if (iter->second->empty())
         {
             _priorityDirtyFlagMap.erase(iter->first);
+            setCustomChannelListeners(iter->first, nullptr);
             delete iter->second;
             iter = _listenerMap.erase(iter);
         }
@@ -1256,6 +1304,20 @@ void EventDispatcher::updateListeners(Event* event)
     }
 }
 
+void EventDispatcher::setCustomChannelListeners(const EventListener::ListenerID& listenerID, EventListenerVector* listeners)
+{
+    if (_customChannelIndices.empty())
+        return;
+
+    auto channelIter = _customChannelIndices.find(listenerID);
+    if (channelIter != _customChannelIndices.end())
+    {
+        auto& channel = _customChannels[channelIter->second];
+        channel.listeners = listeners;
+        channel.dirty = true;
+    }
+}
+
 void EventDispatcher::updateDirtyFlagForSceneGraph()
 {
     if (!_dirtyNodes.empty())
@@ -1270,6 +1332,7 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
                     setDirty(l->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
                 }
             }
+            _nodePriorityMap.erase(node);
         }
         
         _dirtyNodes.clear();
@@ -1322,22 +1385,42 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
     if (sceneGraphListeners == nullptr)
         return;
 
-    // Reset priority index
-    _nodePriorityIndex = 0;
-    _nodePriorityMap.clear();
+    // The priorities only depend on the node's ancestors, the dirty nodes were dropped in updateDirtyFlagForSceneGraph()
+    if (rootNode != _nodePriorityRoot)
+    {
+        _nodePriorityMap.clear();
+        _nodePriorityRoot = rootNode;
+    }
 
-    visitTarget(rootNode, true);
-    
-    // After sort: priority < 0, > 0
-    std::stable_sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), [this](const EventListener* l1, const EventListener* l2) {
-        return _nodePriorityMap[l1->getAssociatedNode()] > _nodePriorityMap[l2->getAssociatedNode()];
+    std::vector<std::pair<const NodePriority*, EventListener*>> sorted;
+    sorted.reserve(sceneGraphListeners->size());
+    for (auto& l : *sceneGraphListeners)
+    {
+        auto node = l->getAssociatedNode();
+        auto iter = _nodePriorityMap.find(node);
+        if (iter == _nodePriorityMap.end())
+        {
+            iter = _nodePriorityMap.emplace(node, NodePriority()).first;
+            updateNodePriority(node, rootNode, iter->second);
+        }
+        sorted.emplace_back(&iter->second, l);
+    }
+
+    // After sort: drawn last first
+    std::stable_sort(sorted.begin(), sorted.end(), [](const std::pair<const NodePriority*, EventListener*>& l1, const std::pair<const NodePriority*, EventListener*>& l2) {
+        return isDrawnAfter(*l1.first, *l2.first);
     });
+
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        (*sceneGraphListeners)[i] = sorted[i].second;
+    }
     
 #if DUMP_LISTENER_ITEM_PRIORITY_INFO
     log("-----------------------------------");
     for (auto& l : *sceneGraphListeners)
     {
-        log("listener priority: node ([%s]%p), priority (%d)", typeid(*l->_node).name(), l->_node, _nodePriorityMap[l->_node]);
+        log("listener priority: node ([%s]%p), global Z (%f), depth (%d)", typeid(*l->_node).name(), l->_node, _nodePriorityMap[l->_node].globalZOrder, (int)_nodePriorityMap[l->_node].path.size());
     }
 #endif
 }
@@ -1436,6 +1519,7 @@ void EventDispatcher::removeEventListenersForListenerID(const EventListener::Lis
         {
             listeners->clear();
             delete listeners;
+            setCustomChannelListeners(listenerID, nullptr);
             _listenerMap.erase(listenerItemIter);
         }
     }
@@ -1514,6 +1598,10 @@ void EventDispatcher::removeAllEventListeners()
     if (!_inDispatch && cleanMap)
     {
         _listenerMap.clear();
+        for (auto& channel : _customChannels)
+        {
+            channel.listeners = nullptr;
+        }
     }
 }
 
@@ -1545,6 +1633,15 @@ void EventDispatcher::setDirtyForNode(Node* node)
 
 void EventDispatcher::setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag)
 {    
+    if (!_customChannelIndices.empty())
+    {
+        auto channelIter = _customChannelIndices.find(listenerID);
+        if (channelIter != _customChannelIndices.end())
+        {
+            _customChannels[channelIter->second].dirty = true;
+        }
+    }
+
     auto iter = _priorityDirtyFlagMap.find(listenerID);
     if (iter == _priorityDirtyFlagMap.end())
     {
@@ -26,15 +26,18 @@
 #ifndef __CC_EVENT_DISPATCHER_H__
 #define __CC_EVENT_DISPATCHER_H__
 
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include <set>
+#include <deque>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCEventListener.h"
 #include "base/CCEvent.h"
+#include "base/CCEventCustom.h"
 #include "platform/CCStdC.h"
 
 /**
@@ -50,6 +53,29 @@ class Node;
 class EventCustom;
 class EventListenerCustom;
 
+/** @class EventChannel
+ * @brief A custom event name resolved by EventDispatcher::getCustomEventChannel().
+ *
+ * Dispatching through a channel doesn't hash the name nor allocate, use it for the custom events fired often.
+ * A default constructed channel is invalid, dispatching through it does nothing.
+ * @js NA
+ */
+class CC_DLL EventChannel
+{
+public:
+    EventChannel() : _index(-1) {}
+
+    /** Whether the channel was returned by EventDispatcher::getCustomEventChannel(). */
+    bool isValid() const { return _index >= 0; }
+
+private:
+    explicit EventChannel(int index) : _index(index) {}
+
+    int _index;
+
+    friend class EventDispatcher;
+};
+
 /** @class EventDispatcher
 * @brief This class manages event listener subscriptions
 and event dispatching.
@@ -178,6 +204,21 @@ public:
      */
     void dispatchCustomEvent(const std::string &eventName, void *optionalUserData = nullptr);
 
+    /** Gets the channel of a custom event name, the same name always gets the same channel.
+     *
+     * @param eventName The name of the custom event.
+     * @return The channel to pass to dispatchCustomEvent().
+     */
+    EventChannel getCustomEventChannel(const std::string &eventName);
+
+    /** Dispatches a Custom Event through a channel, the listeners of the channel's event name receive it
+     *  in the same order and with the same pause rules as with the event name.
+     *
+     * @param channel The channel returned by getCustomEventChannel().
+     * @param optionalUserData The optional user data, it's a void*, the default value is nullptr.
+     */
+    void dispatchCustomEvent(const EventChannel& channel, void *optionalUserData = nullptr);
+
     /** Query whether the specified event listener id has been added.
      *
      * @param listenerID The listenerID of the event listener id.
@@ -273,6 +314,15 @@ protected:
      */
     void updateListeners(Event* event);
 
+    /** Removes the listener items of one type that have been marked as 'removed' when dispatching event */
+    void removeUnregisteredListeners(EventListenerVector* listeners);
+
+    /** Removes the empty listener types and adds and removes the listener items that have been marked when dispatching event */
+    void updatePendingListeners();
+
+    /** Points the channel of a custom listener ID, if there is one, at its listeners */
+    void setCustomChannelListeners(const EventListener::ListenerID& listenerID, EventListenerVector* listeners);
+
     /** Touch event needs to be processed different with other events since it needs support ALL_AT_ONCE and ONE_BY_NONE mode. */
     void dispatchTouchEvent(EventTouch* event);
     
@@ -309,8 +359,21 @@ protected:
     /** Sets the dirty flag for a specified listener ID */
     void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
     
-    /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
-    void visitTarget(Node* node, bool isRootNode);
+    /** The draw order of a node with scene graph priority listeners, kept until the node is marked dirty */
+    struct NodePriority
+    {
+        /** Whether the node was under the root node, the others go last */
+        bool inScene;
+        float globalZOrder;
+        /** The local Z order and arrival keys of the node's ancestors and of the node, from the root node down */
+        std::vector<std::int64_t> path;
+    };
+
+    /** Walks up from the node to the root node to get its draw order, it doesn't visit the scene graph */
+    void updateNodePriority(Node* node, Node* rootNode, NodePriority& priority) const;
+
+    /** Whether the node of p1 is drawn after the node of p2 */
+    static bool isDrawnAfter(const NodePriority& p1, const NodePriority& p2);
 
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
@@ -324,11 +387,11 @@ protected:
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
     
-    /** The map of node and its event priority */
-    std::unordered_map<Node*, int> _nodePriorityMap;
+    /** The map of node and its event priority, the dirty nodes are dropped from it */
+    std::unordered_map<Node*, NodePriority> _nodePriorityMap;
     
-    /** key: Global Z Order, value: Sorted Nodes */
-    std::unordered_map<float, std::vector<Node*>> _globalZOrderNodeMap;
+    /** The root node the priorities were computed for */
+    Node* _nodePriorityRoot;
     
     /** The listeners to be added after dispatching event */
     std::vector<EventListener*> _toAddedListeners;
@@ -345,9 +408,28 @@ protected:
     /** Whether to enable dispatching event */
     bool _isEnabled;
     
-    int _nodePriorityIndex;
-    
     std::set<std::string> _internalCustomListenerIDs;
+
+    /** A custom event name with its listeners, the event is reused by each dispatch */
+    struct CustomChannel
+    {
+        CustomChannel(const std::string& eventName)
+        : event(eventName), listeners(nullptr), dirty(true), dispatching(false) {}
+
+        EventCustom event;
+        /** The listeners in _listenerMap, nullptr when there are none */
+        EventListenerVector* listeners;
+        /** Whether the listeners may need sorting */
+        bool dirty;
+        /** Whether the event is being dispatched */
+        bool dispatching;
+    };
+
+    /** The custom channels, indexed by EventChannel, a deque keeps them in place */
+    std::deque<CustomChannel> _customChannels;
+
+    /** key: Custom Event Name, value: Index of Custom Channel */
+    std::unordered_map<std::string, int> _customChannelIndices;
 };
 
 
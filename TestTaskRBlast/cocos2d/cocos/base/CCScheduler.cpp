@@ -32,6 +32,10 @@ THE SOFTWARE.
 #include "base/utlist.h"
 #include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
+#include "base/CCTrace.h"
+
+#include <algorithm>
+#include <cmath>
 
 NS_CC_BEGIN
 
@@ -65,9 +69,41 @@ typedef struct _hashSelectorEntry
     int                 timerIndex;
     Timer               *currentTimer;
     bool                paused;
+    std::uint64_t       order;          // creation order, the targets trigger in this order
     UT_hash_handle      hh;
 } tHashTimerEntry;
 
+// Timer wheel: 256 slots, a tick is 1/64 second so the wheel spans 4 seconds. A timer due later is collected
+// at a checkpoint within the span, at a tick spread by the timer's order, to accumulate its time and link it
+// again: no timer waits more than 4 seconds of scaled time, and there are no levels to cascade.
+static const int WHEEL_SLOT_BITS = 8;
+static const int WHEEL_SLOTS = 1 << WHEEL_SLOT_BITS;
+static const std::int64_t WHEEL_SLOT_MASK = WHEEL_SLOTS - 1;
+static const double WHEEL_TICKS_PER_SECOND = 64.0;
+// The times of the updates are kept in blocks of 1024 while a timer still has to accumulate them.
+static const int WHEEL_BLOCK_BITS = 10;
+static const std::int64_t WHEEL_BLOCK_MASK = (std::int64_t(1) << WHEEL_BLOCK_BITS) - 1;
+// Timer::update() accumulates the time in float, each frame rounds by at most 2^-24 of the timer's time.
+// The kept updates are at most 2^16, past that every timer accumulates them, so the rounding stays under
+// 2^-8 of their time: the wheel finds them due 2^-7 early and replays their frames, Timer::update() decides
+// like in the classic mode.
+static const size_t WHEEL_MAX_DELTAS = 65536;
+static const float WHEEL_EARLY = 1.0f / 128;
+
+enum
+{
+    WHEEL_NONE,         // not in the wheel, in the classic mode, paused, triggering or removed
+    WHEEL_PENDING,      // waits for its first update in _wheelPending
+    WHEEL_SLOT,         // in a slot of the wheel
+    WHEEL_CHECKPOINT,   // in a slot of the wheel, due later than the span of the wheel
+    WHEEL_DUE           // in _wheelDue, triggers in this update
+};
+
+static std::int64_t wheelTickOf(double time)
+{
+    return static_cast<std::int64_t>(std::floor(time * WHEEL_TICKS_PER_SECOND));
+}
+
 // implementation Timer
 
 Timer::Timer()
@@ -80,6 +116,14 @@ Timer::Timer()
 , _delay(0.0f)
 , _interval(0.0f)
 , _aborted(false)
+, _wheelNext(nullptr)
+, _wheelPrev(nullptr)
+, _wheelDeadline(0.0)
+, _wheelSyncFrame(-1)
+, _wheelEntry(nullptr)
+, _wheelTargetOrder(0)
+, _wheelOrder(0)
+, _wheelState(WHEEL_NONE)
 {
 }
 
@@ -186,11 +230,34 @@ void TimerTargetSelector::cancel()
 TimerTargetCallback::TimerTargetCallback()
 : _target(nullptr)
 , _callback(nullptr)
+, _key(0)
 {
 }
 
+TimerTargetCallback::~TimerTargetCallback()
+{
+    if (_key)
+    {
+        _scheduler->releaseKey(_key);
+    }
+}
+
 bool TimerTargetCallback::initWithCallback(Scheduler* scheduler, const ccSchedulerFunc& callback, void *target, const std::string& key, float seconds, unsigned int repeat, float delay)
 {
+    return initWithCallback(scheduler, callback, target, scheduler->findOrAddKey(key), seconds, repeat, delay);
+}
+
+bool TimerTargetCallback::initWithCallback(Scheduler* scheduler, const ccSchedulerFunc& callback, void *target, SchedulerKey key, float seconds, unsigned int repeat, float delay)
+{
+    // retained first, the timer may be initialized again with its own key
+    if (key)
+    {
+        scheduler->retainKey(key);
+    }
+    if (_key)
+    {
+        _scheduler->releaseKey(_key);
+    }
     _scheduler = scheduler;
     _target = target;
     _callback = callback;
@@ -199,6 +266,12 @@ bool TimerTargetCallback::initWithCallback(Scheduler* scheduler, const ccSchedul
     return true;
 }
 
+const std::string& TimerTargetCallback::getKey() const
+{
+    static const std::string noKey;
+    return _scheduler ? _scheduler->getInternedKey(_key) : noKey;
+}
+
 void TimerTargetCallback::trigger(float dt)
 {
     if (_callback)
@@ -260,24 +333,189 @@ Scheduler::Scheduler(void)
 , _currentTarget(nullptr)
 , _currentTargetSalvaged(false)
 , _updateHashLocked(false)
+, _targetOrder(0)
+, _timerOrder(0)
+, _timerWheelEnabled(false)
+, _wheelTime(0.0)
+, _wheelTick(0)
+, _wheelPending(nullptr)
+, _wheelDueNext(0)
+, _wheelDelta(0.0f)
+, _wheelFrame(0)
+, _wheelFrameEnd(0)
+, _wheelDeltasBase(0)
+, _wheelHolds(1, 0)
+, _wheelFiring(false)
+, _wheelTurnTarget(0)
+, _wheelTurnTimer(0)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
 {
     // I don't expect to have more than 30 functions to all per frame
     _functionsToPerform.reserve(30);
+    std::fill(std::begin(_wheelSlots), std::end(_wheelSlots), nullptr);
 }
 
 Scheduler::~Scheduler(void)
 {
     unscheduleAll();
+
+    for (auto timer : _callbackTimerPool)
+        timer->release();
+    for (auto timer : _selectorTimerPool)
+        timer->release();
+    for (auto element : _hashElementPool)
+    {
+        ccArrayFree(element->timers);
+        free(element);
+    }
+}
+
+SchedulerKey Scheduler::internKey(const std::string& key)
+{
+    SchedulerKey id = findOrAddKey(key);
+    _keyEntries[id - 1].interned = true;
+    return id;
+}
+
+const std::string& Scheduler::getInternedKey(SchedulerKey key) const
+{
+    static const std::string noKey;
+    return key > 0 && key <= _keyEntries.size() && _keyEntries[key - 1].name ? *_keyEntries[key - 1].name : noKey;
+}
+
+// Returns the id of a key, a new key lives while a timer uses it or internKey() keeps it.
+SchedulerKey Scheduler::findOrAddKey(const std::string& key)
+{
+    CCASSERT(!key.empty(), "key should not be empty!");
+
+    auto iter = _keys.find(key);
+    if (iter != _keys.end())
+    {
+        return iter->second;
+    }
+
+    SchedulerKey id;
+    if (_freeKeys.empty())
+    {
+        _keyEntries.emplace_back();
+        id = static_cast<SchedulerKey>(_keyEntries.size());
+    }
+    else
+    {
+        id = _freeKeys.back();
+        _freeKeys.pop_back();
+    }
+    iter = _keys.emplace(key, id).first;
+    auto& entry = _keyEntries[id - 1];
+    entry.name = &iter->first;
+    entry.timers = 0;
+    entry.interned = false;
+    return id;
+}
+
+void Scheduler::retainKey(SchedulerKey key)
+{
+    ++_keyEntries[key - 1].timers;
+}
+
+void Scheduler::releaseKey(SchedulerKey key)
+{
+    auto& entry = _keyEntries[key - 1];
+    CCASSERT(entry.timers > 0, "the key is not used by a timer");
+    if (--entry.timers > 0 || entry.interned)
+    {
+        return;
+    }
+    _keys.erase(_keys.find(*entry.name));
+    entry.name = nullptr;
+    _freeKeys.push_back(key);
+}
+
+tHashTimerEntry* Scheduler::addHashElement(void *target, bool paused)
+{
+    tHashTimerEntry *element = nullptr;
+    if (_hashElementPool.empty())
+    {
+        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
+        element->timers = ccArrayNew(10);
+    }
+    else
+    {
+        element = _hashElementPool.back();
+        _hashElementPool.pop_back();
+        ccArray *timers = element->timers;
+        memset(element, 0, sizeof(*element));
+        element->timers = timers;
+    }
+    element->target = target;
+    element->order = ++_targetOrder;
+
+    HASH_ADD_PTR(_hashForTimers, target, element);
+
+    // Is this the 1st element ? Then set the pause level to all the selectors of this target
+    element->paused = paused;
+    return element;
 }
 
 void Scheduler::removeHashElement(_hashSelectorEntry *element)
 {
-    ccArrayFree(element->timers);
+    CCASSERT(element->timers->num == 0, "the removed element should have no timers");
     HASH_DEL(_hashForTimers, element);
-    free(element);
+    _hashElementPool.push_back(element);
+}
+
+TimerTargetCallback* Scheduler::newCallbackTimer()
+{
+    if (_callbackTimerPool.empty())
+    {
+        return new (std::nothrow) TimerTargetCallback();
+    }
+    TimerTargetCallback *timer = _callbackTimerPool.back();
+    _callbackTimerPool.pop_back();
+    return timer;
+}
+
+TimerTargetSelector* Scheduler::newSelectorTimer()
+{
+    if (_selectorTimerPool.empty())
+    {
+        return new (std::nothrow) TimerTargetSelector();
+    }
+    TimerTargetSelector *timer = _selectorTimerPool.back();
+    _selectorTimerPool.pop_back();
+    return timer;
+}
+
+// Releases a timer like Ref::release(), but the last reference of a timer made by the scheduler goes to its pool.
+void Scheduler::releaseTimer(Timer* timer)
+{
+    if (timer->getReferenceCount() == 1)
+    {
+        timer->_aborted = false;
+        if (auto callbackTimer = dynamic_cast<TimerTargetCallback*>(timer))
+        {
+            // the captures of the callback and the key are released now, as when the timer is deleted
+            callbackTimer->_callback = nullptr;
+            callbackTimer->_target = nullptr;
+            if (callbackTimer->_key)
+            {
+                releaseKey(callbackTimer->_key);
+                callbackTimer->_key = 0;
+            }
+            _callbackTimerPool.push_back(callbackTimer);
+            return;
+        }
+        if (auto selectorTimer = dynamic_cast<TimerTargetSelector*>(timer))
+        {
+            selectorTimer->_selector = nullptr;
+            selectorTimer->_target = nullptr;
+            _selectorTimerPool.push_back(selectorTimer);
+            return;
+        }
+    }
+    timer->release();
 }
 
 void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
@@ -287,51 +525,61 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
 
 void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string& key)
 {
-    CCASSERT(target, "Argument target must be non-nullptr");
     CCASSERT(!key.empty(), "key should not be empty!");
+    this->schedule(callback, target, interval, repeat, delay, paused, findOrAddKey(key));
+}
+
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, SchedulerKey key)
+{
+    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
+}
+
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, SchedulerKey key)
+{
+    CCASSERT(target, "Argument target must be non-nullptr");
+    CCASSERT(key != 0, "key should be interned!");
 
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
 
     if (! element)
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
-
-        HASH_ADD_PTR(_hashForTimers, target, element);
-
-        // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
+        element = addHashElement(target, paused);
     }
     else
     {
         CCASSERT(element->paused == paused, "element's paused should be paused!");
-    }
 
-    if (element->timers == nullptr)
-    {
-        element->timers = ccArrayNew(10);
-    }
-    else 
-    {
         for (int i = 0; i < element->timers->num; ++i)
         {
             TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
 
-            if (timer && !timer->isExhausted() && key == timer->getKey())
+            if (timer && !timer->isExhausted() && key == timer->_key)
             {
                 CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
+                unlinkTimer(timer);
                 timer->setupTimerWithInterval(interval, repeat, delay);
+                if (_timerWheelEnabled && !element->paused && timer != element->currentTimer)
+                {
+                    linkTimer(timer);
+                }
                 return;
             }
         }
         ccArrayEnsureExtraCapacity(element->timers, 1);
     }
 
-    TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
+    TimerTargetCallback *timer = newCallbackTimer();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
+    timer->_wheelEntry = element;
+    timer->_wheelTargetOrder = element->order;
+    timer->_wheelOrder = ++_timerOrder;
     ccArrayAppendObject(element->timers, timer);
     timer->release();
+    if (_timerWheelEnabled && !element->paused)
+    {
+        linkTimer(timer);
+    }
 }
 
 void Scheduler::unschedule(const std::string &key, void *target)
@@ -342,8 +590,21 @@ void Scheduler::unschedule(const std::string &key, void *target)
         return;
     }
 
-    //CCASSERT(target);
-    //CCASSERT(selector);
+    // a key that was never interned was never scheduled
+    auto iter = _keys.find(key);
+    if (iter != _keys.end())
+    {
+        unschedule(iter->second, target);
+    }
+}
+
+void Scheduler::unschedule(SchedulerKey key, void *target)
+{
+    // explicit handle nil arguments when removing an object
+    if (target == nullptr || key == 0)
+    {
+        return;
+    }
 
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
@@ -354,7 +615,7 @@ void Scheduler::unschedule(const std::string &key, void *target)
         {
             TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
 
-            if (timer && key == timer->getKey())
+            if (timer && key == timer->_key)
             {
                 if (timer == element->currentTimer && (! timer->isAborted()))
                 {
@@ -362,7 +623,9 @@ void Scheduler::unschedule(const std::string &key, void *target)
                     timer->setAborted();
                 }
 
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
+                unlinkTimer(timer);
+                ccArrayRemoveObjectAtIndex(element->timers, i, false);
+                releaseTimer(timer);
 
                 // update timerIndex in case we are in tick:, looping over the actions
                 if (element->timerIndex >= i)
@@ -506,6 +769,14 @@ void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target,
 bool Scheduler::isScheduled(const std::string& key, const void *target) const
 {
     CCASSERT(!key.empty(), "Argument key must not be empty");
+
+    auto iter = _keys.find(key);
+    return iter != _keys.end() && isScheduled(iter->second, target);
+}
+
+bool Scheduler::isScheduled(SchedulerKey key, const void *target) const
+{
+    CCASSERT(key != 0, "Argument key must be interned");
     CCASSERT(target, "Argument target must be non-nullptr");
     
     tHashTimerEntry *element = nullptr;
@@ -525,7 +796,7 @@ bool Scheduler::isScheduled(const std::string& key, const void *target) const
     {
         TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
         
-        if (timer && !timer->isExhausted() && key == timer->getKey())
+        if (timer && !timer->isExhausted() && key == timer->_key)
         {
             return true;
         }
@@ -642,7 +913,12 @@ void Scheduler::unscheduleAllForTarget(void *target)
             element->currentTimer->retain();
             element->currentTimer->setAborted();
         }
-        ccArrayRemoveAllObjects(element->timers);
+        while (element->timers->num > 0)
+        {
+            Timer *timer = static_cast<Timer*>(element->timers->arr[--element->timers->num]);
+            unlinkTimer(timer);
+            releaseTimer(timer);
+        }
 
         if (_currentTarget == element)
         {
@@ -688,9 +964,13 @@ void Scheduler::resumeTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && element->paused)
     {
         element->paused = false;
+        if (_timerWheelEnabled)
+        {
+            linkTimers(element);
+        }
     }
 
     // update selector
@@ -710,9 +990,10 @@ void Scheduler::pauseTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && !element->paused)
     {
         element->paused = true;
+        unlinkTimers(element);
     }
 
     // update selector
@@ -761,7 +1042,11 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
         element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        if (!element->paused)
+        {
+            element->paused = true;
+            unlinkTimers(element);
+        }
         idsWithSelectors.insert(element->target);
     }
 
@@ -822,6 +1107,7 @@ void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
 // main loop
 void Scheduler::update(float dt)
 {
+    CC_TRACE_SCOPE("Scheduler::update");
     _updateHashLocked = true;
 
     if (_timeScale != 1.0f)
@@ -863,8 +1149,12 @@ void Scheduler::update(float dt)
         }
     }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
+    // Iterate over all the custom selectors, or only the due ones of the timer wheel
+    if (_timerWheelEnabled)
+    {
+        updateTimerWheel(dt);
+    }
+    for (tHashTimerEntry *elt = _timerWheelEnabled ? nullptr : _hashForTimers; elt != nullptr; )
     {
         _currentTarget = elt;
         _currentTargetSalvaged = false;
@@ -886,7 +1176,7 @@ void Scheduler::update(float dt)
                     // The currentTimer told the remove itself. To prevent the timer from
                     // accidentally deallocating itself before finishing its step, we retained
                     // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
+                    releaseTimer(elt->currentTimer);
                 }
 
                 elt->currentTimer = nullptr;
@@ -962,25 +1252,12 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
     
     if (! element)
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
-        
-        HASH_ADD_PTR(_hashForTimers, target, element);
-        
-        // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
+        element = addHashElement(target, paused);
     }
     else
     {
         CCASSERT(element->paused == paused, "element's paused should be paused.");
-    }
-    
-    if (element->timers == nullptr)
-    {
-        element->timers = ccArrayNew(10);
-    }
-    else
-    {
+
         for (int i = 0; i < element->timers->num; ++i)
         {
             TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
@@ -988,17 +1265,29 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
             if (timer && !timer->isExhausted() && selector == timer->getSelector())
             {
                 CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
+                unlinkTimer(timer);
                 timer->setupTimerWithInterval(interval, repeat, delay);
+                if (_timerWheelEnabled && !element->paused && timer != element->currentTimer)
+                {
+                    linkTimer(timer);
+                }
                 return;
             }
         }
         ccArrayEnsureExtraCapacity(element->timers, 1);
     }
     
-    TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
+    TimerTargetSelector *timer = newSelectorTimer();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
+    timer->_wheelEntry = element;
+    timer->_wheelTargetOrder = element->order;
+    timer->_wheelOrder = ++_timerOrder;
     ccArrayAppendObject(element->timers, timer);
     timer->release();
+    if (_timerWheelEnabled && !element->paused)
+    {
+        linkTimer(timer);
+    }
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, bool paused)
@@ -1062,7 +1351,9 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
                     timer->setAborted();
                 }
                 
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
+                unlinkTimer(timer);
+                ccArrayRemoveObjectAtIndex(element->timers, i, false);
+                releaseTimer(timer);
                 
                 // update timerIndex in case we are in tick:, looping over the actions
                 if (element->timerIndex >= i)
@@ -1088,4 +1379,361 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
     }
 }
 
+// timer wheel
+
+void Scheduler::setTimerWheelEnabled(bool enabled)
+{
+    if (_timerWheelEnabled == enabled)
+        return;
+
+    if (!enabled)
+    {
+        // the timers take the time accumulated in the wheel back into _elapsed
+        for (tHashTimerEntry *element = _hashForTimers; element != nullptr; element = (tHashTimerEntry *)element->hh.next)
+        {
+            unlinkTimers(element);
+        }
+    }
+
+    _timerWheelEnabled = enabled;
+
+    if (enabled)
+    {
+        _wheelTick = wheelTickOf(_wheelTime);
+        for (tHashTimerEntry *element = _hashForTimers; element != nullptr; element = (tHashTimerEntry *)element->hh.next)
+        {
+            if (!element->paused)
+            {
+                linkTimers(element);
+            }
+        }
+    }
+}
+
+// While the due timers trigger, the targets before the triggering one are done with this update, like in the
+// classic mode, and the later ones are not updated yet: their time runs up to the previous update.
+bool Scheduler::isTargetUpdated(tHashTimerEntry *element) const
+{
+    return !_wheelFiring || element->order <= _wheelTurnTarget;
+}
+
+void Scheduler::linkTimer(Timer* timer)
+{
+    CCASSERT(timer->_wheelState == WHEEL_NONE, "The timer is in the wheel already");
+
+    tHashTimerEntry *element = timer->_wheelEntry;
+    if (timer->_elapsed == -1)
+    {
+        // like the classic mode, the first update only starts the timer, in this update when its turn is still to come
+        bool updated = !_wheelFiring || element->order < _wheelTurnTarget
+            || (element->order == _wheelTurnTarget && timer->_wheelOrder <= _wheelTurnTimer);
+        if (!updated)
+        {
+            insertDueTimer(timer);
+            return;
+        }
+        timer->_wheelNext = _wheelPending;
+        timer->_wheelPrev = &_wheelPending;
+        if (_wheelPending)
+        {
+            _wheelPending->_wheelPrev = &timer->_wheelNext;
+        }
+        _wheelPending = timer;
+        timer->_wheelState = WHEEL_PENDING;
+        return;
+    }
+
+    bool updated = isTargetUpdated(element);
+    bool due = setTimerDeadline(timer, updated ? _wheelTime : _wheelTime - _wheelDelta, updated ? _wheelFrameEnd : _wheelFrame);
+    if (due && !updated)
+    {
+        insertDueTimer(timer);
+        return;
+    }
+    insertTimerInWheel(timer);
+}
+
+void Scheduler::unlinkTimer(Timer* timer)
+{
+    switch (timer->_wheelState)
+    {
+    case WHEEL_PENDING:
+    case WHEEL_SLOT:
+    case WHEEL_CHECKPOINT:
+        *timer->_wheelPrev = timer->_wheelNext;
+        if (timer->_wheelNext)
+        {
+            timer->_wheelNext->_wheelPrev = timer->_wheelPrev;
+        }
+        timer->_wheelNext = nullptr;
+        timer->_wheelPrev = nullptr;
+        break;
+    case WHEEL_DUE:
+        // stays in _wheelDue, which skips it
+        break;
+    default:
+        return;
+    }
+    timer->_wheelState = WHEEL_NONE;
+
+    // keep the time accumulated since the timer was last updated, for a resume or the classic mode
+    syncTimer(timer, isTargetUpdated(timer->_wheelEntry) ? _wheelFrameEnd : _wheelFrame);
+}
+
+// Sets the deadline of a started timer, its _elapsed holds the time up to syncTime and the updates from
+// syncFrame on are still to accumulate. Returns whether it may trigger in this update.
+bool Scheduler::setTimerDeadline(Timer* timer, double syncTime, std::int64_t syncFrame)
+{
+    // the time left until Timer::update() may trigger it, an interval of 0 triggers every frame
+    float end = timer->_useDelay ? timer->_delay : timer->_interval;
+    float left = end > 0 ? end - timer->_elapsed - end * WHEEL_EARLY : 0.0f;
+    timer->_wheelDeadline = syncTime + std::max(left, 0.0f);
+    timer->_wheelSyncFrame = syncFrame;
+    ++_wheelHolds[static_cast<size_t>((syncFrame >> WHEEL_BLOCK_BITS) - (_wheelDeltasBase >> WHEEL_BLOCK_BITS))];
+    return timer->_wheelDeadline <= _wheelTime;
+}
+
+// Accumulates the updates before the given one in _elapsed, one at a time like Timer::update().
+void Scheduler::syncTimer(Timer* timer, std::int64_t frame)
+{
+    if (timer->_wheelSyncFrame < 0)
+        return;
+
+    for (std::int64_t i = timer->_wheelSyncFrame; i < frame; ++i)
+    {
+        timer->_elapsed += _wheelDeltas[static_cast<size_t>(i - _wheelDeltasBase)];
+    }
+    --_wheelHolds[static_cast<size_t>((timer->_wheelSyncFrame >> WHEEL_BLOCK_BITS) - (_wheelDeltasBase >> WHEEL_BLOCK_BITS))];
+    timer->_wheelSyncFrame = -1;
+}
+
+void Scheduler::linkTimers(tHashTimerEntry *element)
+{
+    if (element->timers == nullptr)
+        return;
+
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+        // a triggering timer is linked after its update
+        if (timer->_wheelState == WHEEL_NONE && timer != element->currentTimer)
+        {
+            linkTimer(timer);
+        }
+    }
+}
+
+void Scheduler::unlinkTimers(tHashTimerEntry *element)
+{
+    if (element->timers == nullptr)
+        return;
+
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+        // the classic mode checks the pause before the target's turn, the triggering target finishes its update
+        if (timer->_wheelState != WHEEL_DUE || element != _currentTarget)
+        {
+            unlinkTimer(timer);
+        }
+    }
+}
+
+void Scheduler::insertDueTimer(Timer* timer)
+{
+    // the due timers still to trigger are sorted, the timer's turn is after the triggering one
+    auto position = std::upper_bound(_wheelDue.begin() + _wheelDueNext, _wheelDue.end(), timer, isTimerBefore);
+    _wheelDue.insert(position, timer);
+    timer->_wheelState = WHEEL_DUE;
+    timer->retain();
+}
+
+bool Scheduler::isTimerBefore(const Timer* t1, const Timer* t2)
+{
+    // the skipped due timers may have lost their target, the orders are copied
+    if (t1->_wheelTargetOrder != t2->_wheelTargetOrder)
+        return t1->_wheelTargetOrder < t2->_wheelTargetOrder;
+    return t1->_wheelOrder < t2->_wheelOrder;
+}
+
+void Scheduler::insertTimerInWheel(Timer* timer)
+{
+    std::int64_t tick = wheelTickOf(timer->_wheelDeadline);
+    timer->_wheelState = WHEEL_SLOT;
+
+    // the checkpoints of the timers due later are spread over the ticks of the span
+    std::uint64_t phase = (timer->_wheelOrder * 0x9E3779B97F4A7C15ull) >> (64 - WHEEL_SLOT_BITS);
+    std::int64_t checkpoint = _wheelTick + 1 + ((static_cast<std::int64_t>(phase) - _wheelTick - 1) & WHEEL_SLOT_MASK);
+    if (tick > checkpoint)
+    {
+        tick = checkpoint;
+        timer->_wheelDeadline = tick / WHEEL_TICKS_PER_SECOND;
+        timer->_wheelState = WHEEL_CHECKPOINT;
+    }
+
+    // the current slot is scanned by every update
+    Timer** slot = &_wheelSlots[std::max(tick, _wheelTick) & WHEEL_SLOT_MASK];
+    timer->_wheelNext = *slot;
+    timer->_wheelPrev = slot;
+    if (*slot)
+    {
+        (*slot)->_wheelPrev = &timer->_wheelNext;
+    }
+    *slot = timer;
+}
+
+void Scheduler::collectDueTimers(Timer** slot, double now)
+{
+    for (Timer* timer = *slot; timer != nullptr; )
+    {
+        Timer* next = timer->_wheelNext;
+        if (timer->_wheelDeadline <= now)
+        {
+            *timer->_wheelPrev = next;
+            if (next)
+            {
+                next->_wheelPrev = timer->_wheelPrev;
+            }
+            timer->_wheelNext = nullptr;
+            timer->_wheelPrev = nullptr;
+
+            bool due = true;
+            if (timer->_wheelState == WHEEL_CHECKPOINT)
+            {
+                // accumulate the updates before this one, the timer waits for the rest of its time
+                syncTimer(timer, _wheelFrame);
+                due = setTimerDeadline(timer, now - _wheelDelta, _wheelFrame);
+            }
+            if (due)
+            {
+                timer->_wheelState = WHEEL_DUE;
+                // an earlier callback of this update may remove it
+                timer->retain();
+                _wheelDue.push_back(timer);
+            }
+            else
+            {
+                insertTimerInWheel(timer);
+            }
+        }
+        timer = next;
+    }
+}
+
+// Drops the blocks of updates no timer has to accumulate any more.
+void Scheduler::dropWheelDeltas()
+{
+    while (_wheelHolds.size() > 1 && _wheelHolds.front() == 0)
+    {
+        _wheelHolds.erase(_wheelHolds.begin());
+        _wheelDeltas.erase(_wheelDeltas.begin(), _wheelDeltas.begin() + (WHEEL_BLOCK_MASK + 1));
+        _wheelDeltasBase += WHEEL_BLOCK_MASK + 1;
+    }
+}
+
+void Scheduler::updateTimerWheel(float dt)
+{
+    dropWheelDeltas();
+    if (_wheelDeltas.size() >= WHEEL_MAX_DELTAS)
+    {
+        // more than 2^16 updates within the span of the wheel, all the timers accumulate them
+        for (tHashTimerEntry *element = _hashForTimers; element != nullptr; element = (tHashTimerEntry *)element->hh.next)
+        {
+            if (!element->paused)
+            {
+                unlinkTimers(element);
+                linkTimers(element);
+            }
+        }
+        dropWheelDeltas();
+    }
+
+    _wheelTime += dt;
+    _wheelDelta = dt;
+    _wheelFrame = _wheelFrameEnd;
+    if (dt != 0)
+    {
+        // an update of 0 doesn't change the time of a timer
+        _wheelDeltas.push_back(dt);
+        if ((++_wheelFrameEnd & WHEEL_BLOCK_MASK) == 0)
+        {
+            _wheelHolds.push_back(0);
+        }
+    }
+    const double now = _wheelTime;
+    const std::int64_t nowTick = wheelTickOf(now);
+
+    // the slots of the passed ticks are all due, the current one keeps the timers due later in its tick
+    while (true)
+    {
+        collectDueTimers(&_wheelSlots[_wheelTick & WHEEL_SLOT_MASK], now);
+        if (_wheelTick >= nowTick)
+            break;
+
+        ++_wheelTick;
+    }
+
+    // the first update of the new timers, they start now
+    Timer* pending = _wheelPending;
+    _wheelPending = nullptr;
+    while (pending)
+    {
+        Timer* next = pending->_wheelNext;
+        pending->_wheelState = WHEEL_NONE;
+        pending->update(0);
+        linkTimer(pending);
+        pending = next;
+    }
+
+    if (_wheelDue.empty())
+        return;
+
+    // the order of the classic mode: by target, then by timer
+    std::sort(_wheelDue.begin(), _wheelDue.end(), isTimerBefore);
+
+    _wheelFiring = true;
+    _wheelTurnTarget = 0;
+    _wheelTurnTimer = 0;
+    // the callbacks may add due timers after the triggering one
+    for (_wheelDueNext = 0; _wheelDueNext < _wheelDue.size(); )
+    {
+        Timer* timer = _wheelDue[_wheelDueNext++];
+        if (timer->_wheelState == WHEEL_DUE)
+        {
+            tHashTimerEntry *element = timer->_wheelEntry;
+            _wheelTurnTarget = element->order;
+            _wheelTurnTimer = timer->_wheelOrder;
+            _currentTarget = element;
+            _currentTargetSalvaged = false;
+            element->currentTimer = timer;
+
+            // the earlier frames don't trigger it, this one may
+            timer->_wheelState = WHEEL_NONE;
+            syncTimer(timer, _wheelFrame);
+            timer->update(dt);
+
+            if (timer->isAborted())
+            {
+                // retained by unschedule, see the classic mode
+                releaseTimer(timer);
+            }
+            else if (timer->_wheelState == WHEEL_NONE && !element->paused)
+            {
+                linkTimer(timer);
+            }
+
+            element->currentTimer = nullptr;
+            if (_currentTargetSalvaged && element->timers->num == 0)
+            {
+                removeHashElement(element);
+            }
+        }
+        releaseTimer(timer);
+    }
+    _wheelDue.clear();
+    _wheelDueNext = 0;
+    _wheelFiring = false;
+    _currentTarget = nullptr;
+}
+
 NS_CC_END
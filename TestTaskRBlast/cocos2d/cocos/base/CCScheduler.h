@@ -29,9 +29,13 @@ THE SOFTWARE.
 #ifndef __CCSCHEDULER_H__
 #define __CCSCHEDULER_H__
 
+#include <cstdint>
 #include <functional>
 #include <mutex>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
@@ -43,6 +47,9 @@ class Scheduler;
 
 typedef std::function<void(float)> ccSchedulerFunc;
 
+/** Id of an interned callback key, see Scheduler::internKey(). 0 is no key. */
+typedef unsigned int SchedulerKey;
+
 /**
  * @cond
  */
@@ -72,6 +79,18 @@ protected:
     float _delay;
     float _interval;
     bool _aborted;
+
+    // timer wheel of the scheduler, see Scheduler::setTimerWheelEnabled()
+    Timer* _wheelNext;
+    Timer** _wheelPrev;
+    double _wheelDeadline;        // scheduler time of the next trigger
+    std::int64_t _wheelSyncFrame; // the first update not accumulated in _elapsed yet, -1 when there is none to keep
+    struct _hashSelectorEntry* _wheelEntry;
+    std::uint64_t _wheelTargetOrder; // the triggering order: by target, then by timer
+    std::uint64_t _wheelOrder;
+    unsigned char _wheelState;
+
+    friend class Scheduler;
 };
 
 
@@ -91,6 +110,8 @@ public:
 protected:
     Ref* _target;
     SEL_SCHEDULE _selector;
+
+    friend class Scheduler;
 };
 
 
@@ -98,12 +119,17 @@ class CC_DLL TimerTargetCallback : public Timer
 {
 public:
     TimerTargetCallback();
+    virtual ~TimerTargetCallback();
     
     // Initializes a timer with a target, a lambda and an interval in seconds, repeat in number of times to repeat, delay in seconds.
+    // The scheduler keeps the key while a timer uses it.
     bool initWithCallback(Scheduler* scheduler, const ccSchedulerFunc& callback, void *target, const std::string& key, float seconds, unsigned int repeat, float delay);
+    // Same as above with a key interned by the scheduler.
+    bool initWithCallback(Scheduler* scheduler, const ccSchedulerFunc& callback, void *target, SchedulerKey key, float seconds, unsigned int repeat, float delay);
     
     const ccSchedulerFunc& getCallback() const { return _callback; }
-    const std::string& getKey() const { return _key; }
+    const std::string& getKey() const;
+    SchedulerKey getKeyId() const { return _key; }
     
     virtual void trigger(float dt) override;
     virtual void cancel() override;
@@ -111,7 +137,9 @@ public:
 protected:
     void* _target;
     ccSchedulerFunc _callback;
-    std::string _key;
+    SchedulerKey _key;
+
+    friend class Scheduler;
 };
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -205,6 +233,32 @@ public:
     */
     void setTimeScale(float timeScale) { _timeScale = timeScale; }
 
+    /** Triggers the custom selectors from a timer wheel instead of updating every timer each frame.
+     * The cost of a frame is then proportional to the timers that trigger, not to the scheduled ones.
+     * The timers trigger in the same frames, in the same order and with the same repeat, delay and pause
+     * rules: the time of a timer is accumulated in float frame by frame like in the classic mode, when the
+     * wheel finds it due, or at least every 4 seconds of scaled time. Default is false, the scheduled timers
+     * move to the new mode. Don't call it from a scheduled callback.
+     */
+    void setTimerWheelEnabled(bool enabled);
+    /** Whether the custom selectors are triggered from a timer wheel.
+     * @see Scheduler::setTimerWheelEnabled()
+     */
+    bool isTimerWheelEnabled() const { return _timerWheelEnabled; }
+
+    /** Interns a key of the callbacks. The overloads of schedule(), unschedule() and isScheduled() taking
+     * the returned id don't hash or compare strings, the ones taking the string look it up and call them.
+     * An interned key is kept for the lifetime of the scheduler, so don't intern a new key for every callback.
+     * The overloads taking the string don't intern it, their keys are dropped with the last timer using them.
+     * @param key The key to identify the callback function, it must not be empty.
+     * @return The id of the key, never 0.
+     */
+    SchedulerKey internKey(const std::string& key);
+    /** Returns the interned key of an id, or an empty string if there is none.
+     * @see Scheduler::internKey()
+     */
+    const std::string& getInternedKey(SchedulerKey key) const;
+
     /** 'update' the scheduler.
      * You should NEVER call this method, unless you know what you are doing.
      * @lua NA
@@ -242,6 +296,15 @@ public:
      @since v3.0
      */
     void schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key);
+
+    /** Same as the schedule() taking a string key, with a key returned by internKey().
+     The timers are reused, so scheduling and unscheduling don't allocate once the scheduler has warmed up,
+     apart from a callback too big for the small buffer of std::function<>.
+     */
+    void schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, SchedulerKey key);
+
+    /** Same as the schedule() taking a string key, with a key returned by internKey(). */
+    void schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, SchedulerKey key);
     
     
     /** The scheduled method will be called every `interval` seconds.
@@ -309,6 +372,9 @@ public:
      */
     void unschedule(const std::string& key, void *target);
 
+    /** Unschedules a callback for a key returned by internKey() and a given target. */
+    void unschedule(SchedulerKey key, void *target);
+
     /** Unschedules a selector for a given target.
      If you want to unschedule the "update", use `unscheduleUpdate()`.
      @param selector The selector that is unscheduled.
@@ -365,6 +431,9 @@ public:
      @since v3.0.0
      */
     bool isScheduled(const std::string& key, const void *target) const;
+
+    /** Checks whether a callback associated with a key returned by internKey() and 'target' is scheduled. */
+    bool isScheduled(SchedulerKey key, const void *target) const;
     
     /** Checks whether a selector for a given target is scheduled.
      @param selector The selector to be checked.
@@ -497,6 +566,8 @@ public:
     CC_DEPRECATED_ATTRIBUTE void unscheduleUpdateForTarget(Ref *target) { return unscheduleUpdate(target); };
     
 protected:
+    friend class TimerTargetCallback;
+
     
     /** Schedules the 'callback' function for a given target with a given priority.
      The 'callback' selector will be called every frame.
@@ -507,7 +578,14 @@ protected:
      */
     void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     
+    struct _hashSelectorEntry* addHashElement(void *target, bool paused);
     void removeHashElement(struct _hashSelectorEntry *element);
+    TimerTargetCallback* newCallbackTimer();
+    TimerTargetSelector* newSelectorTimer();
+    void releaseTimer(Timer* timer);
+    SchedulerKey findOrAddKey(const std::string& key);
+    void retainKey(SchedulerKey key);
+    void releaseKey(SchedulerKey key);
     void removeUpdateFromHash(struct _listEntry *entry);
 
     // update specific
@@ -515,6 +593,22 @@ protected:
     void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
 
+    // timer wheel specific
+
+    void updateTimerWheel(float dt);
+    void linkTimer(Timer* timer);
+    void unlinkTimer(Timer* timer);
+    void linkTimers(struct _hashSelectorEntry *element);
+    void unlinkTimers(struct _hashSelectorEntry *element);
+    void insertTimerInWheel(Timer* timer);
+    void insertDueTimer(Timer* timer);
+    void collectDueTimers(Timer** slot, double now);
+    bool setTimerDeadline(Timer* timer, double syncTime, std::int64_t syncFrame);
+    void syncTimer(Timer* timer, std::int64_t frame);
+    void dropWheelDeltas();
+    bool isTargetUpdated(struct _hashSelectorEntry *element) const;
+    static bool isTimerBefore(const Timer* t1, const Timer* t2);
+
 
     float _timeScale;
 
@@ -533,6 +627,40 @@ protected:
     bool _currentTargetSalvaged;
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
+    std::uint64_t _targetOrder;
+    std::uint64_t _timerOrder;
+
+    // Used for the keys of the callbacks and the reuse of the timers
+    struct KeyEntry
+    {
+        const std::string* name;    // nullptr when the id is free
+        unsigned int timers;        // the timers using the key
+        bool interned;              // kept by internKey() even without timers
+    };
+    std::unordered_map<std::string, SchedulerKey> _keys;
+    std::vector<KeyEntry> _keyEntries;                      // the key of the id n is at n - 1
+    std::vector<SchedulerKey> _freeKeys;
+    std::vector<TimerTargetCallback*> _callbackTimerPool;
+    std::vector<TimerTargetSelector*> _selectorTimerPool;
+    std::vector<struct _hashSelectorEntry*> _hashElementPool; // the elements keep their timers array
+
+    // Used by the timer wheel
+    bool _timerWheelEnabled;
+    double _wheelTime;              // the scaled time of the updates in timer wheel mode
+    std::int64_t _wheelTick;        // the tick of the current slot, the earlier ticks are done
+    Timer* _wheelSlots[256];        // a slot a tick, the timers due later wait for a checkpoint
+    Timer* _wheelPending;           // the timers waiting for their first update
+    std::vector<Timer*> _wheelDue;  // the timers triggering in this update
+    size_t _wheelDueNext;           // the next due timer to trigger, the earlier ones are released
+    float _wheelDelta;              // the scaled time of this update
+    std::int64_t _wheelFrame;       // the index of this update in the updates of a time other than 0
+    std::int64_t _wheelFrameEnd;    // the index after this update, the same when its time is 0
+    std::int64_t _wheelDeltasBase;  // the update of _wheelDeltas[0]
+    std::vector<float> _wheelDeltas; // the scaled times of the updates still to accumulate by some timer
+    std::vector<unsigned int> _wheelHolds; // the timers to accumulate from each block of 1024 updates
+    bool _wheelFiring;              // whether the due timers are triggering
+    std::uint64_t _wheelTurnTarget; // the order of the triggering target and timer
+    std::uint64_t _wheelTurnTimer;
     
 #if CC_ENABLE_SCRIPT_BINDING
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
@@ -0,0 +1,222 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCTrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    static_assert((Trace::EVENTS_PER_THREAD & (Trace::EVENTS_PER_THREAD - 1)) == 0, "EVENTS_PER_THREAD must be a power of two");
+
+    // the fields are atomic, so a reader may copy a slot while its thread overwrites it
+    struct Slot
+    {
+        std::atomic<const char*> name;
+        std::atomic<int64_t> begin;
+        std::atomic<int64_t> end;
+    };
+
+    // written by its thread only, read by toJson() on any thread
+    struct ThreadBuffer
+    {
+        ThreadBuffer(unsigned id_) : id(id_), writing(0), head(0), slots(new Slot[Trace::EVENTS_PER_THREAD]) {}
+
+        unsigned id;
+        std::string name;
+        // the slots before writing may be in change, the ones before head are complete
+        std::atomic<uint64_t> writing;
+        std::atomic<uint64_t> head;
+        std::unique_ptr<Slot[]> slots;
+    };
+
+    struct TraceEvent
+    {
+        const char* name;
+        int64_t begin;
+        int64_t end;
+    };
+
+    // a thread registers on its first scope, the buffers outlive their threads
+    std::mutex s_buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+    thread_local ThreadBuffer* t_buffer = nullptr;
+
+    std::atomic<int64_t> s_frameStarts[Trace::MAX_FRAMES];
+    std::atomic<uint64_t> s_frameCount(0);
+
+    const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+    ThreadBuffer* getThreadBuffer()
+    {
+        if (!t_buffer)
+        {
+            std::lock_guard<std::mutex> lock(s_buffersMutex);
+            s_buffers.emplace_back(new ThreadBuffer(static_cast<unsigned>(s_buffers.size()) + 1));
+            t_buffer = s_buffers.back().get();
+        }
+        return t_buffer;
+    }
+
+    // the events still in the ring, a slot the thread may have overwritten during the copy is dropped
+    void copyEvents(const ThreadBuffer& buffer, int64_t from, std::vector<TraceEvent>& events)
+    {
+        const uint64_t capacity = Trace::EVENTS_PER_THREAD;
+        uint64_t head = buffer.head.load(std::memory_order_acquire);
+        uint64_t first = head > capacity ? head - capacity : 0;
+
+        size_t start = events.size();
+        for (uint64_t i = first; i < head; ++i)
+        {
+            const Slot& slot = buffer.slots[i & (capacity - 1)];
+            TraceEvent event = { slot.name.load(std::memory_order_relaxed),
+                slot.begin.load(std::memory_order_relaxed), slot.end.load(std::memory_order_relaxed) };
+            events.push_back(event);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t writing = buffer.writing.load(std::memory_order_relaxed);
+        size_t overwritten = static_cast<size_t>(writing > first + capacity ? std::min(writing - capacity - first, head - first) : 0);
+        events.erase(events.begin() + start, events.begin() + start + overwritten);
+        events.erase(std::remove_if(events.begin() + start, events.end(), [from](const TraceEvent& event) {
+            return event.end < from;
+        }), events.end());
+    }
+
+    void appendEscaped(std::string& out, const std::string& text)
+    {
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20)
+                out += c;
+        }
+    }
+
+    // microseconds with a fraction, the unit of trace_event
+    void appendMicroseconds(std::string& out, int64_t nanoseconds)
+    {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%lld.%03d", static_cast<long long>(nanoseconds / 1000), static_cast<int>(nanoseconds % 1000));
+        out += buffer;
+    }
+}
+
+int64_t Trace::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count();
+}
+
+void Trace::record(const char* name, int64_t begin, int64_t end)
+{
+    ThreadBuffer* buffer = getThreadBuffer();
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    Slot& slot = buffer->slots[head & (EVENTS_PER_THREAD - 1)];
+
+    // a reader that copies one of the new fields sees the new writing when it checks it after the copy
+    buffer->writing.store(head + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Trace::beginFrame()
+{
+    uint64_t frame = s_frameCount.load(std::memory_order_relaxed);
+    s_frameStarts[frame % MAX_FRAMES].store(now(), std::memory_order_relaxed);
+    s_frameCount.store(frame + 1, std::memory_order_release);
+}
+
+uint64_t Trace::getFrameCount()
+{
+    return s_frameCount.load(std::memory_order_acquire);
+}
+
+void Trace::setThreadName(const std::string& name)
+{
+    ThreadBuffer* buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    buffer->name = name;
+}
+
+std::string Trace::toJson(unsigned frames)
+{
+    // the scopes that end after the start of the first wanted frame
+    uint64_t frameCount = getFrameCount();
+    uint64_t kept = std::min<uint64_t>(std::min<uint64_t>(frames, MAX_FRAMES - 1), frameCount);
+    int64_t from = kept > 0 && kept < frameCount ? s_frameStarts[(frameCount - kept) % MAX_FRAMES].load(std::memory_order_relaxed) : 0;
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    std::vector<TraceEvent> events;
+
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    for (const auto& buffer : s_buffers)
+    {
+        std::string tid = std::to_string(buffer->id);
+        if (!buffer->name.empty())
+        {
+            json += first ? "\n" : ",\n";
+            json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":\"";
+            appendEscaped(json, buffer->name);
+            json += "\"}}";
+            first = false;
+        }
+
+        events.clear();
+        copyEvents(*buffer, from, events);
+        for (const auto& event : events)
+        {
+            json += first ? "\n" : ",\n";
+            json += "{\"name\":\"";
+            appendEscaped(json, event.name ? event.name : "");
+            json += "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+            appendMicroseconds(json, event.begin);
+            json += ",\"dur\":";
+            appendMicroseconds(json, event.end - event.begin);
+            json += "}";
+            first = false;
+        }
+    }
+
+    json += "\n]}\n";
+    return json;
+}
+
+bool Trace::writeJson(const std::string& path, unsigned frames)
+{
+    return FileUtils::getInstance()->writeStringToFile(toJson(frames), path);
+}
+
+NS_CC_END
@@ -0,0 +1,115 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __BASE_CCTRACE_H__
+#define __BASE_CCTRACE_H__
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "base/ccConfig.h"
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * Records timed scopes of all threads for a Chrome trace (chrome://tracing, Perfetto).
+ *
+ * Only compiled in with CC_ENABLE_TRACING, the ENABLE_TRACING CMake option. Use the macros,
+ * they expand to nothing otherwise:
+ *
+ *     void Foo::update(float dt)
+ *     {
+ *         CC_TRACE_SCOPE("Foo::update");
+ *         ...
+ *     }
+ *
+ * Every thread writes into a ring buffer of its own, a scope costs two clock reads and three
+ * relaxed stores. The ring keeps the last EVENTS_PER_THREAD scopes of the thread, the Director
+ * marks the start of every frame. The "trace" Console command writes the last frames as JSON.
+ */
+class CC_DLL Trace
+{
+public:
+    /** The number of scopes each thread keeps. */
+    static const size_t EVENTS_PER_THREAD = 16384;
+    /** The number of frames whose start is kept. */
+    static const size_t MAX_FRAMES = 1024;
+
+    /** Records the time from its construction to its destruction. */
+    class Scope
+    {
+    public:
+        /** @param name A string literal, only the pointer is kept. */
+        explicit Scope(const char* name) : _name(name), _begin(now()) {}
+        ~Scope() { record(_name, _begin, now()); }
+
+    private:
+        const char* _name;
+        int64_t _begin;
+    };
+
+    /** Nanoseconds since the first call. */
+    static int64_t now();
+
+    /** Records a scope of the calling thread, name has to outlive the trace. */
+    static void record(const char* name, int64_t begin, int64_t end);
+
+    /** Marks the start of a frame, Director::drawScene() calls it. */
+    static void beginFrame();
+
+    /** The number of frames marked so far. */
+    static uint64_t getFrameCount();
+
+    /** Names the calling thread in the trace. */
+    static void setThreadName(const std::string& name);
+
+    /** Returns the scopes of the last frames, up to MAX_FRAMES, as Chrome trace_event JSON. */
+    static std::string toJson(unsigned frames);
+
+    /** Writes toJson() into a file. */
+    static bool writeJson(const std::string& path, unsigned frames);
+};
+
+NS_CC_END
+// end group
+/// @}
+
+#if CC_ENABLE_TRACING
+#define CC_TRACE_CONCAT_(__a__, __b__) __a__##__b__
+#define CC_TRACE_CONCAT(__a__, __b__) CC_TRACE_CONCAT_(__a__, __b__)
+#define CC_TRACE_SCOPE(__name__) NS_CC::Trace::Scope CC_TRACE_CONCAT(__traceScope, __LINE__)(__name__)
+#define CC_TRACE_FRAME() NS_CC::Trace::beginFrame()
+#define CC_TRACE_THREAD_NAME(__name__) NS_CC::Trace::setThreadName(__name__)
+#else
+#define CC_TRACE_SCOPE(__name__) do {} while (0)
+#define CC_TRACE_FRAME() do {} while (0)
+#define CC_TRACE_THREAD_NAME(__name__) do {} while (0)
+#endif
+
+#endif // __BASE_CCTRACE_H__
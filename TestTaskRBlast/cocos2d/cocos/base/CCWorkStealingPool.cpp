@@ -0,0 +1,152 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCWorkStealingPool.h"
+#include "base/CCTrace.h"
+#include <algorithm>
+
+NS_CC_BEGIN
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount)
+: _queues(std::max(threadCount ? threadCount : std::thread::hardware_concurrency(), 1u))
+, _job(nullptr)
+, _remaining(0)
+, _generation(0)
+, _quit(false)
+{
+    for (size_t i = 1; i < _queues.size(); ++i)
+    {
+        _threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _wake.notify_all();
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::parallelFor(size_t count, const std::function<void(size_t)>& job)
+{
+    size_t queues = _queues.size();
+    if (queues == 1 || count <= 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            job(i);
+        }
+        return;
+    }
+
+    // published to the workers by the queue mutexes, a worker reads it only after taking an index
+    _job = &job;
+    _remaining = count;
+    for (size_t q = 0; q < queues; ++q)
+    {
+        std::lock_guard<std::mutex> lock(_queues[q].mutex);
+        _queues[q].begin = count * q / queues;
+        _queues[q].end = count * (q + 1) / queues;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_generation;
+    }
+    _wake.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this]() { return _remaining == 0; });
+    _job = nullptr;
+}
+
+void WorkStealingPool::workerLoop(size_t self)
+{
+    CC_TRACE_THREAD_NAME("WorkStealingPool " + std::to_string(self));
+    unsigned seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this, &seen]() { return _quit || _generation != seen; });
+            if (_quit)
+            {
+                return;
+            }
+            seen = _generation;
+        }
+        work(self);
+    }
+}
+
+void WorkStealingPool::work(size_t self)
+{
+    size_t index;
+    while (pop(self, index) || steal(self, index))
+    {
+        (*_job)(index);
+        if (--_remaining == 0)
+        {
+            // under the mutex, so the wait in parallelFor can't miss it
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done.notify_all();
+        }
+    }
+}
+
+bool WorkStealingPool::pop(size_t self, size_t& index)
+{
+    auto& queue = _queues[self];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.begin == queue.end)
+    {
+        return false;
+    }
+    index = queue.begin++;
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t self, size_t& index)
+{
+    for (size_t i = 1, count = _queues.size(); i < count; ++i)
+    {
+        auto& queue = _queues[(self + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.begin != queue.end)
+        {
+            index = --queue.end;
+            return true;
+        }
+    }
+    return false;
+}
+
+NS_CC_END
@@ -0,0 +1,100 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __BASE_CCWORKSTEALINGPOOL_H__
+#define __BASE_CCWORKSTEALINGPOOL_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * A fixed set of threads that run the jobs of one parallelFor() at a time.
+ *
+ * The jobs are split into a contiguous range per thread, so neighbouring jobs run on the same thread.
+ * A thread that runs out of jobs steals from the end of the range of another one.
+ * The calling thread works on the first range and returns when every job is done.
+ */
+class CC_DLL WorkStealingPool
+{
+public:
+    /**
+     * @param threadCount The number of threads that run jobs, including the one calling parallelFor().
+     * 0 uses one thread per core.
+     */
+    explicit WorkStealingPool(unsigned threadCount);
+    ~WorkStealingPool();
+
+    /** The number of threads that run jobs, including the calling one. */
+    unsigned getThreadCount() const { return static_cast<unsigned>(_queues.size()); }
+
+    /**
+     * Runs job(0) to job(count - 1) and waits until they are all done.
+     * Only one thread at a time may call it, and not from inside a job.
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& job);
+
+private:
+    // the jobs [begin, end) left to the thread, the owner takes from the front and thieves from the back
+    struct Queue
+    {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    void workerLoop(size_t self);
+    void work(size_t self);
+    bool pop(size_t self, size_t& index);
+    bool steal(size_t self, size_t& index);
+
+    std::vector<Queue> _queues;
+    std::vector<std::thread> _threads;
+    const std::function<void(size_t)>* _job;
+    std::atomic<size_t> _remaining;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    unsigned _generation;
+    bool _quit;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(WorkStealingPool);
+};
+
+NS_CC_END
+// end of base group
+/** @} */
+
+#endif // __BASE_CCWORKSTEALINGPOOL_H__
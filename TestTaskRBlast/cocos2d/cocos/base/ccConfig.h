@@ -166,6 +166,21 @@ THE SOFTWARE.
 #endif
 
 
+/** @def CC_RENDERER_STREAM_BUFFER
+ * If enabled, the renderer writes batched triangles straight into a ring buffer object
+ * that is fenced per flush instead of re-specifying its buffers from a staging copy.
+ * The ring stays mapped with GL_ARB_buffer_storage and is mapped per flush with
+ * GL_ARB_map_buffer_range + GL_ARB_sync. Drivers without them keep the staging path.
+ * Only desktop OpenGL on Windows and Linux, enabled there by default.
+ */
+#ifndef CC_RENDERER_STREAM_BUFFER
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+#define CC_RENDERER_STREAM_BUFFER 1
+#else
+#define CC_RENDERER_STREAM_BUFFER 0
+#endif
+#endif
+
 /** @def CC_USE_LA88_LABELS
  * If enabled, it will use LA88 (Luminance Alpha 16-bit textures) for LabelTTF objects.
  * If it is disabled, it will use A8 (Alpha 8-bit textures).
@@ -247,6 +262,15 @@ THE SOFTWARE.
 #define CC_ENABLE_PROFILERS 0
 #endif
 
+/** @def CC_ENABLE_TRACING
+ * If enabled, the engine records timed scopes of every thread into ring buffers, and the "trace"
+ * console command writes the last frames as a Chrome trace, see base/CCTrace.h.
+ * Set it with the ENABLE_TRACING CMake option. Disabled by default.
+ */
+#ifndef CC_ENABLE_TRACING
+#define CC_ENABLE_TRACING 0
+#endif
+
 /** Enable Lua engine debug log. */
 #ifndef CC_LUA_ENGINE_DEBUG
 #define CC_LUA_ENGINE_DEBUG 0
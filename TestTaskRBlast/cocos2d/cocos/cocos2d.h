@@ -40,6 +40,7 @@ THE SOFTWARE.
 
 // base
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCWorkStealingPool.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCConsole.h"
@@ -50,6 +51,7 @@ THE SOFTWARE.
 #include "base/CCMap.h"
 #include "base/CCNS.h"
 #include "base/CCProfiling.h"
+#include "base/CCTrace.h"
 #include "base/CCProperties.h"
 #include "base/CCRef.h"
 #include "base/CCRefPtr.h"
@@ -105,6 +107,7 @@ THE SOFTWARE.
 #include "2d/CCActionInstant.h"
 #include "2d/CCActionInterval.h"
 #include "2d/CCActionManager.h"
+#include "2d/CCTweenManager.h"
 #include "2d/CCActionPageTurn3D.h"
 #include "2d/CCActionProgressTimer.h"
 #include "2d/CCActionTiledGrid.h"
@@ -170,6 +173,7 @@ THE SOFTWARE.
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCube.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCDynamicAtlas.h"
 #include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCVertexAttribBinding.h"
 #include "renderer/CCVertexIndexBuffer.h"
@@ -244,6 +248,8 @@ THE SOFTWARE.
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCParallelVisit.h"
+#include "2d/CCStaticNode.h"
 
 // text_input_node
 #include "2d/CCTextFieldTTF.h"
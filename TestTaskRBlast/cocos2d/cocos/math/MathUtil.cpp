@@ -73,6 +73,25 @@ This file was modified to fit the cocos2d-x project
 
 #include "math/MathUtil.inl"
 
+// batch functions, the instruction set is picked at runtime
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INCLUDE_SSE2
+#if defined (__GNUC__) || defined (_MSC_VER)
+#define INCLUDE_AVX2
+#endif
+#endif
+
+#ifdef INCLUDE_SSE2
+#include "math/MathUtilSSE2.inl"
+#endif
+
+#ifdef INCLUDE_AVX2
+#include "math/MathUtilAVX2.inl"
+#if defined (_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
 NS_CC_MATH_BEGIN
 
 void MathUtil::smooth(float* x, float target, float elapsedTime, float responseTime)
@@ -101,6 +120,154 @@ float MathUtil::lerp(float from, float to, float alpha)
     return from * (1.0f - alpha) + to * alpha;
 }
 
+static MathUtil::SIMDLevel getSupportedSIMDLevel()
+{
+#if defined (INCLUDE_AVX2) && defined (__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return MathUtil::SIMDLevel::AVX2;
+#elif defined (INCLUDE_AVX2) && defined (_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7)
+    {
+        __cpuid(info, 1);
+        // the OS must save the ymm registers too
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (osxsave && avx && (_xgetbv(0) & 6) == 6)
+        {
+            __cpuidex(info, 7, 0);
+            if ((info[1] & (1 << 5)) != 0)
+                return MathUtil::SIMDLevel::AVX2;
+        }
+    }
+#endif
+#ifdef INCLUDE_SSE2
+    return MathUtil::SIMDLevel::SSE2;
+#else
+    return MathUtil::SIMDLevel::NONE;
+#endif
+}
+
+static MathUtil::SIMDLevel& currentSIMDLevel()
+{
+    static MathUtil::SIMDLevel level = getSupportedSIMDLevel();
+    return level;
+}
+
+MathUtil::SIMDLevel MathUtil::getSIMDLevel()
+{
+    return currentSIMDLevel();
+}
+
+void MathUtil::setSIMDLevel(SIMDLevel level)
+{
+    SIMDLevel supported = getSupportedSIMDLevel();
+    currentSIMDLevel() = level < supported ? level : supported;
+}
+
+void MathUtil::transformPoints(const float* m, float* points, size_t count, size_t stride)
+{
+    GP_ASSERT(m && (points || count == 0));
+
+    // the vector paths load and store four floats per point
+    if (stride < 4 * sizeof(float))
+    {
+        MathUtilC::transformPoints(m, points, count, stride);
+        return;
+    }
+    switch (currentSIMDLevel())
+    {
+#ifdef INCLUDE_AVX2
+    case SIMDLevel::AVX2:
+        MathUtilAVX2::transformPoints(m, points, count, stride);
+        break;
+#endif
+#ifdef INCLUDE_SSE2
+    case SIMDLevel::SSE2:
+        MathUtilSSE2::transformPoints(m, points, count, stride);
+        break;
+#endif
+    default:
+        MathUtilC::transformPoints(m, points, count, stride);
+        break;
+    }
+}
+
+void MathUtil::transformVertices(const float* m, const void* src, void* dst, size_t count, size_t stride)
+{
+    GP_ASSERT(m && ((src && dst) || count == 0));
+    GP_ASSERT(stride >= 3 * sizeof(float) && stride % sizeof(float) == 0);
+
+    // the vector paths load and store four floats per vertex
+    if (stride < 4 * sizeof(float))
+    {
+        MathUtilC::transformVertices(m, src, dst, count, stride);
+        return;
+    }
+    switch (currentSIMDLevel())
+    {
+#ifdef INCLUDE_AVX2
+    case SIMDLevel::AVX2:
+        MathUtilAVX2::transformVertices(m, src, dst, count, stride);
+        break;
+#endif
+#ifdef INCLUDE_SSE2
+    case SIMDLevel::SSE2:
+        MathUtilSSE2::transformVertices(m, src, dst, count, stride);
+        break;
+#endif
+    default:
+        MathUtilC::transformVertices(m, src, dst, count, stride);
+        break;
+    }
+}
+
+void MathUtil::offsetIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset)
+{
+    GP_ASSERT((src && dst) || count == 0);
+
+    switch (currentSIMDLevel())
+    {
+#ifdef INCLUDE_AVX2
+    case SIMDLevel::AVX2:
+        MathUtilAVX2::offsetIndices(src, dst, count, offset);
+        break;
+#endif
+#ifdef INCLUDE_SSE2
+    case SIMDLevel::SSE2:
+        MathUtilSSE2::offsetIndices(src, dst, count, offset);
+        break;
+#endif
+    default:
+        MathUtilC::offsetIndices(src, dst, count, offset);
+        break;
+    }
+}
+
+void MathUtil::lerpDeltas(const float* from, const float* delta, const float* alpha, float* dst, size_t count)
+{
+    GP_ASSERT((from && delta && alpha && dst) || count == 0);
+
+    switch (currentSIMDLevel())
+    {
+#ifdef INCLUDE_AVX2
+    case SIMDLevel::AVX2:
+        MathUtilAVX2::lerpDeltas(from, delta, alpha, dst, count);
+        break;
+#endif
+#ifdef INCLUDE_SSE2
+    case SIMDLevel::SSE2:
+        MathUtilSSE2::lerpDeltas(from, delta, alpha, dst, count);
+        break;
+#endif
+    default:
+        MathUtilC::lerpDeltas(from, delta, alpha, dst, count);
+        break;
+    }
+}
+
 bool MathUtil::isNeon32Enabled()
 {
 #ifdef USE_NEON32
@@ -88,6 +88,71 @@ public:
      * @return interpolated float value
      */
     static float lerp(float from, float to, float alpha);
+
+    /**
+     * Instruction sets of the batch functions.
+     */
+    enum class SIMDLevel
+    {
+        NONE,
+        SSE2,
+        AVX2
+    };
+
+    /**
+     * Transforms points by a matrix in place, the points are the positions of an interleaved vertex array.
+     *
+     * @param m the column major matrix.
+     * @param points the first point.
+     * @param count the number of points.
+     * @param stride the distance between two points in bytes.
+     */
+    static void transformPoints(const float* m, float* points, size_t count, size_t stride);
+
+    /**
+     * Copies an interleaved vertex array and transforms the point at the start of every vertex,
+     * the rest of each vertex is copied as is. Every vertex is written once and in order,
+     * so dst may be write combined memory such as a mapped buffer object.
+     *
+     * @param m the column major matrix.
+     * @param src the first source vertex.
+     * @param dst the first destination vertex, must not overlap src.
+     * @param count the number of vertices.
+     * @param stride the size of a vertex in bytes, a multiple of four and at least 12.
+     */
+    static void transformVertices(const float* m, const void* src, void* dst, size_t count, size_t stride);
+
+    /**
+     * Adds an offset to a run of indices, dst[i] = src[i] + offset.
+     *
+     * @param src the source indices.
+     * @param dst the destination indices, may be src.
+     * @param count the number of indices.
+     * @param offset the offset.
+     */
+    static void offsetIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset);
+
+    /**
+     * Interpolates runs of values by their deltas, dst[i] = from[i] + delta[i] * alpha[i].
+     *
+     * @param from the start values.
+     * @param delta the differences between the end and the start values.
+     * @param alpha the interpolation coefficients.
+     * @param dst the interpolated values, may be one of the sources.
+     * @param count the number of values.
+     */
+    static void lerpDeltas(const float* from, const float* delta, const float* alpha, float* dst, size_t count);
+
+    /**
+     * Returns the instruction set used by the batch functions, the best one of the CPU by default.
+     */
+    static SIMDLevel getSIMDLevel();
+
+    /**
+     * Limits the instruction set of the batch functions, for benchmarks and tests.
+     * A level the CPU does not support falls back to the best supported one.
+     */
+    static void setSIMDLevel(SIMDLevel level);
 private:
     //Indicates that if neon is enabled
     static bool isNeon32Enabled();
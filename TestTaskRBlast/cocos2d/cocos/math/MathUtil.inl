@@ -42,6 +42,14 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void transformPoints(const float* m, float* points, size_t count, size_t stride);
+
+    inline static void transformVertices(const float* m, const void* src, void* dst, size_t count, size_t stride);
+
+    inline static void offsetIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset);
+
+    inline static void lerpDeltas(const float* from, const float* delta, const float* alpha, float* dst, size_t count);
 };
 
 inline void MathUtilC::addMatrix(const float* m, float scalar, float* dst)
@@ -215,4 +223,45 @@ inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
     dst[2] = z;
 }
 
+inline void MathUtilC::transformPoints(const float* m, float* points, size_t count, size_t stride)
+{
+    char* p = reinterpret_cast<char*>(points);
+    for (size_t i = 0; i < count; ++i, p += stride)
+    {
+        float* v = reinterpret_cast<float*>(p);
+        transformVec4(m, v[0], v[1], v[2], 1.0f, v);
+    }
+}
+
+inline void MathUtilC::transformVertices(const float* m, const void* src, void* dst, size_t count, size_t stride)
+{
+    const float* s = static_cast<const float*>(src);
+    float* d = static_cast<float*>(dst);
+    const size_t words = stride / sizeof(float);
+    for (size_t i = 0; i < count; ++i, s += words, d += words)
+    {
+        transformVec4(m, s[0], s[1], s[2], 1.0f, d);
+        for (size_t w = 3; w < words; ++w)
+        {
+            d[w] = s[w];
+        }
+    }
+}
+
+inline void MathUtilC::offsetIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
+inline void MathUtilC::lerpDeltas(const float* from, const float* delta, const float* alpha, float* dst, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i] = from[i] + delta[i] * alpha[i];
+    }
+}
+
 NS_CC_MATH_END
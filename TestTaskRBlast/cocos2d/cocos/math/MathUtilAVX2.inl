@@ -0,0 +1,147 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <immintrin.h>
+
+#if defined (__GNUC__)
+#define CC_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CC_TARGET_AVX2
+#endif
+
+NS_CC_MATH_BEGIN
+
+// only called after the runtime check, the rest of the engine is built without AVX
+class MathUtilAVX2
+{
+public:
+    CC_TARGET_AVX2 static void transformPoints(const float* m, float* points, size_t count, size_t stride);
+
+    CC_TARGET_AVX2 static void transformVertices(const float* m, const void* src, void* dst, size_t count, size_t stride);
+
+    CC_TARGET_AVX2 static void offsetIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset);
+
+    CC_TARGET_AVX2 static void lerpDeltas(const float* from, const float* delta, const float* alpha, float* dst, size_t count);
+};
+
+CC_TARGET_AVX2 void MathUtilAVX2::transformPoints(const float* m, float* points, size_t count, size_t stride)
+{
+    // two points per register, one in each 128 bit lane
+    const __m256 col0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m));
+    const __m256 col1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+    const __m256 col2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+    const __m256 col3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+    char* p = reinterpret_cast<char*>(points);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2, p += 2 * stride)
+    {
+        float* v0 = reinterpret_cast<float*>(p);
+        float* v1 = reinterpret_cast<float*>(p + stride);
+        __m256 o = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(v0)), _mm_loadu_ps(v1), 1);
+        // the same sum order as MathUtilC::transformVec4, results are bit exact
+        __m256 r = _mm256_mul_ps(col0, _mm256_permute_ps(o, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(col1, _mm256_permute_ps(o, _MM_SHUFFLE(1, 1, 1, 1))));
+        r = _mm256_add_ps(r, _mm256_mul_ps(col2, _mm256_permute_ps(o, _MM_SHUFFLE(2, 2, 2, 2))));
+        r = _mm256_add_ps(r, col3);
+        // keep the fourth float of both points
+        r = _mm256_blend_ps(r, o, 0x88);
+        _mm_storeu_ps(v0, _mm256_castps256_ps128(r));
+        _mm_storeu_ps(v1, _mm256_extractf128_ps(r, 1));
+    }
+    if (i < count)
+    {
+        const __m128 col[4] = { _mm256_castps256_ps128(col0), _mm256_castps256_ps128(col1),
+                                _mm256_castps256_ps128(col2), _mm256_castps256_ps128(col3) };
+        MathUtilSSE2::transformPoint(col, reinterpret_cast<float*>(p));
+    }
+    _mm256_zeroupper();
+}
+
+CC_TARGET_AVX2 void MathUtilAVX2::transformVertices(const float* m, const void* src, void* dst, size_t count, size_t stride)
+{
+    const __m256 col0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m));
+    const __m256 col1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+    const __m256 col2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+    const __m256 col3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+    const float* s = static_cast<const float*>(src);
+    float* d = static_cast<float*>(dst);
+    const size_t words = stride / sizeof(float);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2, s += 2 * words, d += 2 * words)
+    {
+        __m256 o = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s)), _mm_loadu_ps(s + words), 1);
+        __m256 r = _mm256_mul_ps(col0, _mm256_permute_ps(o, _MM_SHUFFLE(0, 0, 0, 0)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(col1, _mm256_permute_ps(o, _MM_SHUFFLE(1, 1, 1, 1))));
+        r = _mm256_add_ps(r, _mm256_mul_ps(col2, _mm256_permute_ps(o, _MM_SHUFFLE(2, 2, 2, 2))));
+        r = _mm256_add_ps(r, col3);
+        r = _mm256_blend_ps(r, o, 0x88);
+        // each vertex is written front to back before the next one
+        _mm_storeu_ps(d, _mm256_castps256_ps128(r));
+        for (size_t w = 4; w < words; ++w)
+        {
+            d[w] = s[w];
+        }
+        _mm_storeu_ps(d + words, _mm256_extractf128_ps(r, 1));
+        for (size_t w = 4; w < words; ++w)
+        {
+            d[words + w] = s[words + w];
+        }
+    }
+    if (i < count)
+    {
+        const __m128 col[4] = { _mm256_castps256_ps128(col0), _mm256_castps256_ps128(col1),
+                                _mm256_castps256_ps128(col2), _mm256_castps256_ps128(col3) };
+        MathUtilSSE2::transformVertex(col, s, d, words);
+    }
+    _mm256_zeroupper();
+}
+
+CC_TARGET_AVX2 void MathUtilAVX2::offsetIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset)
+{
+    const __m256i o = _mm256_set1_epi16(static_cast<short>(offset));
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_add_epi16(v, o));
+    }
+    _mm256_zeroupper();
+    MathUtilSSE2::offsetIndices(src + i, dst + i, count - i, offset);
+}
+
+CC_TARGET_AVX2 void MathUtilAVX2::lerpDeltas(const float* from, const float* delta, const float* alpha, float* dst, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 r = _mm256_mul_ps(_mm256_loadu_ps(delta + i), _mm256_loadu_ps(alpha + i));
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(from + i), r));
+    }
+    _mm256_zeroupper();
+    MathUtilSSE2::lerpDeltas(from + i, delta + i, alpha + i, dst + i, count - i);
+}
+
+#undef CC_TARGET_AVX2
+
+NS_CC_MATH_END
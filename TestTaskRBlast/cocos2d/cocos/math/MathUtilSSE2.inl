@@ -0,0 +1,121 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <emmintrin.h>
+
+NS_CC_MATH_BEGIN
+
+class MathUtilSSE2
+{
+public:
+    // points are at least 16 bytes apart, the fourth float of a point is kept as is
+    inline static void transformPoints(const float* m, float* points, size_t count, size_t stride);
+
+    inline static void transformVertices(const float* m, const void* src, void* dst, size_t count, size_t stride);
+
+    inline static void transformPoint(const __m128 col[4], float* v);
+
+    // transforms the point of one vertex from src into dst and copies the rest of the vertex
+    inline static void transformVertex(const __m128 col[4], const float* src, float* dst, size_t words);
+
+    inline static void offsetIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset);
+
+    inline static void lerpDeltas(const float* from, const float* delta, const float* alpha, float* dst, size_t count);
+};
+
+inline void MathUtilSSE2::transformPoints(const float* m, float* points, size_t count, size_t stride)
+{
+    const __m128 col[4] = { _mm_loadu_ps(m), _mm_loadu_ps(m + 4), _mm_loadu_ps(m + 8), _mm_loadu_ps(m + 12) };
+    char* p = reinterpret_cast<char*>(points);
+    for (size_t i = 0; i < count; ++i, p += stride)
+    {
+        transformPoint(col, reinterpret_cast<float*>(p));
+    }
+}
+
+inline void MathUtilSSE2::transformVertices(const float* m, const void* src, void* dst, size_t count, size_t stride)
+{
+    const __m128 col[4] = { _mm_loadu_ps(m), _mm_loadu_ps(m + 4), _mm_loadu_ps(m + 8), _mm_loadu_ps(m + 12) };
+    const float* s = static_cast<const float*>(src);
+    float* d = static_cast<float*>(dst);
+    const size_t words = stride / sizeof(float);
+    for (size_t i = 0; i < count; ++i, s += words, d += words)
+    {
+        transformVertex(col, s, d, words);
+    }
+}
+
+inline void MathUtilSSE2::transformPoint(const __m128 col[4], float* v)
+{
+    transformVertex(col, v, v, 4);
+}
+
+inline void MathUtilSSE2::transformVertex(const __m128 col[4], const float* src, float* dst, size_t words)
+{
+    __m128 o = _mm_loadu_ps(src);
+    // the same sum order as MathUtilC::transformVec4, results are bit exact
+    __m128 r = _mm_mul_ps(col[0], _mm_shuffle_ps(o, o, _MM_SHUFFLE(0, 0, 0, 0)));
+    r = _mm_add_ps(r, _mm_mul_ps(col[1], _mm_shuffle_ps(o, o, _MM_SHUFFLE(1, 1, 1, 1))));
+    r = _mm_add_ps(r, _mm_mul_ps(col[2], _mm_shuffle_ps(o, o, _MM_SHUFFLE(2, 2, 2, 2))));
+    r = _mm_add_ps(r, col[3]);
+    // x, y, z of the result and the untouched fourth float of the source
+    __m128 zw = _mm_unpackhi_ps(r, o);
+    _mm_storeu_ps(dst, _mm_shuffle_ps(r, zw, _MM_SHUFFLE(3, 0, 1, 0)));
+    for (size_t w = 4; w < words; ++w)
+    {
+        dst[w] = src[w];
+    }
+}
+
+inline void MathUtilSSE2::offsetIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset)
+{
+    const __m128i o = _mm_set1_epi16(static_cast<short>(offset));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_add_epi16(v, o));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
+inline void MathUtilSSE2::lerpDeltas(const float* from, const float* delta, const float* alpha, float* dst, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        // a multiply and an add, no fused rounding, so the results match MathUtilC
+        __m128 r = _mm_mul_ps(_mm_loadu_ps(delta + i), _mm_loadu_ps(alpha + i));
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(from + i), r));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] = from[i] + delta[i] * alpha[i];
+    }
+}
+
+NS_CC_MATH_END
@@ -0,0 +1,1416 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include "platform/linux/CCGLRecorder-linux.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+#include "platform/CCGL.h"
+
+namespace {
+
+const GLint MAX_TEXTURE_SIZE = 4096;
+const GLint MAX_TEXTURE_UNITS = 16;
+const GLint MAX_VERTEX_ATTRIBS = 16;
+
+// a desktop GL with vertex array objects and range mapping. No buffer storage, the writes
+// into a persistent coherent mapping can't be seen, so the stream buffer maps every block instead.
+const char* EXTENSIONS = "GL_ARB_vertex_array_object GL_ARB_map_buffer_range GL_ARB_sync "
+                         "GL_ARB_framebuffer_object GL_EXT_framebuffer_object";
+
+struct Variable
+{
+    std::string name;
+    GLenum type;
+    GLint size;
+    GLint location;
+};
+
+struct Shader
+{
+    GLenum type;
+    std::string source;
+};
+
+struct Program
+{
+    std::vector<GLuint> shaders;
+    std::map<std::string, GLint> boundAttributes;
+    std::vector<Variable> attributes;
+    std::vector<Variable> uniforms;
+};
+
+struct Buffer
+{
+    std::vector<char> storage;
+    GLintptr mappedOffset = 0;
+    GLsizeiptr mappedLength = 0;
+    bool mappedForWrite = false;
+};
+
+struct VertexAttribute
+{
+    bool enabled = false;
+    std::tuple<GLint, GLenum, GLboolean, GLsizei, const GLvoid*, GLuint> pointer;
+};
+
+struct VertexArray
+{
+    GLuint elementBuffer = 0;
+    std::array<VertexAttribute, MAX_VERTEX_ATTRIBS> attributes;
+};
+
+struct State
+{
+    cocos2d::GLRecorder::FrameStats frame;
+    std::vector<cocos2d::GLRecorder::FrameStats> frames;
+
+    GLuint nextName = 1;
+    std::unordered_map<GLuint, Shader> shaders;
+    std::unordered_map<GLuint, Program> programs;
+    std::unordered_map<GLuint, Buffer> buffers;
+    // vertex array 0 is the default one
+    std::unordered_map<GLuint, VertexArray> vertexArrays;
+    std::map<std::pair<GLuint, GLint>, std::vector<char>> uniformValues;
+
+    std::map<GLenum, bool> capabilities;
+    GLuint program = 0;
+    GLuint arrayBuffer = 0;
+    GLuint vertexArray = 0;
+    GLuint framebuffer = 0;
+    GLuint renderbuffer = 0;
+    GLenum activeTexture = GL_TEXTURE0;
+    std::map<std::pair<GLenum, GLenum>, GLuint> textures;
+
+    std::pair<GLenum, GLenum> blendFunc = { GL_ONE, GL_ZERO };
+    std::array<GLenum, 4> blendFuncSeparate = {{ GL_ONE, GL_ZERO, GL_ONE, GL_ZERO }};
+    GLenum blendEquation = GL_FUNC_ADD;
+    GLboolean depthMask = GL_TRUE;
+    GLenum depthFunc = GL_LESS;
+    std::array<GLboolean, 4> colorMask = {{ GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE }};
+    GLenum cullFace = GL_BACK;
+    GLenum frontFace = GL_CCW;
+    std::tuple<GLenum, GLint, GLuint> stencilFunc = std::make_tuple(GL_ALWAYS, 0, ~0u);
+    std::tuple<GLenum, GLenum, GLenum> stencilOp = std::make_tuple(GL_KEEP, GL_KEEP, GL_KEEP);
+    GLuint stencilMask = ~0u;
+    std::pair<GLenum, GLfloat> alphaFunc = { GL_ALWAYS, 0.0f };
+    std::array<GLint, 4> viewport = {{ 0, 0, 0, 0 }};
+    std::array<GLint, 4> scissor = {{ 0, 0, 0, 0 }};
+    std::array<GLfloat, 4> clearColor = {{ 0.0f, 0.0f, 0.0f, 0.0f }};
+    GLdouble clearDepth = 1.0;
+    GLint clearStencil = 0;
+    GLfloat lineWidth = 1.0f;
+    GLfloat pointSize = 1.0f;
+    std::map<GLenum, GLint> pixelStore;
+
+    VertexArray& currentVertexArray() { return vertexArrays[vertexArray]; }
+};
+
+State& state()
+{
+    static State s_state;
+    return s_state;
+}
+
+template <typename T>
+void setState(T& current, const T& value)
+{
+    auto& frame = state().frame;
+    ++frame.stateChanges;
+    if (current == value)
+    {
+        ++frame.redundantStateChanges;
+    }
+    current = value;
+}
+
+void genNames(GLsizei n, GLuint* names)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        names[i] = state().nextName++;
+    }
+}
+
+void copyString(const std::string& string, GLsizei bufSize, GLsizei* length, GLchar* buffer)
+{
+    GLsizei copied = 0;
+    if (buffer && bufSize > 0)
+    {
+        copied = std::min(static_cast<GLsizei>(string.size()), bufSize - 1);
+        std::memcpy(buffer, string.data(), copied);
+        buffer[copied] = '\0';
+    }
+    if (length)
+    {
+        *length = copied;
+    }
+}
+
+void recordUniform(GLint location, const void* value, size_t bytes)
+{
+    auto& s = state();
+    ++s.frame.uniformUploads;
+    s.frame.uniformBytes += bytes;
+
+    auto& last = s.uniformValues[std::make_pair(s.program, location)];
+    auto data = static_cast<const char*>(value);
+    if (last.size() == bytes && std::equal(last.begin(), last.end(), data))
+    {
+        ++s.frame.redundantUniformUploads;
+    }
+    last.assign(data, data + bytes);
+}
+
+// the active variables of a program are the ones its shaders declare, used or not
+
+GLenum variableType(const std::string& type)
+{
+    static const std::map<std::string, GLenum> types = {
+        { "float", GL_FLOAT }, { "vec2", GL_FLOAT_VEC2 }, { "vec3", GL_FLOAT_VEC3 }, { "vec4", GL_FLOAT_VEC4 },
+        { "int", GL_INT }, { "ivec2", GL_INT_VEC2 }, { "ivec3", GL_INT_VEC3 }, { "ivec4", GL_INT_VEC4 },
+        { "bool", GL_BOOL }, { "mat2", GL_FLOAT_MAT2 }, { "mat3", GL_FLOAT_MAT3 }, { "mat4", GL_FLOAT_MAT4 },
+        { "sampler2D", GL_SAMPLER_2D }, { "samplerCube", GL_SAMPLER_CUBE },
+    };
+    auto it = types.find(type);
+    return it == types.end() ? 0 : it->second;
+}
+
+void parseDeclarations(const std::string& source, const char* keyword, std::vector<Variable>& variables)
+{
+    std::string spaced;
+    spaced.reserve(source.size() * 2);
+    for (char c : source)
+    {
+        if (c == ',' || c == ';' || c == '(' || c == ')' || c == '{' || c == '}')
+        {
+            spaced += ' ';
+            spaced += c;
+            spaced += ' ';
+        }
+        else
+        {
+            spaced += c;
+        }
+    }
+
+    std::istringstream tokens(spaced);
+    std::string token;
+    while (tokens >> token)
+    {
+        if (token != keyword)
+            continue;
+
+        std::string type;
+        while (tokens >> type && (type == "lowp" || type == "mediump" || type == "highp"))
+        {
+        }
+        GLenum glType = variableType(type);
+
+        std::string name;
+        while (tokens >> name && name != ";")
+        {
+            if (name == "," || glType == 0)
+                continue;
+
+            // arrays are reported as name[0], as GL does
+            GLint size = 1;
+            auto bracket = name.find('[');
+            if (bracket != std::string::npos)
+            {
+                size = std::max(std::atoi(name.c_str() + bracket + 1), 1);
+                name = name.substr(0, bracket) + "[0]";
+            }
+            auto found = std::find_if(variables.begin(), variables.end(), [&name](const Variable& v) { return v.name == name; });
+            if (found == variables.end())
+            {
+                variables.push_back({ name, glType, size, -1 });
+            }
+        }
+    }
+}
+
+GLint findLocation(const std::vector<Variable>& variables, const GLchar* name)
+{
+    // name, name[0] and name[i] address the elements of an array
+    std::string base(name);
+    GLint element = 0;
+    auto bracket = base.find('[');
+    if (bracket != std::string::npos)
+    {
+        element = std::atoi(base.c_str() + bracket + 1);
+        base.erase(bracket);
+    }
+    for (auto& variable : variables)
+    {
+        if (variable.name.compare(0, base.size(), base) == 0
+            && (variable.name.size() == base.size() || variable.name[base.size()] == '[')
+            && element < variable.size)
+        {
+            return variable.location + element;
+        }
+    }
+    return -1;
+}
+
+GLint maxNameLength(const std::vector<Variable>& variables)
+{
+    size_t length = 0;
+    for (auto& variable : variables)
+    {
+        length = std::max(length, variable.name.size() + 1);
+    }
+    return static_cast<GLint>(length);
+}
+
+size_t pixelBytes(GLenum format, GLenum type)
+{
+    switch (type)
+    {
+        case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_5_5_5_1:
+        case GL_UNSIGNED_SHORT_5_6_5:
+            return 2;
+        default:
+            break;
+    }
+    switch (format)
+    {
+        case GL_RGBA:
+        case GL_BGRA:
+            return 4;
+        case GL_RGB:
+            return 3;
+        case GL_LUMINANCE_ALPHA:
+            return 2;
+        default:
+            return 1;
+    }
+}
+
+void recordTextureUpload(GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* pixels)
+{
+    if (!pixels)
+        return;
+    auto& frame = state().frame;
+    ++frame.textureUploads;
+    frame.textureBytes += static_cast<size_t>(width) * height * pixelBytes(format, type);
+}
+
+Buffer* boundBuffer(GLenum target)
+{
+    auto& s = state();
+    GLuint name = target == GL_ELEMENT_ARRAY_BUFFER ? s.currentVertexArray().elementBuffer : s.arrayBuffer;
+    if (name == 0)
+        return nullptr;
+    return &s.buffers[name];
+}
+
+// the entry points GLEW loads from the driver
+
+void GLAPIENTRY activeTexture(GLenum texture)
+{
+    setState(state().activeTexture, texture);
+}
+
+void GLAPIENTRY blendEquation(GLenum mode)
+{
+    setState(state().blendEquation, mode);
+}
+
+void GLAPIENTRY blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+    setState(state().blendFuncSeparate, std::array<GLenum, 4>{{ srcRGB, dstRGB, srcAlpha, dstAlpha }});
+}
+
+void GLAPIENTRY compressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height,
+                                     GLint border, GLsizei imageSize, const GLvoid* data)
+{
+    if (!data)
+        return;
+    auto& frame = state().frame;
+    ++frame.textureUploads;
+    frame.textureBytes += imageSize;
+}
+
+void GLAPIENTRY generateMipmap(GLenum target)
+{
+}
+
+void GLAPIENTRY genBuffers(GLsizei n, GLuint* buffers)
+{
+    genNames(n, buffers);
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        state().buffers[buffers[i]];
+    }
+}
+
+void GLAPIENTRY deleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    auto& s = state();
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        s.buffers.erase(buffers[i]);
+        if (s.arrayBuffer == buffers[i])
+            s.arrayBuffer = 0;
+        if (s.currentVertexArray().elementBuffer == buffers[i])
+            s.currentVertexArray().elementBuffer = 0;
+    }
+}
+
+GLboolean GLAPIENTRY isBuffer(GLuint buffer)
+{
+    return state().buffers.count(buffer) ? GL_TRUE : GL_FALSE;
+}
+
+void GLAPIENTRY bindBuffer(GLenum target, GLuint buffer)
+{
+    auto& s = state();
+    if (target == GL_ELEMENT_ARRAY_BUFFER)
+        setState(s.currentVertexArray().elementBuffer, buffer);
+    else if (target == GL_ARRAY_BUFFER)
+        setState(s.arrayBuffer, buffer);
+}
+
+void GLAPIENTRY bufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+    auto buffer = boundBuffer(target);
+    if (!buffer)
+        return;
+    buffer->storage.resize(size);
+    if (data)
+    {
+        std::memcpy(buffer->storage.data(), data, size);
+        ++state().frame.bufferUploads;
+        state().frame.bufferBytes += size;
+    }
+}
+
+void GLAPIENTRY bufferStorage(GLenum target, GLsizeiptr size, const GLvoid* data, GLbitfield flags)
+{
+    bufferData(target, size, data, GL_STATIC_DRAW);
+}
+
+void GLAPIENTRY bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+    auto buffer = boundBuffer(target);
+    if (!buffer || !data || offset + size > static_cast<GLintptr>(buffer->storage.size()))
+        return;
+    std::memcpy(buffer->storage.data() + offset, data, size);
+    ++state().frame.bufferUploads;
+    state().frame.bufferBytes += size;
+}
+
+GLvoid* GLAPIENTRY mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    auto buffer = boundBuffer(target);
+    if (!buffer || offset + length > static_cast<GLintptr>(buffer->storage.size()))
+        return nullptr;
+    buffer->mappedOffset = offset;
+    buffer->mappedLength = length;
+    buffer->mappedForWrite = (access & GL_MAP_WRITE_BIT) != 0;
+    return buffer->storage.data() + offset;
+}
+
+GLvoid* GLAPIENTRY mapBuffer(GLenum target, GLenum access)
+{
+    auto buffer = boundBuffer(target);
+    if (!buffer)
+        return nullptr;
+    return mapBufferRange(target, 0, buffer->storage.size(), access == GL_READ_ONLY ? GL_MAP_READ_BIT : GL_MAP_WRITE_BIT);
+}
+
+GLboolean GLAPIENTRY unmapBuffer(GLenum target)
+{
+    auto buffer = boundBuffer(target);
+    if (!buffer)
+        return GL_FALSE;
+    // a mapping for writing counts as written through
+    if (buffer->mappedForWrite)
+    {
+        ++state().frame.bufferUploads;
+        state().frame.bufferBytes += buffer->mappedLength;
+    }
+    buffer->mappedLength = 0;
+    buffer->mappedForWrite = false;
+    return GL_TRUE;
+}
+
+void GLAPIENTRY genVertexArrays(GLsizei n, GLuint* arrays)
+{
+    genNames(n, arrays);
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        state().vertexArrays[arrays[i]];
+    }
+}
+
+void GLAPIENTRY deleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+    auto& s = state();
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        if (arrays[i] == 0)
+            continue;
+        s.vertexArrays.erase(arrays[i]);
+        if (s.vertexArray == arrays[i])
+            s.vertexArray = 0;
+    }
+}
+
+void GLAPIENTRY bindVertexArray(GLuint array)
+{
+    setState(state().vertexArray, array);
+}
+
+void GLAPIENTRY enableVertexAttribArray(GLuint index)
+{
+    if (index < MAX_VERTEX_ATTRIBS)
+        setState(state().currentVertexArray().attributes[index].enabled, true);
+}
+
+void GLAPIENTRY disableVertexAttribArray(GLuint index)
+{
+    if (index < MAX_VERTEX_ATTRIBS)
+        setState(state().currentVertexArray().attributes[index].enabled, false);
+}
+
+void GLAPIENTRY vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer)
+{
+    auto& s = state();
+    if (index < MAX_VERTEX_ATTRIBS)
+        setState(s.currentVertexArray().attributes[index].pointer, std::make_tuple(size, type, normalized, stride, pointer, s.arrayBuffer));
+}
+
+GLuint GLAPIENTRY createShader(GLenum type)
+{
+    auto& s = state();
+    GLuint name = s.nextName++;
+    s.shaders[name].type = type;
+    return name;
+}
+
+void GLAPIENTRY deleteShader(GLuint shader)
+{
+    state().shaders.erase(shader);
+}
+
+void GLAPIENTRY shaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+{
+    auto& source = state().shaders[shader].source;
+    source.clear();
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (length && length[i] >= 0)
+            source.append(string[i], length[i]);
+        else
+            source.append(string[i]);
+    }
+}
+
+void GLAPIENTRY compileShader(GLuint shader)
+{
+}
+
+void GLAPIENTRY getShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    auto& s = state();
+    switch (pname)
+    {
+        case GL_SHADER_TYPE:
+            *params = s.shaders[shader].type;
+            break;
+        case GL_SHADER_SOURCE_LENGTH:
+            *params = static_cast<GLint>(s.shaders[shader].source.size() + 1);
+            break;
+        case GL_COMPILE_STATUS:
+            *params = GL_TRUE;
+            break;
+        default:
+            *params = 0;
+            break;
+    }
+}
+
+void GLAPIENTRY getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    copyString("", bufSize, length, infoLog);
+}
+
+void GLAPIENTRY getShaderSource(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* source)
+{
+    copyString(state().shaders[shader].source, bufSize, length, source);
+}
+
+GLuint GLAPIENTRY createProgram()
+{
+    auto& s = state();
+    GLuint name = s.nextName++;
+    s.programs[name];
+    return name;
+}
+
+void GLAPIENTRY deleteProgram(GLuint program)
+{
+    auto& s = state();
+    s.programs.erase(program);
+    for (auto it = s.uniformValues.begin(); it != s.uniformValues.end();)
+    {
+        it = it->first.first == program ? s.uniformValues.erase(it) : std::next(it);
+    }
+}
+
+void GLAPIENTRY attachShader(GLuint program, GLuint shader)
+{
+    state().programs[program].shaders.push_back(shader);
+}
+
+void GLAPIENTRY bindAttribLocation(GLuint program, GLuint index, const GLchar* name)
+{
+    state().programs[program].boundAttributes[name] = index;
+}
+
+void GLAPIENTRY linkProgram(GLuint name)
+{
+    auto& s = state();
+    auto& program = s.programs[name];
+    program.attributes.clear();
+    program.uniforms.clear();
+    for (auto shader : program.shaders)
+    {
+        auto& attached = s.shaders[shader];
+        if (attached.type == GL_VERTEX_SHADER)
+            parseDeclarations(attached.source, "attribute", program.attributes);
+        parseDeclarations(attached.source, "uniform", program.uniforms);
+    }
+
+    GLint location = 0;
+    for (auto& uniform : program.uniforms)
+    {
+        uniform.location = location;
+        location += uniform.size;
+    }
+
+    // the bound locations first, then the lowest free ones
+    std::vector<bool> used(MAX_VERTEX_ATTRIBS, false);
+    for (auto& attribute : program.attributes)
+    {
+        auto bound = program.boundAttributes.find(attribute.name);
+        if (bound != program.boundAttributes.end() && bound->second < MAX_VERTEX_ATTRIBS)
+        {
+            attribute.location = bound->second;
+            used[attribute.location] = true;
+        }
+    }
+    for (auto& attribute : program.attributes)
+    {
+        if (attribute.location >= 0)
+            continue;
+        auto free = std::find(used.begin(), used.end(), false);
+        if (free == used.end())
+            break;
+        *free = true;
+        attribute.location = static_cast<GLint>(free - used.begin());
+    }
+}
+
+void GLAPIENTRY getProgramiv(GLuint name, GLenum pname, GLint* params)
+{
+    auto& program = state().programs[name];
+    switch (pname)
+    {
+        case GL_LINK_STATUS:
+        case GL_VALIDATE_STATUS:
+            *params = GL_TRUE;
+            break;
+        case GL_ATTACHED_SHADERS:
+            *params = static_cast<GLint>(program.shaders.size());
+            break;
+        case GL_ACTIVE_ATTRIBUTES:
+            *params = static_cast<GLint>(program.attributes.size());
+            break;
+        case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH:
+            *params = maxNameLength(program.attributes);
+            break;
+        case GL_ACTIVE_UNIFORMS:
+            *params = static_cast<GLint>(program.uniforms.size());
+            break;
+        case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+            *params = maxNameLength(program.uniforms);
+            break;
+        default:
+            *params = 0;
+            break;
+    }
+}
+
+void GLAPIENTRY getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    copyString("", bufSize, length, infoLog);
+}
+
+void getActiveVariable(const std::vector<Variable>& variables, GLuint index, GLsizei bufSize, GLsizei* length,
+                       GLint* size, GLenum* type, GLchar* name)
+{
+    if (index >= variables.size())
+    {
+        copyString("", bufSize, length, name);
+        return;
+    }
+    auto& variable = variables[index];
+    copyString(variable.name, bufSize, length, name);
+    *size = variable.size;
+    *type = variable.type;
+}
+
+void GLAPIENTRY getActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    getActiveVariable(state().programs[program].attributes, index, bufSize, length, size, type, name);
+}
+
+void GLAPIENTRY getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    getActiveVariable(state().programs[program].uniforms, index, bufSize, length, size, type, name);
+}
+
+GLint GLAPIENTRY getAttribLocation(GLuint program, const GLchar* name)
+{
+    return findLocation(state().programs[program].attributes, name);
+}
+
+GLint GLAPIENTRY getUniformLocation(GLuint program, const GLchar* name)
+{
+    return findLocation(state().programs[program].uniforms, name);
+}
+
+void GLAPIENTRY useProgram(GLuint program)
+{
+    auto& s = state();
+    if (s.program != program)
+        ++s.frame.programChanges;
+    setState(s.program, program);
+}
+
+void GLAPIENTRY uniform1f(GLint location, GLfloat v0)
+{
+    recordUniform(location, &v0, sizeof(v0));
+}
+
+void GLAPIENTRY uniform2f(GLint location, GLfloat v0, GLfloat v1)
+{
+    GLfloat v[] = { v0, v1 };
+    recordUniform(location, v, sizeof(v));
+}
+
+void GLAPIENTRY uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+{
+    GLfloat v[] = { v0, v1, v2 };
+    recordUniform(location, v, sizeof(v));
+}
+
+void GLAPIENTRY uniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+    GLfloat v[] = { v0, v1, v2, v3 };
+    recordUniform(location, v, sizeof(v));
+}
+
+void GLAPIENTRY uniform1i(GLint location, GLint v0)
+{
+    recordUniform(location, &v0, sizeof(v0));
+}
+
+void GLAPIENTRY uniform2i(GLint location, GLint v0, GLint v1)
+{
+    GLint v[] = { v0, v1 };
+    recordUniform(location, v, sizeof(v));
+}
+
+void GLAPIENTRY uniform3i(GLint location, GLint v0, GLint v1, GLint v2)
+{
+    GLint v[] = { v0, v1, v2 };
+    recordUniform(location, v, sizeof(v));
+}
+
+void GLAPIENTRY uniform4i(GLint location, GLint v0, GLint v1, GLint v2, GLint v3)
+{
+    GLint v[] = { v0, v1, v2, v3 };
+    recordUniform(location, v, sizeof(v));
+}
+
+void GLAPIENTRY uniform1fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    recordUniform(location, value, sizeof(GLfloat) * count);
+}
+
+void GLAPIENTRY uniform2fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    recordUniform(location, value, sizeof(GLfloat) * 2 * count);
+}
+
+void GLAPIENTRY uniform3fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    recordUniform(location, value, sizeof(GLfloat) * 3 * count);
+}
+
+void GLAPIENTRY uniform4fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    recordUniform(location, value, sizeof(GLfloat) * 4 * count);
+}
+
+void GLAPIENTRY uniform1iv(GLint location, GLsizei count, const GLint* value)
+{
+    recordUniform(location, value, sizeof(GLint) * count);
+}
+
+void GLAPIENTRY uniform2iv(GLint location, GLsizei count, const GLint* value)
+{
+    recordUniform(location, value, sizeof(GLint) * 2 * count);
+}
+
+void GLAPIENTRY uniform3iv(GLint location, GLsizei count, const GLint* value)
+{
+    recordUniform(location, value, sizeof(GLint) * 3 * count);
+}
+
+void GLAPIENTRY uniform4iv(GLint location, GLsizei count, const GLint* value)
+{
+    recordUniform(location, value, sizeof(GLint) * 4 * count);
+}
+
+void GLAPIENTRY uniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    recordUniform(location, value, sizeof(GLfloat) * 4 * count);
+}
+
+void GLAPIENTRY uniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    recordUniform(location, value, sizeof(GLfloat) * 9 * count);
+}
+
+void GLAPIENTRY uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    recordUniform(location, value, sizeof(GLfloat) * 16 * count);
+}
+
+void GLAPIENTRY genFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+    genNames(n, framebuffers);
+}
+
+void GLAPIENTRY deleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+}
+
+void GLAPIENTRY bindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    setState(state().framebuffer, framebuffer);
+}
+
+GLenum GLAPIENTRY checkFramebufferStatus(GLenum target)
+{
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+void GLAPIENTRY framebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+}
+
+void GLAPIENTRY framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+{
+}
+
+void GLAPIENTRY genRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+    genNames(n, renderbuffers);
+}
+
+void GLAPIENTRY deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+}
+
+GLboolean GLAPIENTRY isRenderbuffer(GLuint renderbuffer)
+{
+    return renderbuffer != 0 ? GL_TRUE : GL_FALSE;
+}
+
+void GLAPIENTRY bindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    setState(state().renderbuffer, renderbuffer);
+}
+
+void GLAPIENTRY renderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+}
+
+// nothing runs on a GPU, every fence is signaled when it is made
+
+GLsync GLAPIENTRY fenceSync(GLenum condition, GLbitfield flags)
+{
+    return reinterpret_cast<GLsync>(static_cast<uintptr_t>(state().nextName++));
+}
+
+GLenum GLAPIENTRY clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+    return GL_ALREADY_SIGNALED;
+}
+
+void GLAPIENTRY deleteSync(GLsync sync)
+{
+}
+
+void writeStats(FILE* file, const cocos2d::GLRecorder::FrameStats& stats, double divisor)
+{
+    std::fprintf(file, "{ \"drawCalls\": %.15g, \"vertices\": %.15g, \"stateChanges\": %.15g, \"redundantStateChanges\": %.15g, "
+                 "\"programChanges\": %.15g, \"textureBinds\": %.15g, \"uniformUploads\": %.15g, \"redundantUniformUploads\": %.15g, "
+                 "\"uniformBytes\": %.15g, \"bufferUploads\": %.15g, \"bufferBytes\": %.15g, \"textureUploads\": %.15g, \"textureBytes\": %.15g }",
+                 stats.drawCalls / divisor, stats.vertices / divisor, stats.stateChanges / divisor,
+                 stats.redundantStateChanges / divisor, stats.programChanges / divisor, stats.textureBinds / divisor,
+                 stats.uniformUploads / divisor, stats.redundantUniformUploads / divisor, stats.uniformBytes / divisor,
+                 stats.bufferUploads / divisor, stats.bufferBytes / divisor, stats.textureUploads / divisor,
+                 stats.textureBytes / divisor);
+}
+
+} // namespace
+
+// the GL 1.1 entry points, the executable links these instead of the driver's
+
+void GLAPIENTRY glEnable(GLenum cap)
+{
+    setState(state().capabilities[cap], true);
+}
+
+void GLAPIENTRY glDisable(GLenum cap)
+{
+    setState(state().capabilities[cap], false);
+}
+
+GLboolean GLAPIENTRY glIsEnabled(GLenum cap)
+{
+    return state().capabilities[cap] ? GL_TRUE : GL_FALSE;
+}
+
+void GLAPIENTRY glEnableClientState(GLenum array)
+{
+    ++state().frame.stateChanges;
+}
+
+void GLAPIENTRY glGetIntegerv(GLenum pname, GLint* params)
+{
+    auto& s = state();
+    switch (pname)
+    {
+        case GL_MAX_TEXTURE_SIZE:
+            *params = MAX_TEXTURE_SIZE;
+            break;
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_TEXTURE_IMAGE_UNITS:
+            *params = MAX_TEXTURE_UNITS;
+            break;
+        case GL_MAX_VERTEX_ATTRIBS:
+            *params = MAX_VERTEX_ATTRIBS;
+            break;
+        case GL_VIEWPORT:
+            std::copy(s.viewport.begin(), s.viewport.end(), params);
+            break;
+        case GL_SCISSOR_BOX:
+            std::copy(s.scissor.begin(), s.scissor.end(), params);
+            break;
+        case GL_FRAMEBUFFER_BINDING:
+            *params = s.framebuffer;
+            break;
+        case GL_RENDERBUFFER_BINDING:
+            *params = s.renderbuffer;
+            break;
+        case GL_CURRENT_PROGRAM:
+            *params = s.program;
+            break;
+        case GL_ARRAY_BUFFER_BINDING:
+            *params = s.arrayBuffer;
+            break;
+        case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+            *params = s.currentVertexArray().elementBuffer;
+            break;
+        case GL_VERTEX_ARRAY_BINDING:
+            *params = s.vertexArray;
+            break;
+        case GL_ACTIVE_TEXTURE:
+            *params = s.activeTexture;
+            break;
+        case GL_TEXTURE_BINDING_2D:
+            *params = s.textures[std::make_pair(s.activeTexture, static_cast<GLenum>(GL_TEXTURE_2D))];
+            break;
+        case GL_DEPTH_FUNC:
+            *params = s.depthFunc;
+            break;
+        case GL_STENCIL_FUNC:
+            *params = std::get<0>(s.stencilFunc);
+            break;
+        case GL_STENCIL_REF:
+            *params = std::get<1>(s.stencilFunc);
+            break;
+        case GL_STENCIL_VALUE_MASK:
+            *params = std::get<2>(s.stencilFunc);
+            break;
+        case GL_STENCIL_FAIL:
+            *params = std::get<0>(s.stencilOp);
+            break;
+        case GL_STENCIL_PASS_DEPTH_FAIL:
+            *params = std::get<1>(s.stencilOp);
+            break;
+        case GL_STENCIL_PASS_DEPTH_PASS:
+            *params = std::get<2>(s.stencilOp);
+            break;
+        case GL_STENCIL_WRITEMASK:
+            *params = s.stencilMask;
+            break;
+        case GL_STENCIL_CLEAR_VALUE:
+            *params = s.clearStencil;
+            break;
+        case GL_ALPHA_TEST_FUNC:
+            *params = s.alphaFunc.first;
+            break;
+        case GL_STENCIL_BITS:
+            *params = 8;
+            break;
+        case GL_DEPTH_BITS:
+            *params = 24;
+            break;
+        case GL_UNPACK_ALIGNMENT:
+        case GL_PACK_ALIGNMENT:
+            *params = s.pixelStore.count(pname) ? s.pixelStore[pname] : 4;
+            break;
+        default:
+            *params = 0;
+            break;
+    }
+}
+
+void GLAPIENTRY glGetFloatv(GLenum pname, GLfloat* params)
+{
+    auto& s = state();
+    switch (pname)
+    {
+        case GL_COLOR_CLEAR_VALUE:
+            std::copy(s.clearColor.begin(), s.clearColor.end(), params);
+            break;
+        case GL_DEPTH_CLEAR_VALUE:
+            *params = static_cast<GLfloat>(s.clearDepth);
+            break;
+        case GL_ALPHA_TEST_REF:
+            *params = s.alphaFunc.second;
+            break;
+        case GL_LINE_WIDTH:
+            *params = s.lineWidth;
+            break;
+        case GL_POINT_SIZE:
+            *params = s.pointSize;
+            break;
+        case GL_VIEWPORT:
+        case GL_SCISSOR_BOX:
+        {
+            GLint box[4];
+            glGetIntegerv(pname, box);
+            std::copy(box, box + 4, params);
+            break;
+        }
+        default:
+            *params = 0.0f;
+            break;
+    }
+}
+
+void GLAPIENTRY glGetBooleanv(GLenum pname, GLboolean* params)
+{
+    auto& s = state();
+    switch (pname)
+    {
+        case GL_DEPTH_WRITEMASK:
+            *params = s.depthMask;
+            break;
+        case GL_COLOR_WRITEMASK:
+            std::copy(s.colorMask.begin(), s.colorMask.end(), params);
+            break;
+        default:
+            *params = s.capabilities[pname] ? GL_TRUE : GL_FALSE;
+            break;
+    }
+}
+
+GLenum GLAPIENTRY glGetError()
+{
+    return GL_NO_ERROR;
+}
+
+const GLubyte* GLAPIENTRY glGetString(GLenum name)
+{
+    switch (name)
+    {
+        case GL_VENDOR:
+            return reinterpret_cast<const GLubyte*>("cocos2d-x");
+        case GL_RENDERER:
+            return reinterpret_cast<const GLubyte*>("GLRecorder");
+        case GL_VERSION:
+            return reinterpret_cast<const GLubyte*>("2.1 GLRecorder");
+        case GL_SHADING_LANGUAGE_VERSION:
+            return reinterpret_cast<const GLubyte*>("1.20");
+        case GL_EXTENSIONS:
+            return reinterpret_cast<const GLubyte*>(EXTENSIONS);
+        default:
+            return nullptr;
+    }
+}
+
+void GLAPIENTRY glHint(GLenum target, GLenum mode)
+{
+}
+
+void GLAPIENTRY glPixelStorei(GLenum pname, GLint param)
+{
+    state().pixelStore[pname] = param;
+}
+
+void GLAPIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    setState(state().viewport, std::array<GLint, 4>{{ x, y, width, height }});
+}
+
+void GLAPIENTRY glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    setState(state().scissor, std::array<GLint, 4>{{ x, y, width, height }});
+}
+
+void GLAPIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    setState(state().blendFunc, std::make_pair(sfactor, dfactor));
+}
+
+void GLAPIENTRY glDepthMask(GLboolean flag)
+{
+    setState(state().depthMask, flag);
+}
+
+void GLAPIENTRY glDepthFunc(GLenum func)
+{
+    setState(state().depthFunc, func);
+}
+
+void GLAPIENTRY glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    setState(state().colorMask, std::array<GLboolean, 4>{{ red, green, blue, alpha }});
+}
+
+void GLAPIENTRY glCullFace(GLenum mode)
+{
+    setState(state().cullFace, mode);
+}
+
+void GLAPIENTRY glFrontFace(GLenum mode)
+{
+    setState(state().frontFace, mode);
+}
+
+void GLAPIENTRY glPolygonMode(GLenum face, GLenum mode)
+{
+    ++state().frame.stateChanges;
+}
+
+void GLAPIENTRY glStencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+    setState(state().stencilFunc, std::make_tuple(func, ref, mask));
+}
+
+void GLAPIENTRY glStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+{
+    setState(state().stencilOp, std::make_tuple(fail, zfail, zpass));
+}
+
+void GLAPIENTRY glStencilMask(GLuint mask)
+{
+    setState(state().stencilMask, mask);
+}
+
+void GLAPIENTRY glAlphaFunc(GLenum func, GLclampf ref)
+{
+    setState(state().alphaFunc, std::make_pair(func, static_cast<GLfloat>(ref)));
+}
+
+void GLAPIENTRY glLineWidth(GLfloat width)
+{
+    setState(state().lineWidth, width);
+}
+
+void GLAPIENTRY glPointSize(GLfloat size)
+{
+    setState(state().pointSize, size);
+}
+
+void GLAPIENTRY glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+{
+    state().clearColor = {{ red, green, blue, alpha }};
+}
+
+void GLAPIENTRY glClearDepth(GLclampd depth)
+{
+    state().clearDepth = depth;
+}
+
+void GLAPIENTRY glClearStencil(GLint s)
+{
+    state().clearStencil = s;
+}
+
+void GLAPIENTRY glClear(GLbitfield mask)
+{
+}
+
+void GLAPIENTRY glGenTextures(GLsizei n, GLuint* textures)
+{
+    genNames(n, textures);
+}
+
+void GLAPIENTRY glDeleteTextures(GLsizei n, const GLuint* textures)
+{
+    auto& bound = state().textures;
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        for (auto& binding : bound)
+        {
+            if (binding.second == textures[i])
+                binding.second = 0;
+        }
+    }
+}
+
+void GLAPIENTRY glBindTexture(GLenum target, GLuint texture)
+{
+    auto& s = state();
+    ++s.frame.textureBinds;
+    setState(s.textures[std::make_pair(s.activeTexture, target)], texture);
+}
+
+void GLAPIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+}
+
+void GLAPIENTRY glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                             GLint border, GLenum format, GLenum type, const GLvoid* pixels)
+{
+    recordTextureUpload(width, height, format, type, pixels);
+}
+
+void GLAPIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+                                GLenum format, GLenum type, const GLvoid* pixels)
+{
+    recordTextureUpload(width, height, format, type, pixels);
+}
+
+void GLAPIENTRY glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels)
+{
+    std::memset(pixels, 0, static_cast<size_t>(width) * height * pixelBytes(format, type));
+}
+
+void GLAPIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    auto& frame = state().frame;
+    ++frame.drawCalls;
+    frame.vertices += count;
+}
+
+void GLAPIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices)
+{
+    auto& frame = state().frame;
+    ++frame.drawCalls;
+    frame.vertices += count;
+}
+
+NS_CC_BEGIN
+
+// the signatures of a few pointers differ in constness between GLEW versions
+#define CC_GL_RECORD(pointer, function) pointer = reinterpret_cast<decltype(pointer)>(&function)
+
+void GLRecorder::FrameStats::add(const FrameStats& other)
+{
+    drawCalls += other.drawCalls;
+    vertices += other.vertices;
+    stateChanges += other.stateChanges;
+    redundantStateChanges += other.redundantStateChanges;
+    programChanges += other.programChanges;
+    textureBinds += other.textureBinds;
+    uniformUploads += other.uniformUploads;
+    redundantUniformUploads += other.redundantUniformUploads;
+    uniformBytes += other.uniformBytes;
+    bufferUploads += other.bufferUploads;
+    bufferBytes += other.bufferBytes;
+    textureUploads += other.textureUploads;
+    textureBytes += other.textureBytes;
+}
+
+void GLRecorder::install()
+{
+    CC_GL_RECORD(__glewActiveTexture, activeTexture);
+    CC_GL_RECORD(__glewBlendEquation, blendEquation);
+    CC_GL_RECORD(__glewBlendFuncSeparate, blendFuncSeparate);
+    CC_GL_RECORD(__glewCompressedTexImage2D, compressedTexImage2D);
+    CC_GL_RECORD(__glewGenerateMipmap, generateMipmap);
+
+    CC_GL_RECORD(__glewGenBuffers, genBuffers);
+    CC_GL_RECORD(__glewDeleteBuffers, deleteBuffers);
+    CC_GL_RECORD(__glewIsBuffer, isBuffer);
+    CC_GL_RECORD(__glewBindBuffer, bindBuffer);
+    CC_GL_RECORD(__glewBufferData, bufferData);
+    CC_GL_RECORD(__glewBufferStorage, bufferStorage);
+    CC_GL_RECORD(__glewBufferSubData, bufferSubData);
+    CC_GL_RECORD(__glewMapBuffer, mapBuffer);
+    CC_GL_RECORD(__glewMapBufferRange, mapBufferRange);
+    CC_GL_RECORD(__glewUnmapBuffer, unmapBuffer);
+
+    CC_GL_RECORD(__glewGenVertexArrays, genVertexArrays);
+    CC_GL_RECORD(__glewDeleteVertexArrays, deleteVertexArrays);
+    CC_GL_RECORD(__glewBindVertexArray, bindVertexArray);
+    CC_GL_RECORD(__glewEnableVertexAttribArray, enableVertexAttribArray);
+    CC_GL_RECORD(__glewDisableVertexAttribArray, disableVertexAttribArray);
+    CC_GL_RECORD(__glewVertexAttribPointer, vertexAttribPointer);
+
+    CC_GL_RECORD(__glewCreateShader, createShader);
+    CC_GL_RECORD(__glewDeleteShader, deleteShader);
+    CC_GL_RECORD(__glewShaderSource, shaderSource);
+    CC_GL_RECORD(__glewCompileShader, compileShader);
+    CC_GL_RECORD(__glewGetShaderiv, getShaderiv);
+    CC_GL_RECORD(__glewGetShaderInfoLog, getShaderInfoLog);
+    CC_GL_RECORD(__glewGetShaderSource, getShaderSource);
+    CC_GL_RECORD(__glewCreateProgram, createProgram);
+    CC_GL_RECORD(__glewDeleteProgram, deleteProgram);
+    CC_GL_RECORD(__glewAttachShader, attachShader);
+    CC_GL_RECORD(__glewBindAttribLocation, bindAttribLocation);
+    CC_GL_RECORD(__glewLinkProgram, linkProgram);
+    CC_GL_RECORD(__glewGetProgramiv, getProgramiv);
+    CC_GL_RECORD(__glewGetProgramInfoLog, getProgramInfoLog);
+    CC_GL_RECORD(__glewGetActiveAttrib, getActiveAttrib);
+    CC_GL_RECORD(__glewGetActiveUniform, getActiveUniform);
+    CC_GL_RECORD(__glewGetAttribLocation, getAttribLocation);
+    CC_GL_RECORD(__glewGetUniformLocation, getUniformLocation);
+    CC_GL_RECORD(__glewUseProgram, useProgram);
+
+    CC_GL_RECORD(__glewUniform1f, uniform1f);
+    CC_GL_RECORD(__glewUniform2f, uniform2f);
+    CC_GL_RECORD(__glewUniform3f, uniform3f);
+    CC_GL_RECORD(__glewUniform4f, uniform4f);
+    CC_GL_RECORD(__glewUniform1i, uniform1i);
+    CC_GL_RECORD(__glewUniform2i, uniform2i);
+    CC_GL_RECORD(__glewUniform3i, uniform3i);
+    CC_GL_RECORD(__glewUniform4i, uniform4i);
+    CC_GL_RECORD(__glewUniform1fv, uniform1fv);
+    CC_GL_RECORD(__glewUniform2fv, uniform2fv);
+    CC_GL_RECORD(__glewUniform3fv, uniform3fv);
+    CC_GL_RECORD(__glewUniform4fv, uniform4fv);
+    CC_GL_RECORD(__glewUniform1iv, uniform1iv);
+    CC_GL_RECORD(__glewUniform2iv, uniform2iv);
+    CC_GL_RECORD(__glewUniform3iv, uniform3iv);
+    CC_GL_RECORD(__glewUniform4iv, uniform4iv);
+    CC_GL_RECORD(__glewUniformMatrix2fv, uniformMatrix2fv);
+    CC_GL_RECORD(__glewUniformMatrix3fv, uniformMatrix3fv);
+    CC_GL_RECORD(__glewUniformMatrix4fv, uniformMatrix4fv);
+
+    CC_GL_RECORD(__glewGenFramebuffers, genFramebuffers);
+    CC_GL_RECORD(__glewDeleteFramebuffers, deleteFramebuffers);
+    CC_GL_RECORD(__glewBindFramebuffer, bindFramebuffer);
+    CC_GL_RECORD(__glewCheckFramebufferStatus, checkFramebufferStatus);
+    CC_GL_RECORD(__glewFramebufferTexture2D, framebufferTexture2D);
+    CC_GL_RECORD(__glewFramebufferRenderbuffer, framebufferRenderbuffer);
+    CC_GL_RECORD(__glewGenRenderbuffers, genRenderbuffers);
+    CC_GL_RECORD(__glewDeleteRenderbuffers, deleteRenderbuffers);
+    CC_GL_RECORD(__glewIsRenderbuffer, isRenderbuffer);
+    CC_GL_RECORD(__glewBindRenderbuffer, bindRenderbuffer);
+    CC_GL_RECORD(__glewRenderbufferStorage, renderbufferStorage);
+
+    CC_GL_RECORD(__glewFenceSync, fenceSync);
+    CC_GL_RECORD(__glewClientWaitSync, clientWaitSync);
+    CC_GL_RECORD(__glewDeleteSync, deleteSync);
+}
+
+#undef CC_GL_RECORD
+
+void GLRecorder::endFrame()
+{
+    auto& s = state();
+    s.frames.push_back(s.frame);
+    s.frame = FrameStats();
+}
+
+void GLRecorder::clearFrames()
+{
+    state().frames.clear();
+}
+
+const GLRecorder::FrameStats& GLRecorder::getCurrentFrame()
+{
+    return state().frame;
+}
+
+const std::vector<GLRecorder::FrameStats>& GLRecorder::getFrames()
+{
+    return state().frames;
+}
+
+bool GLRecorder::writeJson(const std::string& path)
+{
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    auto& frames = state().frames;
+    FrameStats total;
+    for (auto& frame : frames)
+    {
+        total.add(frame);
+    }
+
+    std::fprintf(file, "{\n  \"frameCount\": %zu,\n  \"total\": ", frames.size());
+    writeStats(file, total, 1.0);
+    std::fprintf(file, ",\n  \"average\": ");
+    writeStats(file, total, frames.empty() ? 1.0 : static_cast<double>(frames.size()));
+    std::fprintf(file, ",\n  \"frames\": [");
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        std::fprintf(file, i ? ",\n    " : "\n    ");
+        writeStats(file, frames[i], 1.0);
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+
+    return std::fclose(file) == 0;
+}
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
@@ -0,0 +1,100 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_GL_RECORDER_LINUX_H__
+#define __CC_GL_RECORDER_LINUX_H__
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include <string>
+#include <vector>
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * A GL that draws nothing and counts what the engine asks it for.
+ *
+ * It defines the GL 1.1 entry points itself, and install() points the GLEW function pointers
+ * at its own functions, so no driver and no context are needed. Object names, shader sources,
+ * buffer contents for mapping and the bound state are kept, the queries answer like a desktop
+ * GL 2.1 with vertex array objects, range mapping and sync objects. There is no buffer storage,
+ * so the stream buffer of the renderer maps every block.
+ *
+ * It is the separate cocos2d_nullgl library, which replaces the driver's functions in the
+ * whole executable. Only link it into benchmarks and tests, see GLViewNull.
+ */
+class GLRecorder
+{
+public:
+    /** What the engine asked GL for during one frame. */
+    struct FrameStats
+    {
+        unsigned drawCalls = 0;
+        /** Vertices, or indices for glDrawElements. */
+        unsigned vertices = 0;
+        /** Enables, binds, blend, depth, stencil, viewport and vertex attribute state. */
+        unsigned stateChanges = 0;
+        /** State changes that set the value GL already had. */
+        unsigned redundantStateChanges = 0;
+        unsigned programChanges = 0;
+        unsigned textureBinds = 0;
+        unsigned uniformUploads = 0;
+        /** Uniform uploads of the value the location already had. */
+        unsigned redundantUniformUploads = 0;
+        size_t uniformBytes = 0;
+        /** glBufferData and glBufferSubData with data, and mapped ranges. */
+        unsigned bufferUploads = 0;
+        size_t bufferBytes = 0;
+        unsigned textureUploads = 0;
+        size_t textureBytes = 0;
+
+        void add(const FrameStats& other);
+    };
+
+    /** Points the GLEW entry points at the recorder. Call it before the first GL call. */
+    static void install();
+
+    /** Closes the current frame, GLViewNull::swapBuffers() calls it. */
+    static void endFrame();
+
+    /** Forgets the frames recorded so far, e.g. the warm up ones. */
+    static void clearFrames();
+
+    /** The frame recorded since the last endFrame(). */
+    static const FrameStats& getCurrentFrame();
+
+    /** The frames closed by endFrame(). */
+    static const std::vector<FrameStats>& getFrames();
+
+    /** Writes the frames, their sum and their average as JSON. */
+    static bool writeJson(const std::string& path);
+};
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#endif // __CC_GL_RECORDER_LINUX_H__
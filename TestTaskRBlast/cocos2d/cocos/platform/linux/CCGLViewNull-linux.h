@@ -0,0 +1,65 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_GLVIEW_NULL_LINUX_H__
+#define __CC_GLVIEW_NULL_LINUX_H__
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include "platform/CCGLView.h"
+
+NS_CC_BEGIN
+
+/**
+ * A view without a window, which renders into GLRecorder.
+ *
+ * Director::mainLoop() runs on it as on a GLViewImpl, without a GPU or a display, and every
+ * swapBuffers() closes a frame of the recorder. Director::end() makes windowShouldClose() true.
+ * It comes with the cocos2d_nullgl library, which replaces the GL of the whole executable.
+ */
+class GLViewNull : public GLView
+{
+public:
+    static GLViewNull* create(const std::string& viewName, const Rect& rect = Rect(0, 0, 960, 640));
+
+    virtual void end() override;
+    virtual bool isOpenGLReady() override { return true; }
+    virtual void swapBuffers() override;
+    virtual void setIMEKeyboardState(bool /*open*/) override {}
+    virtual bool windowShouldClose() override { return _shouldClose; }
+
+protected:
+    GLViewNull();
+
+    bool initWithRect(const std::string& viewName, const Rect& rect);
+
+    bool _shouldClose;
+};
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#endif // __CC_GLVIEW_NULL_LINUX_H__
@@ -0,0 +1,366 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCDynamicAtlas.h"
+#include <algorithm>
+#include <cstring>
+#include "base/CCConfiguration.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventType.h"
+#include "platform/CCImage.h"
+#include "renderer/CCTexture2D.h"
+
+NS_CC_BEGIN
+
+// the border of edge pixels around every copy
+static const int BORDER = 1;
+
+static unsigned int s_atlasVersion = 0;
+
+DynamicAtlas::DynamicAtlas(int maxTextureSize, int maxPages)
+: _maxTextureSize(maxTextureSize)
+, _maxPages(std::max(maxPages, 1))
+, _pageSize(std::min(PAGE_SIZE, Configuration::getInstance()->getMaxTextureSize()))
+, _rendererRecreatedListener(nullptr)
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // listen the event that renderer was recreated on Android/WP8, the pages are gone
+    _rendererRecreatedListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(EVENT_RENDERER_RECREATED,
+        [this](EventCustom* /*event*/) { reloadPages(); });
+#endif
+}
+
+DynamicAtlas::~DynamicAtlas()
+{
+    if (_rendererRecreatedListener)
+    {
+        Director::getInstance()->getEventDispatcher()->removeEventListener(_rendererRecreatedListener);
+    }
+    for (auto page : _pages)
+    {
+        for (auto& entry : page->entries)
+        {
+            detach(entry.texture);
+        }
+        page->texture->release();
+        delete page;
+    }
+}
+
+unsigned int DynamicAtlas::getVersion()
+{
+    return s_atlasVersion;
+}
+
+Texture2D* DynamicAtlas::getPage(ssize_t index) const
+{
+    CCASSERT(index >= 0 && index < getPageCount(), "index out of range");
+    return _pages[index]->texture;
+}
+
+bool DynamicAtlas::add(Texture2D* texture, Image* image)
+{
+    int width = image->getWidth();
+    int height = image->getHeight();
+    auto format = image->getRenderFormat();
+    if (width > _maxTextureSize || height > _maxTextureSize || width + 2 * BORDER > _pageSize || height + 2 * BORDER > _pageSize
+        || image->isCompressed() || texture->getAlphaTexture() || texture->getPixelFormat() != format
+        || (format != Texture2D::PixelFormat::RGBA8888 && format != Texture2D::PixelFormat::RGB888))
+    {
+        return false;
+    }
+    remove(texture);
+
+    // the copy as RGBA, framed by its edge pixels
+    Entry entry;
+    entry.texture = texture;
+    entry.x = 0;
+    entry.y = 0;
+    entry.width = width + 2 * BORDER;
+    entry.height = height + 2 * BORDER;
+    entry.pixels.resize(entry.width * entry.height * 4);
+    const unsigned char* source = image->getData();
+    int sourceBytes = format == Texture2D::PixelFormat::RGBA8888 ? 4 : 3;
+    for (int y = 0; y < entry.height; ++y)
+    {
+        int sourceY = std::min(std::max(y - BORDER, 0), height - 1);
+        unsigned char* row = entry.pixels.data() + y * entry.width * 4;
+        for (int x = 0; x < entry.width; ++x)
+        {
+            int sourceX = std::min(std::max(x - BORDER, 0), width - 1);
+            const unsigned char* pixel = source + (sourceY * width + sourceX) * sourceBytes;
+            row[x * 4] = pixel[0];
+            row[x * 4 + 1] = pixel[1];
+            row[x * 4 + 2] = pixel[2];
+            row[x * 4 + 3] = sourceBytes == 4 ? pixel[3] : 0xff;
+        }
+    }
+
+    // a page with room, then a fragmented page repacked, then a new page, then a page without its unused textures
+    bool premultiplied = texture->hasPremultipliedAlpha();
+    int area = entry.width * entry.height;
+    for (auto page : _pages)
+    {
+        if (page->premultiplied == premultiplied && insert(*page, entry, _pageSize))
+            return place(*page, entry);
+    }
+    for (auto page : _pages)
+    {
+        if (page->premultiplied == premultiplied && page->packedArea - page->usedArea >= area)
+        {
+            repack(*page);
+            if (insert(*page, entry, _pageSize))
+                return place(*page, entry);
+        }
+    }
+    if (static_cast<int>(_pages.size()) < _maxPages)
+    {
+        auto page = createPage(premultiplied);
+        if (page && insert(*page, entry, _pageSize))
+            return place(*page, entry);
+    }
+    for (auto page : _pages)
+    {
+        if (page->premultiplied == premultiplied && evictUnused(*page))
+        {
+            repack(*page);
+            if (insert(*page, entry, _pageSize))
+                return place(*page, entry);
+        }
+    }
+    return false;
+}
+
+void DynamicAtlas::remove(Texture2D* texture)
+{
+    auto owner = _owners.find(texture);
+    if (owner == _owners.end())
+        return;
+
+    auto& page = *owner->second;
+    _owners.erase(owner);
+    auto entry = std::find_if(page.entries.begin(), page.entries.end(), [texture](const Entry& e) { return e.texture == texture; });
+    page.usedArea -= entry->width * entry->height;
+    page.entries.erase(entry);
+    detach(texture);
+
+    // an empty page starts over
+    if (page.entries.empty())
+    {
+        page.skyline.assign(1, { 0, 0, _pageSize });
+        page.packedArea = 0;
+    }
+}
+
+DynamicAtlas::Page* DynamicAtlas::createPage(bool premultiplied)
+{
+    auto texture = new (std::nothrow) Texture2D();
+    if (!texture)
+        return nullptr;
+    ssize_t bytes = static_cast<ssize_t>(_pageSize) * _pageSize * 4;
+    if (!texture->initWithData(nullptr, bytes, Texture2D::PixelFormat::RGBA8888, _pageSize, _pageSize, Size(_pageSize, _pageSize)))
+    {
+        texture->release();
+        return nullptr;
+    }
+    texture->_hasPremultipliedAlpha = premultiplied;
+
+    auto page = new (std::nothrow) Page();
+    page->texture = texture;
+    page->premultiplied = premultiplied;
+    page->skyline.assign(1, { 0, 0, _pageSize });
+    page->usedArea = 0;
+    page->packedArea = 0;
+    _pages.push_back(page);
+    return page;
+}
+
+bool DynamicAtlas::insert(Page& page, Entry& entry, int pageSize)
+{
+    // bottom left: the place whose top ends lowest, on the skyline segments it covers
+    auto& skyline = page.skyline;
+    int bestTop = pageSize + 1;
+    size_t bestIndex = 0;
+    int bestY = 0;
+    for (size_t i = 0; i < skyline.size(); ++i)
+    {
+        if (skyline[i].x + entry.width > pageSize)
+            break;
+        int y = 0;
+        int covered = 0;
+        for (size_t j = i; covered < entry.width; ++j)
+        {
+            y = std::max(y, skyline[j].y);
+            covered += skyline[j].width;
+        }
+        if (y + entry.height <= pageSize && y + entry.height < bestTop)
+        {
+            bestTop = y + entry.height;
+            bestIndex = i;
+            bestY = y;
+        }
+    }
+    if (bestTop > pageSize)
+        return false;
+
+    entry.x = skyline[bestIndex].x;
+    entry.y = bestY;
+
+    // the new segment replaces the ones under it, the last of those may stick out
+    SkylineNode node = { entry.x, bestTop, entry.width };
+    size_t end = bestIndex;
+    int right = entry.x + entry.width;
+    while (end < skyline.size() && skyline[end].x + skyline[end].width <= right)
+    {
+        ++end;
+    }
+    if (end < skyline.size() && skyline[end].x < right)
+    {
+        skyline[end].width -= right - skyline[end].x;
+        skyline[end].x = right;
+    }
+    skyline.erase(skyline.begin() + bestIndex, skyline.begin() + end);
+    skyline.insert(skyline.begin() + bestIndex, node);
+
+    // neighbours at the same height are one segment
+    for (size_t i = 0; i + 1 < skyline.size();)
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    page.packedArea += entry.width * entry.height;
+    return true;
+}
+
+bool DynamicAtlas::place(Page& page, Entry& entry)
+{
+    page.usedArea += entry.width * entry.height;
+    page.entries.push_back(std::move(entry));
+    auto& placed = page.entries.back();
+    _owners[placed.texture] = &page;
+    upload(page, placed);
+    attach(page, placed);
+    return true;
+}
+
+void DynamicAtlas::repack(Page& page)
+{
+    std::vector<Entry> entries;
+    entries.swap(page.entries);
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.height > b.height; });
+
+    page.skyline.assign(1, { 0, 0, _pageSize });
+    page.usedArea = 0;
+    page.packedArea = 0;
+    for (auto& entry : entries)
+    {
+        int x = entry.x;
+        int y = entry.y;
+        if (!insert(page, entry, _pageSize))
+        {
+            // the order can be worse than the one it was packed in
+            _owners.erase(entry.texture);
+            detach(entry.texture);
+            continue;
+        }
+        page.usedArea += entry.width * entry.height;
+        page.entries.push_back(std::move(entry));
+        if (x != page.entries.back().x || y != page.entries.back().y)
+        {
+            upload(page, page.entries.back());
+            attach(page, page.entries.back());
+        }
+    }
+}
+
+bool DynamicAtlas::evictUnused(Page& page)
+{
+    // only the cache holds them, they stay out of the atlas until the cache loads them again
+    size_t before = page.entries.size();
+    for (auto it = page.entries.begin(); it != page.entries.end();)
+    {
+        if (it->texture->getReferenceCount() == 1)
+        {
+            page.usedArea -= it->width * it->height;
+            _owners.erase(it->texture);
+            detach(it->texture);
+            it = page.entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return page.entries.size() != before;
+}
+
+void DynamicAtlas::upload(Page& page, const Entry& entry)
+{
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    page.texture->updateWithData(entry.pixels.data(), entry.x, entry.y, entry.width, entry.height);
+}
+
+void DynamicAtlas::attach(Page& page, const Entry& entry)
+{
+    auto texture = entry.texture;
+    texture->_dynamicAtlas = this;
+    texture->_atlasPage = page.texture;
+    texture->_atlasRect.setRect(entry.x + BORDER, entry.y + BORDER, entry.width - 2 * BORDER, entry.height - 2 * BORDER);
+    texture->_atlasVersion = ++s_atlasVersion;
+}
+
+void DynamicAtlas::detach(Texture2D* texture)
+{
+    texture->_dynamicAtlas = nullptr;
+    texture->_atlasPage = nullptr;
+    texture->_atlasRect = Rect::ZERO;
+    texture->_atlasVersion = ++s_atlasVersion;
+}
+
+void DynamicAtlas::reloadPages()
+{
+    // the textures stayed on their pages while VolatileTextureMgr reloaded them
+    ssize_t bytes = static_cast<ssize_t>(_pageSize) * _pageSize * 4;
+    for (auto page : _pages)
+    {
+        page->texture->initWithData(nullptr, bytes, Texture2D::PixelFormat::RGBA8888, _pageSize, _pageSize, Size(_pageSize, _pageSize));
+        page->texture->_hasPremultipliedAlpha = page->premultiplied;
+        for (auto& entry : page->entries)
+        {
+            upload(*page, entry);
+        }
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,148 @@
+/****************************************************************************
+ Copyright (c) 2020 Anton Kulikov
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCDYNAMIC_ATLAS_H__
+#define __CCDYNAMIC_ATLAS_H__
+
+#include <unordered_map>
+#include <vector>
+#include "base/ccTypes.h"
+
+NS_CC_BEGIN
+
+class EventListenerCustom;
+class Image;
+class Texture2D;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** Packs small textures into shared pages, so sprites with different textures batch into one draw call.
+ *
+ * TextureCache hands every texture it makes from an image to add(), see TextureCache::setDynamicAtlasEnabled().
+ * A packed texture keeps its own GL texture for everything else, and Texture2D::getAtlasPage() and
+ * Texture2D::getAtlasRect() tell where its copy in a page is. A Sprite in quad or slice 9 mode draws from
+ * the page. Each copy has a border of its edge pixels, so linear filtering does not bleed into the neighbours.
+ *
+ * The pages are filled by a skyline packer. The space of a texture that changes or goes away is only given back
+ * when its page is repacked, which happens when a texture doesn't fit and the page has enough of such space.
+ * When all pages are full, the textures only the cache holds are evicted from them. An evicted texture draws from
+ * its own GL texture until the cache loads it again, TextureCache::addImage() returns it from the cache as it is.
+ * A texture whose place changes gets a new Texture2D::getAtlasVersion(), the sprites drawing it update their
+ * texture coordinates and the StaticNode objects record their subtrees again.
+ */
+class CC_DLL DynamicAtlas
+{
+public:
+    /** The width and height of a page, less when GL supports less. */
+    static const int PAGE_SIZE = 2048;
+    static const int DEFAULT_MAX_TEXTURE_SIZE = 256;
+    static const int DEFAULT_MAX_PAGES = 4;
+
+    /**
+     * @param maxTextureSize Textures larger than this in either dimension are not packed.
+     * @param maxPages The number of pages the atlas makes at most.
+     */
+    DynamicAtlas(int maxTextureSize, int maxPages);
+    ~DynamicAtlas();
+
+    int getMaxTextureSize() const { return _maxTextureSize; }
+    int getMaxPages() const { return _maxPages; }
+
+    /** Packs texture, which was made from image, if it is small enough and has 8 bits per channel. */
+    bool add(Texture2D* texture, Image* image);
+
+    /** Takes texture out of its page. Texture2D calls it when the texture changes or is deleted. */
+    void remove(Texture2D* texture);
+
+    ssize_t getPageCount() const { return _pages.size(); }
+    Texture2D* getPage(ssize_t index) const;
+
+    /** The number of textures packed. */
+    ssize_t getTextureCount() const { return _owners.size(); }
+
+    /** Changes whenever a texture of any atlas gets or loses its place, the latest Texture2D::getAtlasVersion().
+     * The drawing baked from the texture coordinates of packed textures is out of date when it changes.
+     */
+    static unsigned int getVersion();
+
+protected:
+    struct SkylineNode
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    // the copy of a texture with its border, kept for repacking
+    struct Entry
+    {
+        Texture2D* texture;
+        int x;
+        int y;
+        int width;
+        int height;
+        std::vector<unsigned char> pixels;
+    };
+
+    struct Page
+    {
+        Texture2D* texture;
+        bool premultiplied;
+        std::vector<SkylineNode> skyline;
+        std::vector<Entry> entries;
+        // of the entries, and of all the space handed out since the last repack
+        int usedArea;
+        int packedArea;
+    };
+
+    Page* createPage(bool premultiplied);
+    static bool insert(Page& page, Entry& entry, int pageSize);
+    bool place(Page& page, Entry& entry);
+    void repack(Page& page);
+    bool evictUnused(Page& page);
+    void upload(Page& page, const Entry& entry);
+    void attach(Page& page, const Entry& entry);
+    static void detach(Texture2D* texture);
+    void reloadPages();
+
+    int _maxTextureSize;
+    int _maxPages;
+    int _pageSize;
+    std::vector<Page*> _pages;
+    std::unordered_map<Texture2D*, Page*> _owners;
+    EventListenerCustom* _rendererRecreatedListener;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(DynamicAtlas);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCDYNAMIC_ATLAS_H__
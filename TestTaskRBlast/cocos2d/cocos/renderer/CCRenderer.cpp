@@ -39,6 +39,7 @@
 #include "renderer/CCPass.h"
 #include "renderer/CCRenderState.h"
 #include "renderer/ccGLStateCache.h"
+#include "math/MathUtil.h"
 
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
@@ -47,18 +48,53 @@
 #include "base/CCEventType.h"
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
+#include "2d/CCParallelVisit.h"
+#include "base/CCTrace.h"
 
 NS_CC_BEGIN
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+// LSD radix sort of the high 32 bits, stable, so keys with the same high half keep their order
+static void radixSortHighHalf(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
-}
+    const size_t count = keys.size();
+    scratch.resize(count);
 
-static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
-{
-    return  a->getDepth() > b->getDepth();
+    size_t histograms[4][256] = {};
+    for (auto key : keys)
+    {
+        for (int digit = 0; digit < 4; ++digit)
+        {
+            ++histograms[digit][(key >> (32 + digit * 8)) & 0xff];
+        }
+    }
+
+    uint64_t* src = keys.data();
+    uint64_t* dst = scratch.data();
+    for (int digit = 0; digit < 4; ++digit)
+    {
+        const int shift = 32 + digit * 8;
+        auto& histogram = histograms[digit];
+        // every key has the same digit, e.g. the sign and exponent byte of similar globalZ values
+        if (histogram[(src[0] >> shift) & 0xff] == count)
+            continue;
+
+        size_t offset = 0;
+        for (auto& bucket : histogram)
+        {
+            size_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            dst[histogram[(src[i] >> shift) & 0xff]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != keys.data())
+        keys.swap(scratch);
 }
 
 // queue
@@ -72,11 +108,11 @@ void RenderQueue::push_back(RenderCommand* command)
     float z = command->getGlobalOrder();
     if(z < 0)
     {
-        _commands[QUEUE_GROUP::GLOBALZ_NEG].push_back(command);
+        pushSorted(QUEUE_GROUP::GLOBALZ_NEG, command, sortBits(z));
     }
     else if(z > 0)
     {
-        _commands[QUEUE_GROUP::GLOBALZ_POS].push_back(command);
+        pushSorted(QUEUE_GROUP::GLOBALZ_POS, command, sortBits(z));
     }
     else
     {
@@ -84,7 +120,8 @@ void RenderQueue::push_back(RenderCommand* command)
         {
             if(command->isTransparent())
             {
-                _commands[QUEUE_GROUP::TRANSPARENT_3D].push_back(command);
+                // far to near
+                pushSorted(QUEUE_GROUP::TRANSPARENT_3D, command, ~sortBits(command->getDepth()));
             }
             else
             {
@@ -111,10 +148,195 @@ ssize_t RenderQueue::size() const
 
 void RenderQueue::sort()
 {
+    CC_TRACE_SCOPE("RenderQueue::sort");
     // Don't sort _queue0, it already comes sorted
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    sortSubQueue(QUEUE_GROUP::TRANSPARENT_3D);
+    sortSubQueue(QUEUE_GROUP::GLOBALZ_NEG);
+    sortSubQueue(QUEUE_GROUP::GLOBALZ_POS);
+}
+
+uint32_t RenderQueue::sortBits(float value)
+{
+    // +0 for -0 as well, they are equal for the comparison the order is defined by
+    if (value == 0)
+        value = 0;
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    // negative floats compare reversed: flip all their bits, and the sign bit of the positive ones
+    return bits & 0x80000000 ? ~bits : bits | 0x80000000;
+}
+
+void RenderQueue::pushSorted(QUEUE_GROUP group, RenderCommand* command, uint32_t sortValue)
+{
+    auto& commands = _commands[group];
+    _sortKeys[group].push_back(static_cast<uint64_t>(sortValue) << 32 | static_cast<uint32_t>(commands.size()));
+    commands.push_back(command);
+}
+
+void RenderQueue::sortSubQueue(QUEUE_GROUP group)
+{
+    auto& commands = _commands[group];
+    auto& keys = _sortKeys[group];
+    const size_t count = keys.size();
+    CCASSERT(count == commands.size(), "Commands must be added with push_back");
+    if (count < 2)
+        return;
+
+    // the sequence makes every key unique, so std::sort is as stable as the radix sort
+    if (count < RADIX_SORT_MIN_COMMANDS)
+        std::sort(keys.begin(), keys.end());
+    else
+        radixSortHighHalf(keys, _sortScratch);
+
+    _commandScratch.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        _commandScratch[i] = commands[static_cast<uint32_t>(keys[i])];
+        // the sequence follows the new order, so the keys still describe the group
+        keys[i] = (keys[i] & 0xffffffff00000000ull) | i;
+    }
+    commands.swap(_commandScratch);
+}
+
+ssize_t RenderQueue::reorderForBatching()
+{
+    CC_TRACE_SCOPE("RenderQueue::reorderForBatching");
+    // the 3D groups are ordered by depth, their commands are not batched this way
+    return reorderSubQueue(_commands[QUEUE_GROUP::GLOBALZ_NEG])
+        + reorderSubQueue(_commands[QUEUE_GROUP::GLOBALZ_ZERO])
+        + reorderSubQueue(_commands[QUEUE_GROUP::GLOBALZ_POS]);
+}
+
+ssize_t RenderQueue::reorderSubQueue(std::vector<RenderCommand*>& commands)
+{
+    if (commands.size() < 3)
+        return 0;
+
+    const ssize_t batchesBefore = countBatches(commands);
+    if (_bounds.size() < commands.size())
+        _bounds.resize(commands.size());
+
+    // commands[0, placed) is the new order, a command is inserted after the last one it can join
+    size_t placed = 0;
+    for (size_t i = 0, size = commands.size(); i < size; ++i)
+    {
+        RenderCommand* command = commands[i];
+        const CommandBounds bounds = computeBounds(command);
+        size_t target = placed;
+        if (bounds.flat && !static_cast<TrianglesCommand*>(command)->isSkipBatching())
+        {
+            const auto materialID = static_cast<TrianglesCommand*>(command)->getMaterialID();
+            const size_t first = placed > BATCH_REORDER_WINDOW ? placed - BATCH_REORDER_WINDOW : 0;
+            for (size_t j = placed; j > first; --j)
+            {
+                RenderCommand* other = commands[j - 1];
+                if (other->getType() == RenderCommand::Type::TRIANGLES_COMMAND
+                    && !static_cast<TrianglesCommand*>(other)->isSkipBatching()
+                    && static_cast<TrianglesCommand*>(other)->getMaterialID() == materialID)
+                {
+                    target = j;
+                    break;
+                }
+                // other commands have no bounds, nothing jumps over them
+                if (bounds.overlaps(_bounds[j - 1]))
+                    break;
+            }
+        }
+
+        std::copy_backward(commands.begin() + target, commands.begin() + placed, commands.begin() + placed + 1);
+        std::copy_backward(_bounds.begin() + target, _bounds.begin() + placed, _bounds.begin() + placed + 1);
+        commands[target] = command;
+        _bounds[target] = bounds;
+        ++placed;
+    }
+
+    return batchesBefore - countBatches(commands);
+}
+
+RenderQueue::CommandBounds RenderQueue::computeBounds(RenderCommand* command)
+{
+    CommandBounds bounds = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, false };
+    if (command->getType() != RenderCommand::Type::TRIANGLES_COMMAND)
+        return bounds;
+
+    auto cmd = static_cast<TrianglesCommand*>(command);
+    const float* m = cmd->getModelView().m;
+    // only affine transforms that keep the xy plane parallel to the screen
+    if (cmd->getVertexCount() == 0 || m[2] != 0.0f || m[6] != 0.0f
+        || m[3] != 0.0f || m[7] != 0.0f || m[11] != 0.0f || m[15] != 1.0f)
+        return bounds;
+
+    const V3F_C4B_T2F* verts = cmd->getVertices();
+    const float z = verts[0].vertices.z;
+    float minX = verts[0].vertices.x;
+    float minY = verts[0].vertices.y;
+    float maxX = minX;
+    float maxY = minY;
+    for (ssize_t i = 1, count = cmd->getVertexCount(); i < count; ++i)
+    {
+        const Vec3& v = verts[i].vertices;
+        if (v.z != z)
+            return bounds;
+        minX = std::min(minX, v.x);
+        maxX = std::max(maxX, v.x);
+        minY = std::min(minY, v.y);
+        maxY = std::max(maxY, v.y);
+    }
+
+    // the view space box of the four corners of the local box
+    const float corners[4][2] = { { minX, minY }, { maxX, minY }, { minX, maxY }, { maxX, maxY } };
+    for (int i = 0; i < 4; ++i)
+    {
+        const float x = m[0] * corners[i][0] + m[4] * corners[i][1] + m[8] * z + m[12];
+        const float y = m[1] * corners[i][0] + m[5] * corners[i][1] + m[9] * z + m[13];
+        if (i == 0)
+        {
+            bounds.minX = bounds.maxX = x;
+            bounds.minY = bounds.maxY = y;
+        }
+        else
+        {
+            bounds.minX = std::min(bounds.minX, x);
+            bounds.maxX = std::max(bounds.maxX, x);
+            bounds.minY = std::min(bounds.minY, y);
+            bounds.maxY = std::max(bounds.maxY, y);
+        }
+    }
+    bounds.z = m[10] * z + m[14];
+    bounds.flat = true;
+    return bounds;
+}
+
+bool RenderQueue::CommandBounds::overlaps(const CommandBounds& other) const
+{
+    // in different planes a perspective projection may still overlap them on screen
+    if (!flat || !other.flat || z != other.z)
+        return true;
+    // touching counts, both may rasterize the shared edge
+    return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+}
+
+ssize_t RenderQueue::countBatches(const std::vector<RenderCommand*>& commands)
+{
+    // the rule of Renderer::drawBatchedTriangles(), any other command ends the batch
+    ssize_t batches = 0;
+    const TrianglesCommand* previous = nullptr;
+    for (auto command : commands)
+    {
+        if (command->getType() != RenderCommand::Type::TRIANGLES_COMMAND)
+        {
+            previous = nullptr;
+            continue;
+        }
+        auto cmd = static_cast<const TrianglesCommand*>(command);
+        if (!previous || cmd->isSkipBatching() || previous->isSkipBatching()
+            || previous->getMaterialID() != cmd->getMaterialID())
+        {
+            ++batches;
+        }
+        previous = cmd;
+    }
+    return batches;
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -138,6 +360,7 @@ void RenderQueue::clear()
     for(int i = 0; i < QUEUE_COUNT; ++i)
     {
         _commands[i].clear();
+        _sortKeys[i].clear();
     }
 }
 
@@ -147,6 +370,7 @@ void RenderQueue::realloc(size_t reserveSize)
     {
         _commands[i] = std::vector<RenderCommand*>();
         _commands[i].reserve(reserveSize);
+        _sortKeys[i] = std::vector<uint64_t>();
     }
 }
 
@@ -199,13 +423,26 @@ static const int DEFAULT_RENDER_QUEUE = 0;
 //
 Renderer::Renderer()
 :_lastBatchedMeshCommand(nullptr)
+#if CC_RENDERER_STREAM_BUFFER
+,_streamMode(StreamMode::NONE)
+,_streamMapped(nullptr)
+,_streamHead(0)
+,_streamBlock(0)
+,_streamBlockSize(0)
+,_streamVertexBytes(0)
+,_streamStaged(false)
+,_streamFenceFirst(0)
+,_streamFenceCount(0)
+#endif
 ,_triBatchesToDrawCapacity(-1)
 ,_triBatchesToDraw(nullptr)
 ,_filledVertex(0)
 ,_filledIndex(0)
 ,_glViewAssigned(false)
+,_batchesSavedByReordering(0)
 ,_isRendering(false)
 ,_isDepthTestFor2D(false)
+,_batchReordering(false)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
@@ -231,6 +468,9 @@ Renderer::~Renderer()
     _renderGroups.clear();
     _groupCommandManager->release();
     
+#if CC_RENDERER_STREAM_BUFFER
+    deleteStreamBuffer();
+#endif
     glDeleteBuffers(2, _buffersVBO);
 
     free(_triBatchesToDraw);
@@ -263,6 +503,14 @@ void Renderer::initGLView()
 
 void Renderer::setupBuffer()
 {
+#if CC_RENDERER_STREAM_BUFFER
+    auto conf = Configuration::getInstance();
+    if (conf->supportsShareableVAO() && conf->supportsMapBufferRange())
+    {
+        setupStreamBuffer();
+        return;
+    }
+#endif
     if(Configuration::getInstance()->supportsShareableVAO())
     {
         setupVBOAndVAO();
@@ -346,8 +594,170 @@ void Renderer::mapBuffers()
     CHECK_GL_ERROR_DEBUG();
 }
 
+#if CC_RENDERER_STREAM_BUFFER
+void Renderer::setupStreamBuffer()
+{
+    deleteStreamBuffer();
+
+    glGenVertexArrays(1, &_buffersVAO);
+    GL::bindVAO(_buffersVAO);
+
+    // vertices and indices of a batch share one block of the ring
+    glGenBuffers(1, &_buffersVBO[0]);
+    _buffersVBO[1] = 0;
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[0]);
+
+    _streamMode = StreamMode::MAP_RANGE;
+    if (Configuration::getInstance()->supportsBufferStorage())
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, STREAM_BUFFER_SIZE, nullptr, flags);
+        _streamMapped = (char*) glMapBufferRange(GL_ARRAY_BUFFER, 0, STREAM_BUFFER_SIZE, flags);
+        if (_streamMapped)
+        {
+            _streamMode = StreamMode::PERSISTENT;
+        }
+        else
+        {
+            // the storage is immutable, start over with a mutable buffer
+            GL::bindVAO(0);
+            glDeleteBuffers(1, &_buffersVBO[0]);
+            glGenBuffers(1, &_buffersVBO[0]);
+            GL::bindVAO(_buffersVAO);
+            glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[0]);
+        }
+    }
+    if (_streamMode == StreamMode::MAP_RANGE)
+    {
+        glBufferData(GL_ARRAY_BUFFER, STREAM_BUFFER_SIZE, nullptr, GL_STREAM_DRAW);
+    }
+
+    // the pointers are set per block in bindStreamBlock()
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
+
+    GL::bindVAO(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void Renderer::deleteStreamBuffer()
+{
+    for (; _streamFenceCount > 0; --_streamFenceCount)
+    {
+        glDeleteSync(_streamFences[_streamFenceFirst].sync);
+        _streamFenceFirst = (_streamFenceFirst + 1) % STREAM_FENCES;
+    }
+    if (_streamMode == StreamMode::NONE)
+        return;
+
+    // deleting the buffer unmaps it
+    GL::bindVAO(0);
+    glDeleteBuffers(1, &_buffersVBO[0]);
+    glDeleteVertexArrays(1, &_buffersVAO);
+    _buffersVBO[0] = 0;
+    _buffersVAO = 0;
+    _streamMode = StreamMode::NONE;
+    _streamMapped = nullptr;
+    _streamHead = 0;
+}
+
+char* Renderer::beginStreamBlock(GLsizeiptr vertexBytes, GLsizeiptr indexBytes)
+{
+    GLsizeiptr size = (vertexBytes + indexBytes + STREAM_ALIGNMENT - 1) & ~(STREAM_ALIGNMENT - 1);
+    if (size == 0)
+        size = STREAM_ALIGNMENT;
+    if (_streamHead + size > STREAM_BUFFER_SIZE)
+        _streamHead = 0;
+
+    // blocks are handed out in ring order, so the oldest one is the first in the way
+    while (_streamFenceCount > 0)
+    {
+        const auto& fence = _streamFences[_streamFenceFirst];
+        if (_streamFenceCount < STREAM_FENCES && (fence.end <= _streamHead || fence.begin >= _streamHead + size))
+            break;
+        waitStreamFence();
+    }
+
+    _streamBlock = _streamHead;
+    _streamBlockSize = size;
+    _streamVertexBytes = vertexBytes;
+    _streamStaged = false;
+
+    if (_streamMode == StreamMode::PERSISTENT)
+        return _streamMapped + _streamBlock;
+
+    // the fences already keep the GPU off this range
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    auto block = (char*) glMapBufferRange(GL_ARRAY_BUFFER, _streamBlock, _streamBlockSize,
+                                          GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    _streamStaged = block == nullptr;
+    return block;
+}
+
+void Renderer::bindStreamBlock()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    if (_streamStaged)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, _streamBlock, _streamVertexBytes, _verts);
+        glBufferSubData(GL_ARRAY_BUFFER, _streamBlock + _streamVertexBytes, sizeof(_indices[0]) * _filledIndex, _indices);
+    }
+    else if (_streamMode == StreamMode::MAP_RANGE)
+    {
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    GL::bindVAO(_buffersVAO);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (_streamBlock + offsetof(V3F_C4B_T2F, vertices)));
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) (_streamBlock + offsetof(V3F_C4B_T2F, colors)));
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (_streamBlock + offsetof(V3F_C4B_T2F, texCoords)));
+}
+
+void Renderer::endStreamBlock()
+{
+    if (_streamFenceCount == STREAM_FENCES)
+        waitStreamFence();
+
+    auto& fence = _streamFences[(_streamFenceFirst + _streamFenceCount) % STREAM_FENCES];
+    fence.sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    fence.begin = _streamBlock;
+    fence.end = _streamBlock + _streamBlockSize;
+    ++_streamFenceCount;
+    _streamHead = fence.end;
+
+    GL::bindVAO(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Renderer::waitStreamFence()
+{
+    auto& fence = _streamFences[_streamFenceFirst];
+    GLenum result;
+    do
+    {
+        result = glClientWaitSync(fence.sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    } while (result == GL_TIMEOUT_EXPIRED);
+    glDeleteSync(fence.sync);
+    _streamFenceFirst = (_streamFenceFirst + 1) % STREAM_FENCES;
+    --_streamFenceCount;
+}
+#endif
+
 void Renderer::addCommand(RenderCommand* command)
 {
+    // a job of the parallel visit keeps the commands, the main thread adds them in order
+    if (auto commandList = ParallelVisit::getCommandList())
+    {
+        commandList->push_back({ command, nullptr, nullptr, 0 });
+        return;
+    }
+
     int renderQueueID =_commandGroupStack.top();
     addCommand(command, renderQueueID);
 }
@@ -634,6 +1044,8 @@ void Renderer::render()
     //Uncomment this once everything is rendered by new renderer
     //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    CC_TRACE_SCOPE("Renderer::render");
+
     //TODO: setup camera or MVP
     _isRendering = true;
     
@@ -644,6 +1056,10 @@ void Renderer::render()
         for (auto &renderqueue : _renderGroups)
         {
             renderqueue.sort();
+            if (_batchReordering)
+            {
+                _batchesSavedByReordering += renderqueue.reorderForBatching();
+            }
         }
         visitRenderQueue(_renderGroups[0]);
     }
@@ -706,23 +1122,15 @@ void Renderer::setDepthTest(bool enable)
     CHECK_GL_ERROR_DEBUG();
 }
 
-void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
+void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd, V3F_C4B_T2F* verts, GLushort* indices)
 {
-    memcpy(&_verts[_filledVertex], cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
-
-    // fill vertex, and convert them to world coordinates
-    const Mat4& modelView = cmd->getModelView();
-    for(ssize_t i=0; i < cmd->getVertexCount(); ++i)
-    {
-        modelView.transformPoint(&(_verts[i + _filledVertex].vertices));
-    }
+    // fill vertex, and convert them to world coordinates, the whole run at once
+    MathUtil::transformVertices(cmd->getModelView().m, cmd->getVertices(), &verts[_filledVertex],
+                                cmd->getVertexCount(), sizeof(V3F_C4B_T2F));
 
     // fill index
-    const unsigned short* indices = cmd->getIndices();
-    for(ssize_t i=0; i< cmd->getIndexCount(); ++i)
-    {
-        _indices[_filledIndex + i] = _filledVertex + indices[i];
-    }
+    MathUtil::offsetIndices(cmd->getIndices(), &indices[_filledIndex],
+                            cmd->getIndexCount(), static_cast<unsigned short>(_filledVertex));
 
     _filledVertex += cmd->getVertexCount();
     _filledIndex += cmd->getIndexCount();
@@ -733,8 +1141,25 @@ void Renderer::drawBatchedTriangles()
     if(_queuedTriangleCommands.empty())
         return;
 
+    CC_TRACE_SCOPE("Renderer::drawBatchedTriangles");
     CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_BATCH_TRIANGLES");
 
+    // processRenderCommand() counted what the queued commands need
+    V3F_C4B_T2F* verts = _verts;
+    GLushort* indices = _indices;
+#if CC_RENDERER_STREAM_BUFFER
+    const bool streaming = _streamMode != StreamMode::NONE;
+    if (streaming)
+    {
+        const GLsizeiptr vertexBytes = sizeof(_verts[0]) * _filledVertex;
+        if (auto block = beginStreamBlock(vertexBytes, sizeof(_indices[0]) * _filledIndex))
+        {
+            verts = (V3F_C4B_T2F*) block;
+            indices = (GLushort*) (block + vertexBytes);
+        }
+    }
+#endif
+
     _filledVertex = 0;
     _filledIndex = 0;
 
@@ -753,7 +1178,7 @@ void Renderer::drawBatchedTriangles()
         auto currentMaterialID = cmd->getMaterialID();
         const bool batchable = !cmd->isSkipBatching();
 
-        fillVerticesAndIndices(cmd);
+        fillVerticesAndIndices(cmd, verts, indices);
 
         // in the same batch ?
         if (batchable && (prevMaterialID == currentMaterialID || firstCommand))
@@ -791,6 +1216,17 @@ void Renderer::drawBatchedTriangles()
 
     /************** 2: Copy vertices/indices to GL objects *************/
     auto conf = Configuration::getInstance();
+    // byte offset of the indices in the element buffer
+    GLintptr indexOffset = 0;
+#if CC_RENDERER_STREAM_BUFFER
+    if (streaming)
+    {
+        // already written, only the unmap is left
+        bindStreamBlock();
+        indexOffset = _streamBlock + _streamVertexBytes;
+    }
+    else
+#endif
     if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
     {
         //Bind VAO
@@ -846,12 +1282,19 @@ void Renderer::drawBatchedTriangles()
     {
         CC_ASSERT(_triBatchesToDraw[i].cmd && "Invalid batch");
         _triBatchesToDraw[i].cmd->useMaterial();
-        glDrawElements(GL_TRIANGLES, (GLsizei) _triBatchesToDraw[i].indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (_triBatchesToDraw[i].offset*sizeof(_indices[0])) );
+        glDrawElements(GL_TRIANGLES, (GLsizei) _triBatchesToDraw[i].indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (indexOffset + _triBatchesToDraw[i].offset*sizeof(_indices[0])) );
         _drawnBatches++;
         _drawnVertices += _triBatchesToDraw[i].indicesToDraw;
     }
 
     /************** 4: Cleanup *************/
+#if CC_RENDERER_STREAM_BUFFER
+    if (streaming)
+    {
+        endStreamBlock();
+    }
+    else
+#endif
     if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
     {
         //Unbind VAO
@@ -897,6 +1340,11 @@ void Renderer::flushTriangles()
 
 // helpers
 bool Renderer::checkVisibility(const Mat4 &transform, const Size &size)
+{
+    return checkVisibility(transform, Rect(Vec2::ZERO, size));
+}
+
+bool Renderer::checkVisibility(const Mat4 &transform, const Rect &rect)
 {
     auto director = Director::getInstance();
     auto scene = director->getRunningScene();
@@ -909,9 +1357,9 @@ bool Renderer::checkVisibility(const Mat4 &transform, const Size &size)
     Rect visibleRect(director->getVisibleOrigin(), director->getVisibleSize());
     
     // transform center point to screen space
-    float hSizeX = size.width/2;
-    float hSizeY = size.height/2;
-    Vec3 v3p(hSizeX, hSizeY, 0);
+    float hSizeX = rect.size.width/2;
+    float hSizeY = rect.size.height/2;
+    Vec3 v3p(rect.origin.x + hSizeX, rect.origin.y + hSizeY, 0);
     transform.transformPoint(&v3p);
     Vec2 v2p = Camera::getVisitingCamera()->projectGL(v3p);
 
@@ -31,6 +31,7 @@
 #include <stack>
 
 #include "platform/CCPlatformMacros.h"
+#include "base/ccConfig.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCGLProgram.h"
 #include "platform/CCGL.h"
@@ -88,6 +89,12 @@ public:
         QUEUE_COUNT = 5,
     };
 
+    /**From how many commands a group is sorted with a radix sort instead of std::sort.*/
+    static const size_t RADIX_SORT_MIN_COMMANDS = 256;
+
+    /**How many commands back reorderForBatching() looks for a command with the same material.*/
+    static const size_t BATCH_REORDER_WINDOW = 64;
+
 public:
     /**Constructor.*/
     RenderQueue();
@@ -97,6 +104,13 @@ public:
     ssize_t size() const;
     /**Sort the render commands.*/
     void sort();
+    /**
+    Moves TrianglesCommands of the 2D groups back to an earlier command with the same material,
+    so they are drawn in one batch. A command only jumps over commands whose bounds it does not overlap,
+    and never over other command types, so the frame looks the same.
+    @return The number of batches saved.
+    */
+    ssize_t reorderForBatching();
     /**Treat sorted commands as an array, access them one by one.*/
     RenderCommand* operator[](ssize_t index) const;
     /**Clear all rendered commands.*/
@@ -114,8 +128,43 @@ public:
     void restoreRenderState();
     
 protected:
+    /**Bounds of a TrianglesCommand in view space.*/
+    struct CommandBounds
+    {
+        float minX;
+        float minY;
+        float maxX;
+        float maxY;
+        float z;
+        /**All vertices lie in the plane at z, otherwise the bounds are unknown.*/
+        bool flat;
+
+        bool overlaps(const CommandBounds& other) const;
+    };
+
+    /**Bits of value that compare as unsigned integers like the floats do, with -0 equal to 0.*/
+    static uint32_t sortBits(float value);
+    /**
+    Adds a command to a sorted group with the key sort() orders it by:
+    sortValue in the high 32 bits, the insertion sequence in the low 32 bits.
+    */
+    void pushSorted(QUEUE_GROUP group, RenderCommand* command, uint32_t sortValue);
+    /**Sorts a group by its keys, the sequence keeps commands with equal sort values in insertion order.*/
+    void sortSubQueue(QUEUE_GROUP group);
+
+    static CommandBounds computeBounds(RenderCommand* command);
+    static ssize_t countBatches(const std::vector<RenderCommand*>& commands);
+    ssize_t reorderSubQueue(std::vector<RenderCommand*>& commands);
+
     /**The commands in the render queue.*/
     std::vector<RenderCommand*> _commands[QUEUE_COUNT];
+    /**The sort keys of the groups sort() orders, one per command.*/
+    std::vector<uint64_t> _sortKeys[QUEUE_COUNT];
+    /**Scratch buffers of sortSubQueue().*/
+    std::vector<uint64_t> _sortScratch;
+    std::vector<RenderCommand*> _commandScratch;
+    /**Bounds of the commands reorderForBatching() already placed.*/
+    std::vector<CommandBounds> _bounds;
     
     /**Cull state.*/
     bool _isCullEnabled;
@@ -172,6 +221,9 @@ public:
     /** Creates a render queue and returns its Id */
     int createRenderQueue();
 
+    /** Returns the render queue with the given Id, e.g. to read back the commands pushed into a group */
+    RenderQueue& getRenderQueue(int renderQueueID) { return _renderGroups[renderQueueID]; }
+
     /** Renders into the GLView all the queued `RenderCommand` objects */
     void render();
 
@@ -193,8 +245,17 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) TrianglesCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns how many batches the reordering saved in the last frame, getDrawnBatches() + this is the count without it */
+    ssize_t getBatchesSavedByReordering() const { return _batchesSavedByReordering; }
     /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    void clearDrawStats() { _drawnBatches = _drawnVertices = _batchesSavedByReordering = 0; }
+
+    /**
+     * Enable/Disable the reordering of TrianglesCommands into fewer batches, see RenderQueue::reorderForBatching().
+     * Disabled by default.
+     */
+    void setBatchReorderingEnabled(bool enabled) { _batchReordering = enabled; }
+    bool isBatchReorderingEnabled() const { return _batchReordering; }
 
     /**
      * Enable/Disable depth test
@@ -208,6 +269,8 @@ public:
 
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size);
+    /** returns whether or not a rectangle at any origin is visible or not */
+    bool checkVisibility(const Mat4& transform, const Rect& rect);
 
 protected:
 
@@ -218,6 +281,17 @@ protected:
     void mapBuffers();
     void drawBatchedTriangles();
 
+#if CC_RENDERER_STREAM_BUFFER
+    //Ring buffer for the batched triangles, used instead of _verts and _indices when the driver allows
+    void setupStreamBuffer();
+    void deleteStreamBuffer();
+    //Returns where to write the next batch, nullptr to fill _verts and _indices instead
+    char* beginStreamBlock(GLsizeiptr vertexBytes, GLsizeiptr indexBytes);
+    void bindStreamBlock();
+    void endStreamBlock();
+    void waitStreamFence();
+#endif
+
     //Draw the previews queued triangles and flush previous context
     void flush();
     
@@ -230,7 +304,7 @@ protected:
     void processRenderCommand(RenderCommand* command);
     void visitRenderQueue(RenderQueue& queue);
 
-    void fillVerticesAndIndices(const TrianglesCommand* cmd);
+    void fillVerticesAndIndices(const TrianglesCommand* cmd, V3F_C4B_T2F* verts, GLushort* indices);
 
 
     /* clear color set outside be used in setGLDefaultValues() */
@@ -247,7 +321,39 @@ protected:
     V3F_C4B_T2F _verts[VBO_SIZE];
     GLushort _indices[INDEX_VBO_SIZE];
     GLuint _buffersVAO;
-    GLuint _buffersVBO[2]; //0: vertex  1: indices
+    GLuint _buffersVBO[2]; //0: vertex  1: indices, 0: ring and 1: unused when streaming
+
+#if CC_RENDERER_STREAM_BUFFER
+    enum class StreamMode
+    {
+        NONE,
+        MAP_RANGE,  // every block is mapped unsynchronized, GL_ARB_map_buffer_range
+        PERSISTENT  // the ring stays mapped, GL_ARB_buffer_storage
+    };
+    // a block of the ring the GPU may still read
+    struct StreamFence
+    {
+        GLsync sync;
+        GLintptr begin;
+        GLintptr end;
+    };
+    // room for three full batches, so a flush seldom waits for the GPU
+    static const GLsizeiptr STREAM_BUFFER_SIZE = 3 * (VBO_SIZE * sizeof(V3F_C4B_T2F) + INDEX_VBO_SIZE * sizeof(GLushort));
+    static const GLsizeiptr STREAM_ALIGNMENT = 16;
+    static const int STREAM_FENCES = 64;
+
+    StreamMode _streamMode;
+    char* _streamMapped;
+    GLintptr _streamHead;
+    GLintptr _streamBlock;
+    GLsizeiptr _streamBlockSize;
+    GLsizeiptr _streamVertexBytes;
+    // the block is filled in _verts and _indices when it can't be mapped
+    bool _streamStaged;
+    StreamFence _streamFences[STREAM_FENCES];
+    int _streamFenceFirst;
+    int _streamFenceCount;
+#endif
 
     // Internal structure that has the information for the batches
     struct TriBatchToDraw {
@@ -268,10 +374,13 @@ protected:
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    ssize_t _batchesSavedByReordering;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
     
     bool _isDepthTestFor2D;
+
+    bool _batchReordering;
     
     GroupCommandManager* _groupCommandManager;
     
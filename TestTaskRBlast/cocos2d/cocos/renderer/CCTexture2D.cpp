@@ -48,6 +48,8 @@ THE SOFTWARE.
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCGLProgramCache.h"
 #include "base/CCNinePatchImageParser.h"
+#include "renderer/CCDynamicAtlas.h"
+#include "base/CCTrace.h"
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     #include "renderer/CCTextureCache.h"
@@ -447,6 +449,9 @@ Texture2D::Texture2D()
 , _ninePatchInfo(nullptr)
 , _valid(true)
 , _alphaTexture(nullptr)
+, _dynamicAtlas(nullptr)
+, _atlasPage(nullptr)
+, _atlasVersion(0)
 {
 }
 
@@ -455,6 +460,7 @@ Texture2D::~Texture2D()
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     VolatileTextureMgr::removeTexture(this);
 #endif
+    leaveDynamicAtlas();
     CC_SAFE_RELEASE_NULL(_alphaTexture); // ETC1 ALPHA support.
 
     CCLOGINFO("deallocing Texture2D: %p - id=%u", this, _name);
@@ -567,6 +573,7 @@ bool Texture2D::initWithData(const void *data, ssize_t dataLen, Texture2D::Pixel
 
 bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat pixelFormat, int pixelsWide, int pixelsHigh)
 {
+    CC_TRACE_SCOPE("Texture2D::initWithMipmaps");
 
 
     //the pixelFormat must be a certain value 
@@ -707,6 +714,7 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
     _maxT = 1;
 
     _hasPremultipliedAlpha = false;
+    leaveDynamicAtlas();
     _hasMipmaps = mipmapsNum > 1;
 
     // shader
@@ -716,8 +724,10 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
 
 bool Texture2D::updateWithData(const void *data,int offsetX,int offsetY,int width,int height)
 {
+    CC_TRACE_SCOPE("Texture2D::updateWithData");
     if (_name)
     {
+        leaveDynamicAtlas();
         GL::bindTexture2D(_name);
         const PixelFormatInfo& info = _pixelFormatInfoTables.at(_pixelFormat);
         glTexSubImage2D(GL_TEXTURE_2D,0,offsetX,offsetY,width,height,info.format, info.type,data);
@@ -1241,6 +1251,7 @@ void Texture2D::PVRImagesHavePremultipliedAlpha(bool haveAlphaPremultiplied)
 void Texture2D::generateMipmap()
 {
     CCASSERT(_pixelsWide == ccNextPOT(_pixelsWide) && _pixelsHigh == ccNextPOT(_pixelsHigh), "Mipmap texture only works in POT textures");
+    leaveDynamicAtlas();
     GL::bindTexture2D( _name );
     glGenerateMipmap(GL_TEXTURE_2D);
     _hasMipmaps = true;
@@ -1260,6 +1271,13 @@ void Texture2D::setTexParameters(const TexParams &texParams)
         (_pixelsHigh == ccNextPOT(_pixelsHigh) || texParams.wrapT == GL_CLAMP_TO_EDGE),
         "GL_CLAMP_TO_EDGE should be used in NPOT dimensions");
 
+    // the atlas pages are linear and clamped
+    if (texParams.minFilter != GL_LINEAR || texParams.magFilter != GL_LINEAR
+        || texParams.wrapS != GL_CLAMP_TO_EDGE || texParams.wrapT != GL_CLAMP_TO_EDGE)
+    {
+        leaveDynamicAtlas();
+    }
+
     GL::bindTexture2D( _name );
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texParams.minFilter );
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texParams.magFilter );
@@ -1279,6 +1297,7 @@ void Texture2D::setAliasTexParameters()
     }
 
     _antialiasEnabled = false;
+    leaveDynamicAtlas();
 
     if (_name == 0)
     {
@@ -1496,6 +1515,21 @@ void Texture2D::removeSpriteFrameCapInset(SpriteFrame* spriteFrame)
     }
 }
 
+void Texture2D::leaveDynamicAtlas()
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the reload after a context loss restores the same content, the atlas reloads its pages with its own copy
+    if (VolatileTextureMgr::_isReloading)
+    {
+        return;
+    }
+#endif
+    if (_dynamicAtlas)
+    {
+        _dynamicAtlas->remove(this);
+    }
+}
+
 /// halx99 spec, ANDROID ETC1 ALPHA supports.
 void Texture2D::setAlphaTexture(Texture2D* alphaTexture)
 {
@@ -38,6 +38,7 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class DynamicAtlas;
 class Image;
 class NinePatchInfo;
 class SpriteFrame;
@@ -415,6 +416,15 @@ public:
     Texture2D* getAlphaTexture() const;
 
     GLuint getAlphaTextureName() const;
+
+    /** The page of the DynamicAtlas the texture is packed into, nullptr when it is not packed. */
+    Texture2D* getAtlasPage() const { return _atlasPage; }
+
+    /** Where the texture is in its atlas page, in pixels. */
+    const Rect& getAtlasRect() const { return _atlasRect; }
+
+    /** Changes whenever the texture is packed, moved or taken out of its atlas page, 0 if it never was. */
+    unsigned int getAtlasVersion() const { return _atlasVersion; }
 public:
     /** Get pixel info map, the key-value pairs is PixelFormat and PixelFormatInfo.*/
     static const PixelFormatInfoMap& getPixelFormatInfoMap();
@@ -463,6 +473,9 @@ private:
      */
     void addSpriteFrameCapInset(SpriteFrame* spritframe, const Rect& capInsets);
 
+    // the copy in the atlas page doesn't follow changes of the texture
+    void leaveDynamicAtlas();
+
     /**convert functions*/
 
     /**
@@ -549,11 +562,17 @@ protected:
     friend class SpriteFrameCache;
     friend class TextureCache;
     friend class ui::Scale9Sprite;
+    friend class DynamicAtlas;
 
     bool _valid;
     std::string _filePath;
 
     Texture2D* _alphaTexture;
+
+    DynamicAtlas* _dynamicAtlas;
+    Texture2D* _atlasPage;
+    Rect _atlasRect;
+    unsigned int _atlasVersion;
 };
 
 
@@ -41,6 +41,8 @@ THE SOFTWARE.
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
 #include "base/CCNinePatchImageParser.h"
+#include "renderer/CCDynamicAtlas.h"
+#include "base/CCTrace.h"
 
 
 
@@ -71,6 +73,7 @@ TextureCache::TextureCache()
 : _loadingThread(nullptr)
 , _needQuit(false)
 , _asyncRefCount(0)
+, _dynamicAtlas(nullptr)
 {
 }
 
@@ -78,6 +81,7 @@ TextureCache::~TextureCache()
 {
     CCLOGINFO("deallocing TextureCache: %p", this);
 
+    CC_SAFE_DELETE(_dynamicAtlas);
     for (auto& texture : _textures)
         texture.second->release();
 
@@ -268,6 +272,7 @@ void TextureCache::unbindAllImageAsync()
 
 void TextureCache::loadImage()
 {
+    CC_TRACE_THREAD_NAME("TextureCache");
     AsyncStruct *asyncStruct = nullptr;
     while (!_needQuit)
     {
@@ -292,6 +297,8 @@ void TextureCache::loadImage()
         }
         ul.unlock();
 
+        CC_TRACE_SCOPE("TextureCache::loadImage");
+
         // load image
         asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
 
@@ -311,6 +318,7 @@ void TextureCache::loadImage()
 
 void TextureCache::addImageAsyncCallBack(float /*dt*/)
 {
+    CC_TRACE_SCOPE("TextureCache::addImageAsyncCallBack");
     Texture2D *texture = nullptr;
     AsyncStruct *asyncStruct = nullptr;
     while (true)
@@ -371,6 +379,11 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
                     }
                     CC_SAFE_RELEASE(alphaTexture);
                 }
+
+                if (_dynamicAtlas)
+                {
+                    _dynamicAtlas->add(texture, image);
+                }
             }
             else {
                 texture = nullptr;
@@ -451,6 +464,11 @@ Texture2D * TextureCache::addImage(const std::string &path)
 
                 //parse 9-patch info
                 this->parseNinePatchImage(image, texture, path);
+
+                if (_dynamicAtlas)
+                {
+                    _dynamicAtlas->add(texture, image);
+                }
             }
             else
             {
@@ -499,6 +517,11 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
             if (texture->initWithImage(image))
             {
                 _textures.emplace(key, texture);
+
+                if (_dynamicAtlas)
+                {
+                    _dynamicAtlas->add(texture, image);
+                }
             }
             else
             {
@@ -552,6 +575,10 @@ bool TextureCache::reloadTexture(const std::string& fileName)
             CC_BREAK_IF(!bRet);
 
             ret = texture->initWithImage(image);
+            if (ret && _dynamicAtlas)
+            {
+                _dynamicAtlas->add(texture, image);
+            }
         } while (0);
     }
 
@@ -667,6 +694,18 @@ void TextureCache::waitForQuit()
     if (_loadingThread) _loadingThread->join();
 }
 
+void TextureCache::setDynamicAtlasEnabled(bool enabled, int maxTextureSize, int maxPages)
+{
+    if (_dynamicAtlas && (!enabled || _dynamicAtlas->getMaxTextureSize() != maxTextureSize || _dynamicAtlas->getMaxPages() != maxPages))
+    {
+        CC_SAFE_DELETE(_dynamicAtlas);
+    }
+    if (enabled && !_dynamicAtlas)
+    {
+        _dynamicAtlas = new (std::nothrow) DynamicAtlas(maxTextureSize, maxPages);
+    }
+}
+
 std::string TextureCache::getCachedTextureInfo() const
 {
     std::string buffer;
@@ -701,6 +740,13 @@ std::string TextureCache::getCachedTextureInfo() const
     snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
 
+    if (_dynamicAtlas)
+    {
+        snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache dynamic atlas: %ld textures in %ld pages\n",
+            (long)_dynamicAtlas->getTextureCount(), (long)_dynamicAtlas->getPageCount());
+        buffer += buftmp;
+    }
+
     return buffer;
 }
 
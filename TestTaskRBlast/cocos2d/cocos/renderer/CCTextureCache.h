@@ -47,6 +47,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class DynamicAtlas;
+
 /**
  * @addtogroup _2d
  * @{
@@ -219,6 +221,20 @@ public:
     */
     void renameTextureWithKey(const std::string& srcName, const std::string& dstName);
 
+    /** Packs the textures made from images from now on, up to maxTextureSize pixels wide and high,
+    * into the shared pages of a DynamicAtlas. Sprites drawing different small textures then batch into
+    * one draw call. Disabling it takes all textures out of the pages, it is off by default.
+    *
+    * @param enabled Whether to pack the textures.
+    * @param maxTextureSize The largest width and height of a texture to pack.
+    * @param maxPages The number of pages at most.
+    */
+    void setDynamicAtlasEnabled(bool enabled, int maxTextureSize = 256, int maxPages = 4);
+    bool isDynamicAtlasEnabled() const { return _dynamicAtlas != nullptr; }
+
+    /** The atlas the textures are packed into, nullptr when it is disabled. */
+    DynamicAtlas* getDynamicAtlas() const { return _dynamicAtlas; }
+
 
 private:
     void addImageAsyncCallBack(float dt);
@@ -245,6 +261,8 @@ protected:
 
     std::unordered_map<std::string, Texture2D*> _textures;
 
+    DynamicAtlas* _dynamicAtlas;
+
     static std::string s_etc1AlphaFileSuffix;
 };
 
@@ -23,7 +23,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 
+#include <typeinfo>
 #include "ui/UILayout.h"
+#include "ui/UIHBox.h"
+#include "ui/UIVBox.h"
+#include "ui/UIRelativeBox.h"
 #include "ui/UIHelper.h"
 #include "ui/UIScale9Sprite.h"
 #include "renderer/CCGLProgram.h"
@@ -108,6 +112,7 @@ void Layout::onEnter()
     }
     _doLayoutDirty = true;
     _clippingRectDirty = true;
+    setBoundsDirty();
 }
     
 void Layout::onExit()
@@ -246,6 +251,32 @@ void Layout::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t par
         Widget::visit(renderer, parentTransform, parentFlags);
     }
 }
+
+bool Layout::getDrawBounds(Rect& bounds) const
+{
+    // the background color fills the content size, the image is centered with the size set by onSizeChanged()
+    bounds = Rect::ZERO;
+    if (_colorType != BackGroundColorType::NONE)
+    {
+        bounds.setRect(0, 0, _contentSize.width, _contentSize.height);
+    }
+    if (_backGroundImage && _backGroundImage->isVisible())
+    {
+        Rect imageBounds = _backGroundImage->getBoundingBox();
+        if (bounds.size.width <= 0 || bounds.size.height <= 0)
+        {
+            bounds = imageBounds;
+        }
+        else
+        {
+            bounds.merge(imageBounds);
+        }
+    }
+    // the children move in the next doLayout(), a clipping visit draws the stencil or sets the scissor
+    return !_doLayoutDirty && !_clippingEnabled
+        && (typeid(*this) == typeid(Layout) || typeid(*this) == typeid(HBox)
+            || typeid(*this) == typeid(VBox) || typeid(*this) == typeid(RelativeBox));
+}
     
 void Layout::stencilClippingVisit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags)
 {
@@ -398,6 +429,7 @@ void Layout::setClippingEnabled(bool able)
         return;
     }
     _clippingEnabled = able;
+    setBoundsDirty();
     switch (_clippingType)
     {
         case ClippingType::STENCIL:
@@ -699,6 +731,7 @@ void Layout::removeBackGroundImage()
     }
     removeProtectedChild(_backGroundImage);
     _backGroundImage = nullptr;
+    setBoundsDirty();
     _backGroundImageFileName = "";
     _backGroundImageTextureSize = Size::ZERO;
 }
@@ -764,6 +797,7 @@ void Layout::setBackGroundColorType(BackGroundColorType type)
         default:
             break;
     }
+    setBoundsDirty();
 }
     
 Layout::BackGroundColorType Layout::getBackGroundColorType()const
@@ -911,6 +945,7 @@ void Layout::setLayoutType(Type type)
         }
     }
     _doLayoutDirty = true;
+    setBoundsDirty();
 }
     
 
@@ -929,6 +964,7 @@ void Layout::forceDoLayout()
 void Layout::requestDoLayout()
 {
     _doLayoutDirty = true;
+    setBoundsDirty();
 }
     
 Size Layout::getLayoutContentSize()const
@@ -980,6 +1016,7 @@ void Layout::doLayout()
     }
     
     _doLayoutDirty = false;
+    setBoundsDirty();
 }
 
 std::string Layout::getDescription() const
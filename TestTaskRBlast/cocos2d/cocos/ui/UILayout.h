@@ -377,6 +377,7 @@ public:
     virtual void addChild(Node* child, int localZOrder, const std::string &name) override;
     
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool getDrawBounds(Rect& bounds) const override;
 
     virtual void removeChild(Node* child, bool cleanup = true) override;
     
@@ -0,0 +1,167 @@
+/****************************************************************************
+Copyright (c) 2020 Anton Kulikov
+****************************************************************************/
+
+/**
+ * Headless render benchmark, needs no GPU and no display.
+ *
+ * Runs Director::mainLoop() on a GLViewNull, so the frames go through the whole engine down to
+ * the GL calls, which GLRecorder counts instead of drawing. Builds scenes of N rotating buttons
+ * with icons and renders each with and without Renderer batch reordering. Reports the time and the
+ * draw calls, state changes and uploaded bytes per frame, and writes every frame to a JSON file.
+ *
+ * Usage: HeadlessRenderBenchmark [-json prefix] [-frames count] [N ...]
+ * Every case is written to prefix-N-plain.json or prefix-N-reorder.json, prefix defaults to
+ * HeadlessRenderBenchmark. With CC_ENABLE_TRACING the measured frames are also written as a Chrome
+ * trace to prefix-N-plain.trace.json or prefix-N-reorder.trace.json.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "cocos2d.h"
+#include "platform/linux/CCGLRecorder-linux.h"
+#include "platform/linux/CCGLViewNull-linux.h"
+#include "MyButton.h"
+#include "MyButtonStyle.h"
+
+USING_NS_CC;
+
+static const float FRAME_WIDTH = 1024.0f;
+static const float FRAME_HEIGHT = 768.0f;
+static const int WARM_UP_FRAMES = 2;
+
+typedef std::chrono::steady_clock Clock;
+
+// generated textures, the benchmark does not depend on the resources folder
+static SpriteFrame* makeFrame(const std::string& key, unsigned char value)
+{
+	const int size = 64;
+	std::vector<unsigned char> pixels(size * size * 4, value);
+	auto image = new (std::nothrow) Image();
+	image->initWithRawData(pixels.data(), pixels.size(), size, size, 8);
+	auto texture = Director::getInstance()->getTextureCache()->addImage(image, key);
+	image->release();
+	return SpriteFrame::createWithTexture(texture, Rect(0, 0, size, size));
+}
+
+static Node* makeButtons(int count, MyButtonStyle* style, SpriteFrame* icon)
+{
+	std::mt19937 random(count);
+	std::uniform_real_distribution<float> scale(0.75f, 1.25f);
+
+	auto root = Node::create();
+	int columns = static_cast<int>(std::ceil(std::sqrt(count * FRAME_WIDTH / FRAME_HEIGHT)));
+	int rows = (count + columns - 1) / columns;
+	float cellWidth = FRAME_WIDTH / columns;
+	float cellHeight = FRAME_HEIGHT / rows;
+
+	for (int i = 0; i < count; ++i)
+	{
+		auto button = MyButton::create(style);
+		button->ignoreContentAdaptWithSize(false);
+		button->setContentSize(Size(cellWidth * 0.6f, cellHeight * 0.6f));
+		button->setPosition(Vec2((i % columns + 0.5f) * cellWidth, (i / columns + 0.5f) * cellHeight));
+		button->setScale(scale(random));
+		button->runAction(RepeatForever::create(RotateBy::create(1.0f, 90.0f)));
+		auto sprite = Sprite::createWithSpriteFrame(icon);
+		sprite->setScale(0.25f);
+		sprite->setPosition(Vec2(cellWidth * 0.3f, cellHeight * 0.3f));
+		button->addChild(sprite);
+		root->addChild(button);
+	}
+	return root;
+}
+
+static void runCase(Scene* scene, MyButtonStyle* style, SpriteFrame* icon, int count, bool reorder, int frames,
+					const std::string& prefix)
+{
+	auto director = Director::getInstance();
+	director->getRenderer()->setBatchReorderingEnabled(reorder);
+	auto root = makeButtons(count, style, icon);
+	scene->addChild(root);
+
+	// the first frames create the programs and fill the buffers
+	for (int frame = 0; frame < WARM_UP_FRAMES; ++frame)
+		director->mainLoop();
+	GLRecorder::clearFrames();
+
+	auto start = Clock::now();
+	for (int frame = 0; frame < frames; ++frame)
+		director->mainLoop();
+	double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+	GLRecorder::FrameStats total;
+	for (auto& frame : GLRecorder::getFrames())
+		total.add(frame);
+	double n = frames;
+	std::printf("%6d %-7s %10.1f %8.1f %10.1f %10.1f %10.1f %12.1f\n", count, reorder ? "yes" : "no",
+		ns / n / 1000.0, total.drawCalls / n, total.stateChanges / n, total.redundantStateChanges / n,
+		total.uniformUploads / n, total.bufferBytes / n);
+
+	std::string path = prefix + "-" + std::to_string(count) + (reorder ? "-reorder.json" : "-plain.json");
+	if (!GLRecorder::writeJson(path))
+		std::fprintf(stderr, "can't write %s\n", path.c_str());
+#if CC_ENABLE_TRACING
+	path = prefix + "-" + std::to_string(count) + (reorder ? "-reorder.trace.json" : "-plain.trace.json");
+	if (!Trace::writeJson(path, frames))
+		std::fprintf(stderr, "can't write %s\n", path.c_str());
+#endif
+
+	root->removeFromParent();
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<int> counts;
+	std::string prefix = "HeadlessRenderBenchmark";
+	int frames = 200;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!std::strcmp(argv[i], "-json") && i + 1 < argc)
+			prefix = argv[++i];
+		else if (!std::strcmp(argv[i], "-frames") && i + 1 < argc)
+			frames = std::max(std::atoi(argv[++i]), 1);
+		else
+			counts.push_back(std::atoi(argv[i]));
+	}
+	if (counts.empty())
+		counts = { 10, 100, 1000 };
+
+	auto glview = GLViewNull::create("HeadlessRenderBenchmark", Rect(0, 0, FRAME_WIDTH, FRAME_HEIGHT));
+	auto director = Director::getInstance();
+	director->setOpenGLView(glview);
+	glview->setDesignResolutionSize(FRAME_WIDTH, FRAME_HEIGHT, ResolutionPolicy::SHOW_ALL);
+
+	auto scene = Scene::create();
+	director->runWithScene(scene);
+	director->mainLoop();
+
+	auto frame = makeFrame("HeadlessRenderBenchmark", 0xff);
+	auto style = MyButtonStyle::createWithSpriteFrames(frame, frame, frame);
+	style->retain();
+	auto icon = makeFrame("HeadlessRenderBenchmarkIcon", 0x80);
+	icon->retain();
+
+	std::printf("%6s %-7s %10s %8s %10s %10s %10s %12s\n",
+		"N", "reorder", "us/frame", "draws", "states", "redundant", "uniforms", "bufferBytes");
+	for (auto count : counts)
+	{
+		if (count <= 0)
+			continue;
+		for (bool reorder : { false, true })
+			runCase(scene, style, icon, count, reorder, frames, prefix);
+	}
+
+	icon->release();
+	style->release();
+	director->end();
+	director->mainLoop();
+	return 0;
+}
@@ -0,0 +1,355 @@
+/****************************************************************************
+Copyright (c) 2020 Anton Kulikov
+****************************************************************************/
+
+/**
+ * Headless MyButton benchmark.
+ *
+ * Builds scenes of N rotated and scaled buttons in an invisible window and replays
+ * a touch stream through EventDispatcher::dispatchEvent. Reports the time and the heap
+ * allocations per touch event and the cost of one frame (scheduler update and scene render).
+ * Every button carries an icon with another texture, so the frame interleaves two materials;
+ * each scene is rendered with and without Renderer batch reordering and the draw calls
+ * per frame are reported for both.
+ *
+ * Usage: MyButtonBenchmark [-touches file] [N ...]
+ * The touch file has one event per line: `began|moved|ended|cancelled id x y`,
+ * screen coordinates in a 1024x768 frame. Without it a seeded synthetic stream is used.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "cocos2d.h"
+#include "MyButton.h"
+#include "MyButtonGroup.h"
+#include "MyButtonStyle.h"
+
+USING_NS_CC;
+
+static std::atomic<size_t> s_allocations(0);
+
+void* operator new(std::size_t size)
+{
+	++s_allocations;
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	++s_allocations;
+	return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	std::free(p);
+}
+
+static const float FRAME_WIDTH = 1024.0f;
+static const float FRAME_HEIGHT = 768.0f;
+static const int FRAMES = 200;
+
+struct TouchSample
+{
+	EventTouch::EventCode code;
+	int id;
+	float x;
+	float y;
+	Touch* touch;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedNs(Clock::time_point start)
+{
+	return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+static std::vector<TouchSample> makeTouchStream(int gestures)
+{
+	std::mt19937 random(17);
+	std::uniform_real_distribution<float> x(0.0f, FRAME_WIDTH);
+	std::uniform_real_distribution<float> y(0.0f, FRAME_HEIGHT);
+	std::uniform_real_distribution<float> step(-12.0f, 12.0f);
+
+	std::vector<TouchSample> stream;
+	for (int i = 0; i < gestures; ++i)
+	{
+		TouchSample sample;
+		sample.code = EventTouch::EventCode::BEGAN;
+		sample.id = i % EventTouch::MAX_TOUCHES;
+		sample.x = x(random);
+		sample.y = y(random);
+		sample.touch = nullptr;
+		stream.push_back(sample);
+
+		for (int move = 0; move < 8; ++move)
+		{
+			sample.code = EventTouch::EventCode::MOVED;
+			sample.x += step(random);
+			sample.y += step(random);
+			stream.push_back(sample);
+		}
+
+		// every eighth gesture is taken away by the system
+		sample.code = i % 8 == 7 ? EventTouch::EventCode::CANCELLED : EventTouch::EventCode::ENDED;
+		stream.push_back(sample);
+	}
+	return stream;
+}
+
+static bool loadTouchStream(const char* fileName, std::vector<TouchSample>& stream)
+{
+	FILE* file = std::fopen(fileName, "r");
+	if (!file)
+		return false;
+
+	char code[16];
+	TouchSample sample;
+	sample.touch = nullptr;
+	while (std::fscanf(file, "%15s %d %f %f", code, &sample.id, &sample.x, &sample.y) == 4)
+	{
+		if (!std::strcmp(code, "began"))
+			sample.code = EventTouch::EventCode::BEGAN;
+		else if (!std::strcmp(code, "moved"))
+			sample.code = EventTouch::EventCode::MOVED;
+		else if (!std::strcmp(code, "ended"))
+			sample.code = EventTouch::EventCode::ENDED;
+		else if (!std::strcmp(code, "cancelled"))
+			sample.code = EventTouch::EventCode::CANCELLED;
+		else
+			continue;
+		stream.push_back(sample);
+	}
+	std::fclose(file);
+	return !stream.empty();
+}
+
+// one Touch object per gesture, the replay itself creates nothing
+static void bindTouches(std::vector<TouchSample>& stream, Vector<Touch*>& touches)
+{
+	Touch* active[EventTouch::MAX_TOUCHES] = {};
+	for (auto& sample : stream)
+	{
+		int id = sample.id % EventTouch::MAX_TOUCHES;
+		if (sample.code == EventTouch::EventCode::BEGAN || !active[id])
+		{
+			active[id] = new (std::nothrow) Touch();
+			touches.pushBack(active[id]);
+			active[id]->release();
+		}
+		sample.touch = active[id];
+	}
+}
+
+// generated textures, the benchmark does not depend on the resources folder
+static SpriteFrame* makeFrame(const std::string& key, unsigned char value)
+{
+	const int size = 64;
+	std::vector<unsigned char> pixels(size * size * 4, value);
+	auto image = new (std::nothrow) Image();
+	image->initWithRawData(pixels.data(), pixels.size(), size, size, 8);
+	auto texture = Director::getInstance()->getTextureCache()->addImage(image, key);
+	image->release();
+	return SpriteFrame::createWithTexture(texture, Rect(0, 0, size, size));
+}
+
+static MyButtonStyle* makeStyle()
+{
+	auto frame = makeFrame("MyButtonBenchmark", 0xff);
+	return MyButtonStyle::createWithSpriteFrames(frame, frame, frame);
+}
+
+static Node* makeButtons(int count, MyButtonStyle* style, SpriteFrame* icon, bool grouped, int& released)
+{
+	std::mt19937 random(count);
+	std::uniform_real_distribution<float> angle(-45.0f, 45.0f);
+	std::uniform_real_distribution<float> scale(0.75f, 1.25f);
+
+	Node* root = grouped ? MyButtonGroup::create() : Node::create();
+	int columns = static_cast<int>(std::ceil(std::sqrt(count * FRAME_WIDTH / FRAME_HEIGHT)));
+	int rows = (count + columns - 1) / columns;
+	float cellWidth = FRAME_WIDTH / columns;
+	float cellHeight = FRAME_HEIGHT / rows;
+
+	for (int i = 0; i < count; ++i)
+	{
+		auto button = MyButton::create(style);
+		button->ignoreContentAdaptWithSize(false);
+		button->setContentSize(Size(cellWidth * 0.6f, cellHeight * 0.6f));
+		button->setExpandZone(Size(cellWidth * 0.7f, cellHeight * 0.7f));
+		button->setSafeZone(Size(cellWidth * 0.9f, cellHeight * 0.9f));
+		button->setPosition(Vec2((i % columns + 0.5f) * cellWidth, (i / columns + 0.5f) * cellHeight));
+		button->setRotation(angle(random));
+		button->setScale(scale(random));
+		button->setPushedTimeout(0.5f);
+		button->setTouchEndedCallback([&released](EventCustom*) { ++released; });
+		auto sprite = Sprite::createWithSpriteFrame(icon);
+		sprite->setScale(0.25f);
+		sprite->setPosition(Vec2(cellWidth * 0.3f, cellHeight * 0.3f));
+		button->addChild(sprite);
+		if (grouped)
+			static_cast<MyButtonGroup*>(root)->addButton(button);
+		else
+			root->addChild(button);
+	}
+	return root;
+}
+
+static void replay(EventDispatcher* dispatcher, const std::vector<TouchSample>& stream)
+{
+	EventTouch event;
+	std::vector<Touch*> touches(1);
+	for (auto& sample : stream)
+	{
+		sample.touch->setTouchInfo(sample.id, sample.x, sample.y);
+		touches[0] = sample.touch;
+		event.setEventCode(sample.code);
+		event.setTouches(touches);
+		dispatcher->dispatchEvent(&event);
+	}
+}
+
+static void runCase(Scene* scene, MyButtonStyle* style, SpriteFrame* icon, const std::vector<TouchSample>& stream,
+					int count, bool grouped, bool reorder)
+{
+	auto director = Director::getInstance();
+	auto renderer = director->getRenderer();
+	renderer->setBatchReorderingEnabled(reorder);
+	int released = 0;
+	auto root = makeButtons(count, style, icon, grouped, released);
+	scene->addChild(root);
+
+	// the first frame lays the buttons out and fills the hit test caches
+	scene->render(director->getRenderer(), Mat4::IDENTITY, nullptr);
+	PoolManager::getInstance()->getCurrentPool()->clear();
+	replay(director->getEventDispatcher(), stream);
+	released = 0;
+
+	size_t allocations = s_allocations;
+	auto start = Clock::now();
+	replay(director->getEventDispatcher(), stream);
+	double touchNs = elapsedNs(start);
+	size_t touchAllocations = s_allocations - allocations;
+
+	renderer->clearDrawStats();
+	allocations = s_allocations;
+	start = Clock::now();
+	for (int frame = 0; frame < FRAMES; ++frame)
+	{
+		director->getScheduler()->update(1.0f / 60.0f);
+		scene->render(director->getRenderer(), Mat4::IDENTITY, nullptr);
+		PoolManager::getInstance()->getCurrentPool()->clear();
+	}
+	double frameNs = elapsedNs(start);
+	size_t frameAllocations = s_allocations - allocations;
+	ssize_t batches = renderer->getDrawnBatches();
+	ssize_t unordered = batches + renderer->getBatchesSavedByReordering();
+
+	std::printf("%-6s %-7s %6d %12.1f %12.2f %12.1f %12.2f %9d %12.1f %12.1f\n",
+		grouped ? "group" : "plain", reorder ? "yes" : "no", count,
+		touchNs / stream.size(), static_cast<double>(touchAllocations) / stream.size(),
+		frameNs / FRAMES / 1000.0, static_cast<double>(frameAllocations) / FRAMES,
+		released, static_cast<double>(unordered) / FRAMES, static_cast<double>(batches) / FRAMES);
+
+	root->removeFromParent();
+	PoolManager::getInstance()->getCurrentPool()->clear();
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<int> counts;
+	std::vector<TouchSample> stream;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!std::strcmp(argv[i], "-touches") && i + 1 < argc)
+		{
+			if (!loadTouchStream(argv[++i], stream))
+			{
+				std::fprintf(stderr, "can't read touches from %s\n", argv[i]);
+				return 1;
+			}
+		}
+		else
+		{
+			counts.push_back(std::atoi(argv[i]));
+		}
+	}
+	if (counts.empty())
+		counts = { 10, 100, 1000, 10000 };
+	if (stream.empty())
+		stream = makeTouchStream(1000);
+
+	// an invisible window only provides the GL context
+	glfwInit();
+	glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+	auto glview = GLViewImpl::createWithRect("MyButtonBenchmark", Rect(0, 0, FRAME_WIDTH, FRAME_HEIGHT));
+	auto director = Director::getInstance();
+	director->setOpenGLView(glview);
+
+	auto scene = Scene::create();
+	director->runWithScene(scene);
+	director->drawScene();
+
+	auto style = makeStyle();
+	style->retain();
+	auto icon = makeFrame("MyButtonBenchmarkIcon", 0x80);
+	icon->retain();
+	Vector<Touch*> touches;
+	bindTouches(stream, touches);
+
+	std::printf("%-6s %-7s %6s %12s %12s %12s %12s %9s %12s %12s\n",
+		"mode", "reorder", "N", "ns/event", "allocs/event", "us/frame", "allocs/frame", "released",
+		"draws/before", "draws/after");
+	for (auto count : counts)
+	{
+		if (count <= 0)
+			continue;
+		for (bool reorder : { false, true })
+		{
+			runCase(scene, style, icon, stream, count, false, reorder);
+			runCase(scene, style, icon, stream, count, true, reorder);
+		}
+	}
+
+	icon->release();
+	style->release();
+	director->end();
+	director->mainLoop();
+	return 0;
+}
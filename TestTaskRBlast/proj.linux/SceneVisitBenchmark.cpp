@@ -0,0 +1,174 @@
+/****************************************************************************
+Copyright (c) 2020 Anton Kulikov
+****************************************************************************/
+
+/**
+ * Headless benchmark of the parallel scene graph visit.
+ *
+ * Builds a scene of N sprites in groups of 64 under one layer, every group rotating each frame
+ * so all transforms are dirty, and visits it on 1, 2, 4 and 8 threads (Director::setParallelVisitThreads).
+ * Reports the visit time per frame and checks that the render queue holds the same commands,
+ * with the same transforms, in the same order as after the serial visit.
+ *
+ * Usage: SceneVisitBenchmark [N ...]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+static const float FRAME_WIDTH = 1024.0f;
+static const float FRAME_HEIGHT = 768.0f;
+static const int FRAMES = 100;
+static const int GROUP_SIZE = 64;
+
+typedef std::chrono::steady_clock Clock;
+
+struct RecordedCommand
+{
+	RenderCommand* command;
+	Mat4 modelView;
+};
+
+static Node* makeScene(int count, Texture2D* texture)
+{
+	std::mt19937 random(count);
+	std::uniform_real_distribution<float> x(0.0f, FRAME_WIDTH);
+	std::uniform_real_distribution<float> y(0.0f, FRAME_HEIGHT);
+
+	auto root = Node::create();
+	Node* group = nullptr;
+	for (int i = 0; i < count; ++i)
+	{
+		if (i % GROUP_SIZE == 0)
+		{
+			group = Node::create();
+			group->setPosition(Vec2(x(random), y(random)));
+			root->addChild(group, i / GROUP_SIZE % 3 - 1);
+		}
+		auto sprite = Sprite::createWithTexture(texture);
+		sprite->setPosition(Vec2(x(random) - FRAME_WIDTH / 2, y(random) - FRAME_HEIGHT / 2));
+		sprite->setScale(0.25f);
+		group->addChild(sprite);
+	}
+	return root;
+}
+
+static void animate(Node* root, int frame)
+{
+	for (auto group : root->getChildren())
+		group->setRotation(static_cast<float>(frame));
+}
+
+static void record(Renderer* renderer, std::vector<RecordedCommand>& commands)
+{
+	commands.clear();
+	auto& queue = renderer->getRenderQueue(0);
+	for (ssize_t i = 0, size = queue.size(); i < size; ++i)
+	{
+		RecordedCommand recorded = { queue[i], Mat4::IDENTITY };
+		if (queue[i]->getType() == RenderCommand::Type::TRIANGLES_COMMAND)
+			recorded.modelView = static_cast<TrianglesCommand*>(queue[i])->getModelView();
+		commands.push_back(recorded);
+	}
+}
+
+static bool same(const std::vector<RecordedCommand>& a, const std::vector<RecordedCommand>& b)
+{
+	if (a.size() != b.size())
+		return false;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		if (a[i].command != b[i].command || std::memcmp(a[i].modelView.m, b[i].modelView.m, sizeof(a[i].modelView.m)))
+			return false;
+	}
+	return true;
+}
+
+static void runCase(Scene* scene, Texture2D* texture, int count)
+{
+	auto director = Director::getInstance();
+	auto renderer = director->getRenderer();
+	auto root = makeScene(count, texture);
+	scene->addChild(root);
+
+	std::vector<RecordedCommand> serial;
+	std::vector<RecordedCommand> commands;
+	double serialNs = 0;
+	for (unsigned threads : { 1u, 2u, 4u, 8u })
+	{
+		director->setParallelVisitThreads(threads);
+
+		double ns = 0;
+		bool identical = true;
+		for (int frame = 0; frame < FRAMES; ++frame)
+		{
+			animate(root, frame);
+			auto start = Clock::now();
+			scene->visit(renderer, Mat4::IDENTITY, 0);
+			ns += static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+			// the last frame of every run is compared, the transforms are the same there
+			if (frame == FRAMES - 1)
+			{
+				record(renderer, threads == 1 ? serial : commands);
+				identical = threads == 1 || same(serial, commands);
+			}
+			renderer->clean();
+		}
+		if (threads == 1)
+			serialNs = ns;
+
+		std::printf("%8d %8u %12.1f %8.2fx %s\n", count, threads, ns / FRAMES / 1000.0, serialNs / ns,
+			identical ? "same" : "DIFFERENT");
+	}
+
+	director->setParallelVisitThreads(1);
+	root->removeFromParent();
+	PoolManager::getInstance()->getCurrentPool()->clear();
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<int> counts;
+	for (int i = 1; i < argc; ++i)
+		counts.push_back(std::atoi(argv[i]));
+	if (counts.empty())
+		counts = { 1000, 10000, 50000 };
+
+	// an invisible window only provides the GL context
+	glfwInit();
+	glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+	auto glview = GLViewImpl::createWithRect("SceneVisitBenchmark", Rect(0, 0, FRAME_WIDTH, FRAME_HEIGHT));
+	auto director = Director::getInstance();
+	director->setOpenGLView(glview);
+
+	auto scene = Scene::create();
+	director->runWithScene(scene);
+	director->drawScene();
+
+	// a generated texture, the benchmark does not depend on the resources folder
+	const int size = 64;
+	std::vector<unsigned char> pixels(size * size * 4, 0xff);
+	auto image = new (std::nothrow) Image();
+	image->initWithRawData(pixels.data(), pixels.size(), size, size, 8);
+	auto texture = director->getTextureCache()->addImage(image, "SceneVisitBenchmark");
+	image->release();
+
+	std::printf("%8s %8s %12s %9s %s\n", "N", "threads", "us/visit", "speedup", "queue");
+	for (auto count : counts)
+	{
+		if (count > 0)
+			runCase(scene, texture, count);
+	}
+
+	director->end();
+	director->mainLoop();
+	return 0;
+}
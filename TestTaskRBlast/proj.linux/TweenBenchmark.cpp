@@ -0,0 +1,149 @@
+/****************************************************************************
+Copyright (c) 2020 Anton Kulikov
+****************************************************************************/
+
+/**
+ * Headless benchmark of the TweenManager against the ActionManager.
+ *
+ * Runs a move with a sine easing, a scale, a rotation and a fade on each of N nodes, once as
+ * actions (EaseSineOut of MoveTo, ScaleTo, RotateBy, FadeTo) and once as tweens, and updates the
+ * manager alone for a number of 60 Hz frames. Both managers set the same values, the states of the
+ * nodes are hashed after every frame and must match.
+ *
+ * Usage: TweenBenchmark [-frames count] [N ...]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "cocos2d.h"
+#include "platform/linux/CCGLViewNull-linux.h"
+
+USING_NS_CC;
+
+static const float FRAME_TIME = 1.0f / 60;
+
+typedef std::chrono::steady_clock Clock;
+
+struct Result
+{
+	double nsPerFrame;
+	std::uint64_t checksum;
+};
+
+// FNV-1a of the node states
+static void mix(std::uint64_t& checksum, float value)
+{
+	std::uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	checksum = (checksum ^ bits) * 1099511628211ull;
+}
+
+static Result run(Scene* scene, int count, int frames, bool tweens)
+{
+	auto director = Director::getInstance();
+	std::mt19937 random(count);
+	std::uniform_real_distribution<float> duration(1.0f, 3.0f);
+	std::uniform_real_distribution<float> coordinate(0.0f, 1000.0f);
+
+	auto root = Node::create();
+	scene->addChild(root);
+	std::vector<Node*> nodes;
+	for (int i = 0; i < count; ++i)
+	{
+		auto node = Node::create();
+		node->setPosition(coordinate(random), coordinate(random));
+		root->addChild(node);
+		nodes.push_back(node);
+
+		Vec2 position(coordinate(random), coordinate(random));
+		float moveTime = duration(random);
+		float scaleTime = duration(random);
+		float rotateTime = duration(random);
+		float fadeTime = duration(random);
+		if (tweens)
+		{
+			node->runTween(Tween::moveTo(moveTime, position).setEasing(tweenfunc::Sine_EaseOut));
+			node->runTween(Tween::scaleTo(scaleTime, 2.0f));
+			node->runTween(Tween::rotateBy(rotateTime, 270.0f));
+			node->runTween(Tween::fadeTo(fadeTime, 64));
+		}
+		else
+		{
+			node->runAction(EaseSineOut::create(MoveTo::create(moveTime, position)));
+			node->runAction(ScaleTo::create(scaleTime, 2.0f));
+			node->runAction(RotateBy::create(rotateTime, 270.0f));
+			node->runAction(FadeTo::create(fadeTime, 64));
+		}
+	}
+
+	Result result = { 0.0, 14695981039346656037ull };
+	double ns = 0;
+	for (int frame = 0; frame < frames; ++frame)
+	{
+		auto start = Clock::now();
+		if (tweens)
+			director->getTweenManager()->update(FRAME_TIME);
+		else
+			director->getActionManager()->update(FRAME_TIME);
+		ns += static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+		for (auto node : nodes)
+		{
+			mix(result.checksum, node->getPositionX());
+			mix(result.checksum, node->getPositionY());
+			mix(result.checksum, node->getScaleX());
+			mix(result.checksum, node->getRotation());
+			mix(result.checksum, node->getOpacity());
+		}
+	}
+	result.nsPerFrame = ns / frames;
+
+	root->removeFromParent();
+	PoolManager::getInstance()->getCurrentPool()->clear();
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<int> counts;
+	int frames = 120;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!std::strcmp(argv[i], "-frames") && i + 1 < argc)
+			frames = std::max(std::atoi(argv[++i]), 1);
+		else
+			counts.push_back(std::atoi(argv[i]));
+	}
+	if (counts.empty())
+		counts = { 1000, 10000, 50000 };
+
+	auto glview = GLViewNull::create("TweenBenchmark", Rect(0, 0, 1024, 768));
+	auto director = Director::getInstance();
+	director->setOpenGLView(glview);
+
+	auto scene = Scene::create();
+	director->runWithScene(scene);
+	director->mainLoop();
+
+	std::printf("%8s %-8s %12s %8s\n", "N", "manager", "us/frame", "speedup");
+	for (auto count : counts)
+	{
+		if (count <= 0)
+			continue;
+		auto actions = run(scene, count, frames, false);
+		auto tweens = run(scene, count, frames, true);
+		std::printf("%8d %-8s %12.1f %8s\n", count, "actions", actions.nsPerFrame / 1000.0, "1.00x");
+		std::printf("%8d %-8s %12.1f %7.2fx%s\n", count, "tweens", tweens.nsPerFrame / 1000.0,
+			actions.nsPerFrame / tweens.nsPerFrame, actions.checksum == tweens.checksum ? "" : "  MISMATCH");
+	}
+
+	director->end();
+	director->mainLoop();
+	return 0;
+}
@@ -0,0 +1,161 @@
+/****************************************************************************
+Copyright (c) 2020 Anton Kulikov
+****************************************************************************/
+
+/**
+ * Microbenchmark of the batch vertex transform of Renderer::fillVerticesAndIndices.
+ *
+ * Fills a vertex and an index buffer from runs of sprite quads and larger meshes the way
+ * the renderer batches TrianglesCommands, with the former per vertex loop and with
+ * MathUtil::transformVertices / offsetIndices at every supported instruction set.
+ *
+ * Usage: VertexTransformBenchmark [quads]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+typedef std::chrono::steady_clock Clock;
+
+struct Command
+{
+	std::vector<V3F_C4B_T2F> vertices;
+	std::vector<unsigned short> indices;
+	Mat4 modelView;
+};
+
+static std::vector<Command> makeCommands(int count, int quadsPerCommand)
+{
+	std::mt19937 random(11);
+	std::uniform_real_distribution<float> value(-500.0f, 500.0f);
+
+	std::vector<Command> commands(count);
+	for (auto& command : commands)
+	{
+		Mat4::createRotationZ(value(random) * 0.01f, &command.modelView);
+		command.modelView.m[12] = value(random);
+		command.modelView.m[13] = value(random);
+		command.modelView.scale(1.5f);
+		for (int quad = 0; quad < quadsPerCommand; ++quad)
+		{
+			unsigned short base = static_cast<unsigned short>(command.vertices.size());
+			for (int corner = 0; corner < 4; ++corner)
+			{
+				V3F_C4B_T2F vertex;
+				vertex.vertices.set(value(random), value(random), 0.0f);
+				vertex.colors = Color4B::WHITE;
+				vertex.texCoords = Tex2F(corner & 1, corner >> 1);
+				command.vertices.push_back(vertex);
+			}
+			const unsigned short quadIndices[] = { 0, 1, 2, 3, 2, 1 };
+			for (auto index : quadIndices)
+				command.indices.push_back(base + index);
+		}
+	}
+	return commands;
+}
+
+// Renderer::fillVerticesAndIndices before the batch functions
+static void fillLegacy(const std::vector<Command>& commands, V3F_C4B_T2F* verts, unsigned short* indices)
+{
+	int filledVertex = 0;
+	int filledIndex = 0;
+	for (auto& command : commands)
+	{
+		memcpy(&verts[filledVertex], command.vertices.data(), sizeof(V3F_C4B_T2F) * command.vertices.size());
+		for (size_t i = 0; i < command.vertices.size(); ++i)
+			command.modelView.transformPoint(&(verts[i + filledVertex].vertices));
+		for (size_t i = 0; i < command.indices.size(); ++i)
+			indices[filledIndex + i] = filledVertex + command.indices[i];
+		filledVertex += static_cast<int>(command.vertices.size());
+		filledIndex += static_cast<int>(command.indices.size());
+	}
+}
+
+static void fillBatch(const std::vector<Command>& commands, V3F_C4B_T2F* verts, unsigned short* indices)
+{
+	int filledVertex = 0;
+	int filledIndex = 0;
+	for (auto& command : commands)
+	{
+		MathUtil::transformVertices(command.modelView.m, command.vertices.data(), &verts[filledVertex],
+									command.vertices.size(), sizeof(V3F_C4B_T2F));
+		MathUtil::offsetIndices(command.indices.data(), &indices[filledIndex],
+								command.indices.size(), static_cast<unsigned short>(filledVertex));
+		filledVertex += static_cast<int>(command.vertices.size());
+		filledIndex += static_cast<int>(command.indices.size());
+	}
+}
+
+template <typename Fill>
+static double measure(Fill fill, const std::vector<Command>& commands, size_t vertexCount,
+					  std::vector<V3F_C4B_T2F>& verts, std::vector<unsigned short>& indices)
+{
+	// best of several runs, the buffers stay warm like the renderer's
+	double best = 0;
+	for (int run = 0; run < 20; ++run)
+	{
+		auto start = Clock::now();
+		fill(commands, verts.data(), indices.data());
+		double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+		if (run == 0 || ns < best)
+			best = ns;
+	}
+	return best / vertexCount;
+}
+
+static void runCase(int quads, int quadsPerCommand)
+{
+	auto commands = makeCommands(quads / quadsPerCommand, quadsPerCommand);
+	size_t vertexCount = 0;
+	size_t indexCount = 0;
+	for (auto& command : commands)
+	{
+		vertexCount += command.vertices.size();
+		indexCount += command.indices.size();
+	}
+	std::vector<V3F_C4B_T2F> verts(vertexCount);
+	std::vector<unsigned short> indices(indexCount);
+	std::vector<V3F_C4B_T2F> expectedVerts(vertexCount);
+	std::vector<unsigned short> expectedIndices(indexCount);
+	fillLegacy(commands, expectedVerts.data(), expectedIndices.data());
+
+	double legacy = measure(fillLegacy, commands, vertexCount, verts, indices);
+	std::printf("%8d %8d %-8s %10.2f %8s\n", quads, quadsPerCommand, "legacy", legacy, "1.00x");
+
+	const char* names[] = { "none", "sse2", "avx2" };
+	auto supported = MathUtil::getSIMDLevel();
+	for (int level = 0; level <= static_cast<int>(supported); ++level)
+	{
+		MathUtil::setSIMDLevel(static_cast<MathUtil::SIMDLevel>(level));
+		double batch = measure(fillBatch, commands, vertexCount, verts, indices);
+		bool same = !memcmp(verts.data(), expectedVerts.data(), sizeof(V3F_C4B_T2F) * vertexCount) &&
+			indices == expectedIndices;
+		std::printf("%8d %8d %-8s %10.2f %7.2fx%s\n", quads, quadsPerCommand, names[level],
+			batch, legacy / batch, same ? "" : "  MISMATCH");
+	}
+	MathUtil::setSIMDLevel(supported);
+}
+
+int main(int argc, char** argv)
+{
+	// the renderer buffers hold up to 65536 vertices
+	int quads = argc > 1 ? std::atoi(argv[1]) : 16384;
+	if (quads <= 0 || quads > 16384)
+		quads = 16384;
+
+	std::printf("%8s %8s %-8s %10s %8s\n", "quads", "per cmd", "path", "ns/vertex", "speedup");
+	for (int quadsPerCommand : { 1, 16, 256 })
+	{
+		if (quads >= quadsPerCommand)
+			runCase(quads - quads % quadsPerCommand, quadsPerCommand);
+	}
+	return 0;
+}